@@ -31,7 +31,13 @@
 #define _IMAGEDATA_H_
 
 #include "lvgl.h"
+#include "LCD_3IN49.h"
 
 extern const lv_img_dsc_t pic;
 
+// Boot splash: the logo prerendered onto SPLASH_BG as panel-ready pixels,
+// so LCD_3IN49_Splash sends it straight from flash
+#define SPLASH_BG WHITE
+extern const LCD_3IN49_IMAGE splash_img;
+
 #endif 
@@ -32,6 +32,19 @@
 #ifndef _LCD_TEST_H_
 #define _LCD_TEST_H_
 
+// With LVGL_ON_CORE1 the display, touch and LVGL are brought up and run on
+// core1, and every lv_* call stays there; core0 keeps USB, HID and the IMU.
+// The cores talk through hid_cmd.h and ui_bridge.h.
+#ifndef LVGL_ON_CORE1
+#define LVGL_ON_CORE1 0
+#endif
+#ifndef STDIO_UART
+#define STDIO_UART 0
+#endif
+#ifndef FRAME_PROF_OVERLAY
+#define FRAME_PROF_OVERLAY 0
+#endif
+
 int LCD_3IN49_LVGL_Init(void);
 void LCD_3IN49_LVGL_Task(void);
 
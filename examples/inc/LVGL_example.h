@@ -39,14 +39,13 @@
 #include "PCF85063A.h"
 #include "qspi_pio.h"
 #include "lvgl.h"
-
-#define DISP_HOR_RES 172
-#define DISP_VER_RES 640
+#include "disp_drv.h"
 
 #define INPUTDEV_TS  1
 
 void LVGL_Init(void);
 void Widgets_Init(void);
+void LVGL_UI_Poll(void);
 
 
 #endif
@@ -0,0 +1,60 @@
+#ifndef DISP_DRV_H
+#define DISP_DRV_H
+
+#include "LCD_3IN49.h"
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// LVGL display driver for the LCD_3IN49 panel. Dirty areas are rounded to
+// the controller's pixel pairs and sent through the chained-DMA flush from
+// two partial draw buffers; with TE running, frames are paced to the panel
+// scan by LVGL_Frame_Pacer. Each stage is recorded by frame_prof.
+
+// Flush accounting for the partial-refresh path. A frame is one LVGL
+// refresh cycle, i.e. every flush up to and including the last area.
+typedef struct {
+  uint32_t flushes;          // areas sent to the panel
+  uint32_t frames;
+  uint64_t bytes;            // pixel bytes sent since the last reset
+  uint32_t frame_bytes;      // pixel bytes of the last frame
+  uint32_t frame_bytes_max;
+  uint32_t frame_us;         // first flush start -> last flush DMA done
+  uint32_t frame_us_max;
+  uint32_t scrolls_hw;       // scroll steps shifted by the panel
+  uint32_t scrolls_redrawn;  // steps on the scroll object that were redrawn
+} lvgl_flush_stats_t;
+
+// Allocates the draw buffers and registers the display at the panel's
+// current orientation; LCD_3IN49_Init() and lv_init() first
+lv_disp_t *disp_drv_init(void);
+
+void LVGL_Get_Flush_Stats(lvgl_flush_stats_t *stats);
+void LVGL_Reset_Flush_Stats(void);
+void LVGL_Frame_Pacer(void);
+
+// Hardware scroll for one object, e.g. a list: while it scrolls vertically
+// the panel shifts its rows (LCD_3IN49_SetScrollArea) and only the exposed
+// rows are redrawn. The object must span the screen width in portrait and
+// stay put, with its top and height even. Any step the panel can't take,
+// say with something drawn over the object, is redrawn as usual. Returns
+// false if the object doesn't qualify; NULL detaches.
+bool LVGL_HW_Scroll_Attach(lv_obj_t *obj);
+
+// Flash image composed over LVGL, like a hardware plane: a placeholder
+// object sized to the image, and whenever LVGL flushes an area touching it
+// the image is streamed to the panel after that area (LCD_3IN49_Image_Async)
+// instead of being rendered. It sits on top of anything LVGL draws there,
+// and is only sent while wholly visible at an even position. Up to four;
+// NULL if none is free or the image size is odd.
+lv_obj_t *LVGL_Image_Overlay_Create(lv_obj_t *parent,
+                                    const LCD_3IN49_IMAGE *img);
+
+// Frame profiler (frame_prof.h): a live per-frame summary on screen, and
+// the record ring as Chrome trace JSON on stdout. LVGL core only; the
+// FRAME_PROF_OVERLAY build option and the UART console's "overlay" and
+// "dump" commands call them.
+void LVGL_Profiler_Overlay(bool on);
+void LVGL_Profiler_Dump(void);
+
+#endif
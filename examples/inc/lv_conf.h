@@ -46,7 +46,7 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 0
+#define LV_MEM_CUSTOM 1
 #if LV_MEM_CUSTOM == 0
 /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
 #  define LV_MEM_SIZE (32U * 1024U)          /*[bytes]*/
@@ -60,10 +60,11 @@
 #endif
 
 #else       /*LV_MEM_CUSTOM*/
-#  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
-#  define LV_MEM_CUSTOM_ALLOC   malloc
-#  define LV_MEM_CUSTOM_FREE    free
-#  define LV_MEM_CUSTOM_REALLOC realloc
+/*SRAM sub-pool for small blocks, PSRAM for the rest (lv_mem_rp.h)*/
+#  define LV_MEM_CUSTOM_INCLUDE "lv_mem_rp.h"   /*Header for the dynamic memory function*/
+#  define LV_MEM_CUSTOM_ALLOC   lv_mem_rp_alloc
+#  define LV_MEM_CUSTOM_FREE    lv_mem_rp_free
+#  define LV_MEM_CUSTOM_REALLOC lv_mem_rp_realloc
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -85,10 +86,10 @@
 
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
-#define LV_TICK_CUSTOM 0
+#define LV_TICK_CUSTOM 1
 #if LV_TICK_CUSTOM
-#define LV_TICK_CUSTOM_INCLUDE "Arduino.h"         /*Header for the system time function*/
-#define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())    /*Expression evaluating to current system time in ms*/
+#define LV_TICK_CUSTOM_INCLUDE "pico/time.h"       /*Header for the system time function*/
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR ((uint32_t)(time_us_64() / 1000))    /*Expression evaluating to current system time in ms*/
 #endif   /*LV_TICK_CUSTOM*/
 
 /*Default Dot Per Inch. Used to initialize default sizes such as widgets sized, style paddings.
@@ -0,0 +1,42 @@
+#ifndef LV_MEM_RP_H
+#define LV_MEM_RP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// LVGL's heap (LV_MEM_CUSTOM_ALLOC and friends in lv_conf.h). Requests up
+// to LV_MEM_RP_SMALL go to a private SRAM sub-pool first: widgets, styles,
+// label text and the draw scratch buffers, all touched every frame. The
+// rest, and anything the sub-pool can't fit, comes from rp_mem as BULK,
+// i.e. PSRAM, so the number of widgets is no longer capped by a fixed
+// 32 KB pool. A block keeps its pool across realloc unless it has to move.
+//
+// LVGL only calls these from the core that runs it, so there is no lock.
+
+#ifndef LV_MEM_RP_POOL_SIZE
+#define LV_MEM_RP_POOL_SIZE (32U * 1024U)
+#endif
+#define LV_MEM_RP_SMALL 2048
+
+typedef struct {
+  size_t pool_size;
+  size_t pool_used;     // in sub-pool blocks, TLSF rounding included
+  size_t pool_peak;
+  size_t pool_max_free; // largest free block
+  uint8_t pool_frag_pct; // free space not in the largest block
+  uint32_t allocs;
+  uint32_t frees;
+  uint32_t spills;      // small requests the sub-pool couldn't fit
+  uint32_t bulk;        // larger requests, straight to rp_mem
+  uint32_t bulk_live;   // rp_mem blocks not yet freed
+  uint32_t bulk_peak;
+  uint32_t failed;
+} lv_mem_rp_stats_t;
+
+void *lv_mem_rp_alloc(size_t size);
+void lv_mem_rp_free(void *ptr);
+void *lv_mem_rp_realloc(void *ptr, size_t size);
+
+void lv_mem_rp_get_stats(lv_mem_rp_stats_t *stats);
+
+#endif
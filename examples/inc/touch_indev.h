@@ -0,0 +1,36 @@
+#ifndef TOUCH_INDEV_H
+#define TOUCH_INDEV_H
+
+#include "lvgl.h"
+#include "touch_filter.h"
+#include <stdint.h>
+
+// LVGL pointer device fed from TOUCH_RING. Every report reaches LVGL in
+// order (the read callback asks to be called again while samples are
+// pending), press/hold/release follows Finger_Num, and the time from the
+// controller interrupt to LVGL consuming the sample is tracked. Pressed
+// samples pass through touch_filter (1-euro with 2 ms prediction by
+// default) before LVGL sees them.
+
+// Release if the controller stops reporting without sending a lift report
+#define TOUCH_INDEV_RELEASE_TIMEOUT_US 60000
+
+typedef struct {
+  uint32_t samples;        // samples handed to LVGL
+  uint32_t presses;        // released -> pressed transitions
+  uint32_t timeouts;       // releases synthesised by the timeout
+  uint32_t lost;           // samples overwritten before LVGL read them
+  uint32_t latency_us;     // last contact -> LVGL latency
+  uint32_t latency_max_us;
+  uint32_t latency_avg_us; // running average over the last ~16 samples
+} touch_indev_stats_t;
+
+lv_indev_t *touch_indev_init(void);
+// Restarts LVGL's read timer, stopped while the screen is untouched, once
+// a report is waiting; call it on the LVGL core before lv_task_handler()
+void touch_indev_poll(void);
+void touch_indev_get_stats(touch_indev_stats_t *stats);
+void touch_indev_reset_stats(void);
+void touch_indev_set_filter(const touch_filter_config_t *cfg);
+
+#endif
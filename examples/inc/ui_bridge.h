@@ -0,0 +1,31 @@
+#ifndef UI_BRIDGE_H
+#define UI_BRIDGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Events from the USB/HID side to the UI. ui_bridge_task() runs next to
+// tud_task() and posts state changes, USB and battery; the LVGL core drains them with
+// ui_bridge_poll() and is the only one to touch widgets. The reverse
+// direction is hid_cmd.h.
+
+typedef enum {
+  UI_EVENT_USB_STATE = 0, // value = ui_usb_state_t
+  UI_EVENT_BATTERY,       // value = charge in percent
+} ui_event_type_t;
+
+typedef enum {
+  UI_USB_DETACHED = 0,
+  UI_USB_MOUNTED,
+  UI_USB_SUSPENDED,
+} ui_usb_state_t;
+
+typedef struct {
+  uint8_t type;
+  uint8_t value;
+} ui_event_t;
+
+void ui_bridge_task(void);
+bool ui_bridge_poll(ui_event_t *ev);
+
+#endif
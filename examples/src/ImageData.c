@@ -11,6 +11,7 @@
 #else
     #include "lvgl/lvgl.h"
 #endif
+#include "LCD_3IN49.h"
 
 
 #ifndef LV_ATTRIBUTE_MEM_ALIGN
@@ -256,3 +257,403 @@ const lv_img_dsc_t pic = {
   .data_size = 9116 * LV_IMG_PX_SIZE_ALPHA_BYTE,
   .data = waveshare_map,
 };
+
+/*Boot splash, generated by tools/splash/mksplash.py: LCD_3IN49_IMAGE_RLE, 12412 bytes
+  for 9288 pixels, on SPLASH_BG*/
+static const uint32_t splash_data[3103] = {
+  0x8000025a, 0xffffffff, 0x0000000e, 0xdfefffff, 0xdfd7dfdf, 0xdfdfdfd7, 0xdfdfdfdf, 0xdfd7dfdf,
+  0xdfd7dfd7, 0xdfd7dfd7, 0xdfdfdfdf, 0xdfd7dfd7, 0xdfdfdfdf, 0xdfd7dfd7, 0xffe7ffdf, 0xffefffef,
+  0xffffffef, 0x8000000b, 0xffffffff, 0x00000009, 0xffefffef, 0xffffffff, 0xffffffff, 0xffefffef,
+  0xffefffe7, 0xffffffff, 0xffffffff, 0xffefffff, 0xffefffef, 0x80000006, 0xffffffff, 0x0000000b,
+  0xffefffff, 0xffefffef, 0xffefffef, 0xffffffef, 0xffefffff, 0xffefffef, 0xffefffff, 0xffefffef,
+  0xffffffef, 0xffffffff, 0xffffffef, 0x80000008, 0xffffffff, 0x00000003, 0xffefffff, 0xffefffef,
+  0xffffffef, 0x80000018, 0xffffffff, 0x00000003, 0x955cffd7, 0x5534f333, 0x352c352c, 0x80000003,
+  0x35343534, 0x00000009, 0x352c352c, 0x35343534, 0x35345534, 0x15341534, 0x552c352c, 0x96447634,
+  0x1b865965, 0xffdf3faf, 0xffefffef, 0x80000009, 0xffffffff, 0x0000000b, 0x9985ffe7, 0xdea6f764,
+  0xffffbfdf, 0xffffffff, 0x324c5ec7, 0x3a96d13b, 0xffffffff, 0xffffffff, 0x9caeffef, 0x59759654,
+  0xffef5aa6, 0x80000004, 0xffffffff, 0x0000000d, 0x3fbfbfd7, 0x7fb77fb7, 0x5fb75fb7, 0x7fb77fb7,
+  0x5fbf7fb7, 0x5fbf3fbf, 0x3eb75fbf, 0x5fb79fbf, 0x7fb77fb7, 0x5fb77fb7, 0x7fb77fb7, 0x5ec75fb7,
+  0xffffffef, 0x80000007, 0xffffffff, 0x00000003, 0x3775ffdf, 0xd754964c, 0xbfd7d664, 0x80000009,
+  0xffffffff, 0x00000001, 0xffffffef, 0x8000000e, 0xffffffff, 0x00000010, 0x7544ffc7, 0xf50bb413,
+  0xf50bf50b, 0xf50bf50b, 0xf60bf60b, 0xf50bf50b, 0xf60bf60b, 0xd60bd60b, 0xf60bd60b, 0xf613d513,
+  0xf503f60b, 0xf50bf503, 0x9313d413, 0x5444b323, 0x9fcffa85, 0xffffffef, 0x80000007, 0xffffffff,
+  0x0000000c, 0xffefffff, 0x7223feae, 0x5223531b, 0xffef367d, 0xffefffff, 0x922b3faf, 0xfa7d711b,
+  0xffffffe7, 0xffefffff, 0x9985ffef, 0x731b3213, 0xffe7324c, 0x80000003, 0xffffffff, 0x0000000e,
+  0xffefffff, 0x30233b96, 0xb22b922b, 0xb32bb32b, 0xd32bb32b, 0x922bb22b, 0x922bb32b, 0xb22bb22b,
+  0xb22b9123, 0x9323b323, 0xb32b9223, 0x9223b323, 0x334c9223, 0xffffdfe7, 0x80000007, 0xffffffff,
+  0x00000003, 0x1444ffd7, 0x93137313, 0xbfc7b22b, 0x80000008, 0xffffffff, 0x0000000c, 0x5dd7ffff,
+  0x5ebf3ebf, 0x3ebf3ebf, 0x1ec73ec7, 0x3ebf3ebf, 0x3eb73ebf, 0x3ebf5eb7, 0x1ebf3fbf, 0x3ebf3fbf,
+  0x3ebf3ebf, 0xfdbe3ebf, 0xffffffef, 0x80000004, 0xffffffff, 0x00000010, 0x964cffd7, 0x160cd41b,
+  0x160c160c, 0x160c360c, 0x160c160c, 0x160c160c, 0x170c160c, 0x170c170c, 0x170c170c, 0xf613f613,
+  0x160c1614, 0x160c160c, 0xf50bf60b, 0xf41bf513, 0xf32b9213, 0xffd7fa7d, 0x80000007, 0xffffffff,
+  0x0000000c, 0xbfcfffef, 0xd41b1334, 0xd523d61b, 0xdcae7fb7, 0x9fc7199e, 0x922b9fb7, 0x5c7e721b,
+  0x7caeffd7, 0xbfd73ba6, 0x5875ffe7, 0x7313b51b, 0xffef166d, 0x80000004, 0xffffffff, 0x0000000d,
+  0x3123da8d, 0x931b721b, 0x731b931b, 0x921b9213, 0x9213921b, 0xf513b413, 0xf4131514, 0x931bb31b,
+  0x9313b31b, 0x931bb31b, 0xb41b9313, 0xb133931b, 0xffffffe7, 0x80000006, 0xffffffff, 0x00000004,
+  0xffefffff, 0x5444ffdf, 0xd51bb41b, 0xffcfd32b, 0x80000008, 0xffffffff, 0x0000000d, 0xb56cffef,
+  0xb41b5223, 0xb31bb31b, 0xb423b31b, 0xb41bb423, 0xd313b31b, 0xd31bd41b, 0xb423b41b, 0xb41bb41b,
+  0xd313f41b, 0xb2239213, 0xffd7d97d, 0xffffffef, 0x80000003, 0xffffffff, 0x00000002, 0x754cffd7,
+  0xf60bb413, 0x80000004, 0x160c160c, 0x0000000b, 0x170c160c, 0xf70bf70b, 0x170c170c, 0xf613f613,
+  0x160cf613, 0x360c360c, 0x3614360c, 0x160c160c, 0x1514150c, 0x133cb31b, 0xffefbdae, 0x80000005,
+  0xffffffff, 0x0000000d, 0xffefffff, 0x754cffd7, 0xb413b31b, 0xdf8e731b, 0x324cffcf, 0x3c8ece22,
+  0x722bffbf, 0x7e7e721b, 0x3033bfbf, 0xbea60f2b, 0x7554ffdf, 0xb413b413, 0xffefd985, 0x80000003,
+  0xffffffff, 0x0000000e, 0xffefffff, 0x3865feb6, 0x9b5d7a65, 0x9b5d9b5d, 0x9a5d9a5d, 0xbb5d9a5d,
+  0x360cd82c, 0x3614f503, 0x9b655a55, 0xbb5d5955, 0x7b5d9b5d, 0x9b5d9b5d, 0xb9757a5d, 0xffffffe7,
+  0x80000003, 0xffffffff, 0x0000001c, 0xffe7ffef, 0xffefffef, 0xffe7ffef, 0xffe7ffef, 0xb644ffd7,
+  0xd413d413, 0xffbf142c, 0xffefffe7, 0xffefffef, 0xffe7ffe7, 0xffefffef, 0xffffdfef, 0xffffffff,
+  0xffffffff, 0xffefffff, 0xd664ffe7, 0xf613941b, 0x16141614, 0xf613f613, 0xf613f613, 0x15141614,
+  0x1614f50b, 0x1714f613, 0x160cf613, 0x1604160c, 0xd413360c, 0xb464301b, 0xffffffe7, 0x80000003,
+  0xffffffff, 0x00000012, 0x954cffd7, 0x160cb413, 0x160c160c, 0x160c160c, 0x160c170c, 0x160c160c,
+  0x170c160c, 0x170c170c, 0x170c170c, 0x1614160c, 0x160c1614, 0x360c360c, 0x160cf50b, 0xf60bf60b,
+  0x160c570c, 0xb413f513, 0xfb7d7213, 0xffffffe7, 0x80000004, 0xffffffff, 0x0000000d, 0xbfd7ffff,
+  0x940bb744, 0xb323f51b, 0xffdf997d, 0x534cffd7, 0x5d8e5123, 0xb233bfbf, 0x7e7e5113, 0x9233ffbf,
+  0x3f9f7123, 0x143cffcf, 0xb313f413, 0xffefbca6, 0x80000003, 0xffffffff, 0x00000002, 0xffdfffef,
+  0xffd7ffdf, 0x80000003, 0xffcfffcf, 0x00000018, 0xffc7ffcf, 0xd503fd5d, 0x56241614, 0xffd7ffb7,
+  0xffcfffcf, 0xffcfffcf, 0xffd7ffd7, 0xffd7ffcf, 0xffefffdf, 0xffffffff, 0xffffffff, 0x5aa6ffff,
+  0xfb75b97d, 0xfb75da75, 0xdb75db75, 0xfb75fb7d, 0x1424db6d, 0xf513f513, 0xfb65151c, 0xda751b76,
+  0xfb75db75, 0xfb75fb75, 0xda7ddb75, 0xffef1a9e, 0x80000003, 0xffffffff, 0x0000000d, 0xb564ffe7,
+  0x9313511b, 0x93139313, 0x93139313, 0x931b931b, 0x921b921b, 0xb41b931b, 0x940bb413, 0xf60b161c,
+  0x3714160c, 0xb413170c, 0x1a96b22b, 0xffffffef, 0x80000003, 0xffffffff, 0x00000007, 0x954cffcf,
+  0x160cd413, 0x160c160c, 0x160c1614, 0x160c170c, 0x160c160c, 0x170c160c, 0x80000003, 0x160c160c,
+  0x00000008, 0x170c160c, 0x160c160c, 0xb40b361c, 0x57245724, 0x16041604, 0x16143714, 0x72131614,
+  0xffe7586d, 0x80000004, 0xffffffff, 0x0000002d, 0x13545ed7, 0x36149313, 0x59657213, 0xffe7ffdf,
+  0x744cffd7, 0x7e86311b, 0xb233bfb7, 0x9e7e721b, 0x9233dfb7, 0x3f979123, 0x9223bfaf, 0xf413f413,
+  0xffdf7faf, 0xffe7ffdf, 0xffe7dfe7, 0xffffffff, 0x32545dc7, 0x1444344c, 0x554c554c, 0x544c344c,
+  0x334c534c, 0x5544344c, 0xf60b572c, 0xf51bf60b, 0x344c3544, 0x544c334c, 0x344c3444, 0x334c5454,
+  0x3444744c, 0xf674d243, 0xffffffef, 0xffffffff, 0xd56cffef, 0x9413521b, 0xb313b413, 0xb41b9313,
+  0x93139313, 0x151cb413, 0x36141614, 0xb40bf513, 0xb313b30b, 0x730bb413, 0x9313b413, 0x51139313,
+  0xffdf7454, 0x80000003, 0xffffffff, 0x0000000c, 0xbcb6ffef, 0x7c8e5b96, 0x9d8e7d96, 0x9d8e9d8e,
+  0x7d969d8e, 0x7d967c96, 0x9e867d8e, 0x7f6eff86, 0xf613371c, 0xf6131614, 0xf42bb413, 0xffe7dea6,
+  0x80000004, 0xffffffff, 0x00000013, 0x954cffcf, 0x170cd413, 0x160c160c, 0x16141614, 0x160c170c,
+  0x160c160c, 0x160c160c, 0x1614160c, 0x360c160c, 0x160c360c, 0x170cf70b, 0xf613170c, 0xb7449313,
+  0x152c7f9f, 0x15041514, 0xf60b3714, 0xf513160c, 0x5865b31b, 0xffffffe7, 0x80000003, 0xffffffff,
+  0x0000002d, 0xd2437fd7, 0x720bb31b, 0xffcf5765, 0xdfbf5d96, 0x7544ffcf, 0xdf865213, 0x9223ffbf,
+  0x9e76b31b, 0xb22bffbf, 0x7f9f7123, 0x931b9e86, 0x16141614, 0x773c7734, 0x763c563c, 0x376d343c,
+  0xffffdfef, 0xb22b5fbf, 0xd41bb31b, 0x721b7213, 0x521b7223, 0x711b511b, 0x731b721b, 0x17149513,
+  0x1614370c, 0x521b931b, 0x721b9223, 0x721b721b, 0x7213521b, 0xd413b413, 0x754cb41b, 0xffffffef,
+  0xffefffff, 0x176dffe7, 0xf613931b, 0xf613d513, 0xd50bf513, 0xf513d50b, 0xf60bd50b, 0x160c160c,
+  0xf50b160c, 0xd513f513, 0xf513d50b, 0xf513d513, 0xb3133614, 0xffdf954c, 0x80000004, 0xffffffff,
+  0x0000000b, 0xffefffef, 0xffffffff, 0xffe7ffef, 0xffefffe7, 0xffefffef, 0xffd7ffe7, 0xd73c5f9f,
+  0x160c1514, 0x9313160c, 0x5fc7554c, 0xffffffef, 0x80000004, 0xffffffff, 0x00000013, 0x9544ffcf,
+  0x170cd40b, 0x170c170c, 0xf60bf613, 0x160c170c, 0x160c160c, 0x160c160c, 0x1614160c, 0x160c160c,
+  0x160c160c, 0x1714170c, 0xb413f60b, 0xdfbf353c, 0xd32bffbf, 0x360cf413, 0x3714f60b, 0xf60b370c,
+  0x931bf513, 0xffefba85, 0x80000003, 0xffffffff, 0x0000002d, 0xddaeffef, 0x375d5023, 0x9c9effd7,
+  0xf52b5223, 0x35341855, 0x3945d41b, 0xd41bbb5d, 0x3945d41b, 0xf423bb5d, 0x5f979223, 0xb3139a5d,
+  0xd613f513, 0x950bd613, 0xb40bf613, 0x954cb313, 0xffffffff, 0xd3237fb7, 0xf613f513, 0xbb659a55,
+  0xdc6dfc6d, 0xfb6dfb65, 0xbb65db6d, 0xd60b9834, 0x1614160c, 0xdb6d7a55, 0xfc65db65, 0xdb65fb65,
+  0xdc65fc6d, 0xd50bb82c, 0x9744b50b, 0xffffffef, 0xffffffff, 0x1765ffe7, 0x17149413, 0x3624f61b,
+  0x552c362c, 0x552c352c, 0x361c3624, 0x160c160c, 0x36241614, 0x3534352c, 0x352c152c, 0x151c3524,
+  0xd40b160c, 0xffdfb54c, 0x80000008, 0xffffffff, 0x00000006, 0xffefffff, 0x386d9fcf, 0xb313b223,
+  0xb40bf413, 0x7965d41b, 0xffffffdf, 0x80000005, 0xffffffff, 0x00000043, 0x954cffcf, 0x170cb413,
+  0xf70b170c, 0x1714f70b, 0x1614f60b, 0x1614150c, 0xf60b360c, 0x170c1714, 0x160c160c, 0xf60b160c,
+  0x371cf60b, 0x142cb40b, 0xffe77fc7, 0xd32bbfbf, 0x360c1514, 0x1614f60b, 0xf60b170c, 0x941b161c,
+  0x1faf9323, 0xffffffef, 0xffffffff, 0xffffffff, 0xffefffff, 0xffdf7bb6, 0x143cffd7, 0xb413d41b,
+  0x7634352c, 0xd503f50b, 0xf613950b, 0xf613f613, 0xf513b503, 0xde7ed31b, 0xf513b72c, 0xd41bf41b,
+  0xf523d423, 0xf513f513, 0x9454b31b, 0xffefffef, 0xf3237fb7, 0x151cb40b, 0xbfb7dfaf, 0x5fa77faf,
+  0x7fa77fa7, 0xffcf5faf, 0xb4131d6e, 0x562cd50b, 0xdfc7ffc7, 0xdfa7bfaf, 0xbfa7ffa7, 0xffcf9fb7,
+  0x9413dc6d, 0xb844950b, 0xffffffe7, 0xffffffff, 0x1765ffe7, 0xf6139413, 0x7fafd42b, 0xffd7ffd7,
+  0xffd7ffd7, 0x753cffbf, 0xf513f50b, 0x9fb7f42b, 0xbfdfffdf, 0xffd7dfdf, 0x553cffbf, 0xf413d40b,
+  0xffdfb54c, 0x80000008, 0xffffffff, 0x00000005, 0xda85bfd7, 0x93131434, 0xf51bd51b, 0x13349213,
+  0xffe7bd9e, 0x80000006, 0xffffffff, 0x00000014, 0x954cffcf, 0xf60bd413, 0x160c170c, 0x170c170c,
+  0x160c160c, 0xf50b150c, 0x370c360c, 0xf60b170c, 0x370c170c, 0x1614160c, 0x930b571c, 0x5faff423,
+  0xdfefffef, 0xf4339fc7, 0x160c1514, 0x1614160c, 0x160c370c, 0x161cf613, 0x553cb413, 0xffffffdf,
+  0x80000003, 0xffffffff, 0x0000002c, 0xffdfffff, 0x931bdb7d, 0xb413151c, 0x7544df8e, 0xb313b213,
+  0x941bb41b, 0x9313b41b, 0xb313d51b, 0x794db21b, 0xf513f50b, 0x5f97f423, 0xdb6ddfb7, 0xb413d513,
+  0xdfc71855, 0xffefffe7, 0xb2237fb7, 0xf51b161c, 0x12549fb7, 0x712b0f2b, 0x302b922b, 0xfeae0f33,
+  0x93131c76, 0x152cd513, 0x125cdfcf, 0x7123502b, 0x702b7123, 0x9ca60e33, 0x941b3d86, 0xd844b50b,
+  0xffffffe7, 0xffffffff, 0x176dffef, 0xf613b413, 0xffc7f433, 0xffe7ffdf, 0xffe7ffef, 0x9544ffdf,
+  0xd40bb40b, 0xdfc71434, 0xffffffe7, 0xffe7ffef, 0x553cffd7, 0xd413b50b, 0xffe7944c, 0x80000007,
+  0xffffffff, 0x00000006, 0xffefffff, 0x511bfa8d, 0x1614f513, 0x93239413, 0xdfc7796d, 0xffffffe7,
+  0x80000006, 0xffffffff, 0x00000014, 0x754cffcf, 0x170cd513, 0x160c160c, 0x160c160c, 0x370c360c,
+  0x360c360c, 0x16041604, 0x370c160c, 0x360cf603, 0xf60bf60b, 0x142cf50b, 0xffef3fb7, 0xffffffff,
+  0xf3339fc7, 0x370cd50b, 0x160c160c, 0x370c1604, 0xd60b160c, 0x9313160c, 0xffeffa8d, 0x80000003,
+  0xffffffff, 0x0000002c, 0x5fbfffef, 0x1514b31b, 0x1855930b, 0x5ec7ffdf, 0x3eaf3db7, 0x1eb71eb7,
+  0x1eb71eb7, 0x3faffeae, 0x763c5fa7, 0xd50b1514, 0xffc7352c, 0xba7dffd7, 0x94139413, 0xffe7b97d,
+  0xffefffff, 0xd32b5fbf, 0x1524b50b, 0xf5745fb7, 0x75543454, 0x5354754c, 0x9fc7125c, 0xb30b3c76,
+  0x562c1514, 0xf57cdfc7, 0x544c324c, 0x5354744c, 0xfdae115c, 0x9413fc75, 0xb744d513, 0xffffffe7,
+  0xffffffff, 0x176dffe7, 0xf513b313, 0x7fa7f423, 0xdfc7ffbf, 0xbfc7dfc7, 0x5634dfb7, 0xf513f513,
+  0x9fa71524, 0xdfcfffc7, 0xdfc7bfcf, 0x5634ffb7, 0xd513d613, 0xffdf754c, 0x80000007, 0xffffffff,
+  0x00000005, 0xffefffff, 0xb313ba75, 0xd50b160c, 0xfeb6974c, 0xffefffe7, 0x80000007, 0xffffffff,
+  0x00000044, 0x754cffcf, 0x1714b413, 0xd413d513, 0xd413d413, 0x160cd50b, 0x16041604, 0xf50b5614,
+  0xf513f50b, 0xf50b1514, 0x16141614, 0x3c76d40b, 0xffffffdf, 0xffefffff, 0xd3339fcf, 0x160cf50b,
+  0xb40b1514, 0xf60bf50b, 0x370c360c, 0xb413370c, 0xffdff33b, 0xffffffff, 0xffffffff, 0xffefffff,
+  0x3444ffd7, 0x1614f513, 0x7d8eb313, 0x9fd7ffdf, 0xffc7bfc7, 0xdfc7ffcf, 0xdfcfdfcf, 0xffc7bfc7,
+  0xd41b1f97, 0x1614f60b, 0x7fafd323, 0x376dffdf, 0x7313b51b, 0xffef5b9e, 0xffffffff, 0x302b1ebf,
+  0x521b731b, 0xffd75fbf, 0xffb7ffbf, 0xffc7ffb7, 0xffd79fc7, 0xb30bdb65, 0x3524d50b, 0xdfcfffc7,
+  0xffb7ffbf, 0xdfbfffb7, 0xffd79fc7, 0x311bba75, 0x544c521b, 0xffffffef, 0xffffffff, 0x176dffe7,
+  0x1514b313, 0xd423151c, 0x1534352c, 0x16341534, 0x161cf523, 0xf60bf60b, 0x36241514, 0xf533f52b,
+  0x1534f433, 0xd51bf523, 0x9413f713, 0xffe7b654, 0xffffffef, 0x80000006, 0xffffffff, 0x00000005,
+  0xffe7ffff, 0xb30bdb6d, 0xb40b160c, 0xffe71faf, 0xffffffe7, 0x80000003, 0xffffffff, 0x00000001,
+  0xffffffef, 0x80000003, 0xffffffff, 0x00000053, 0xb654ffd7, 0xf613d513, 0x14347634, 0x343c1334,
+  0xf51b5534, 0x170c170c, 0x1524f513, 0x553c553c, 0xf51b142c, 0x36141614, 0xf32bf513, 0xffffbed7,
+  0xffffffff, 0xb32bbfcf, 0xd50b1614, 0x343c5534, 0xd41b5534, 0xf603360c, 0x161c170c, 0x5c8e931b,
+  0xffffffef, 0xffffffff, 0xffe7ffff, 0xb313585d, 0xf613d50b, 0xff96b31b, 0x722b9fb7, 0xf41bf423,
+  0xf423d41b, 0xf523f423, 0x151cf41b, 0xf60bf513, 0x1614f60b, 0xde96931b, 0x5554ffd7, 0xb41b7413,
+  0xfffffdb6, 0xffffffff, 0x3baebfe7, 0x9ca65ba6, 0xb554dfc7, 0x5624f423, 0x352c7624, 0x9fb7d33b,
+  0xb4131d6e, 0x7634d513, 0x7554dfb7, 0x7724f523, 0x562c5724, 0x9d96d32b, 0x5b9e7fb7, 0xbbb65ba6,
+  0xffffffff, 0xffffffff, 0x1765ffe7, 0x160cb413, 0xf6131614, 0xb50bf513, 0xd60bb50b, 0xf60bf613,
+  0x370c370c, 0xd50b160c, 0xb50bf613, 0xd50bf513, 0x3714f50b, 0xb413170c, 0xffe79554, 0xffffffff,
+  0xffffffff, 0xffe7ffef, 0xffe7ffe7, 0xffefffef, 0xffe7ffef, 0xffe7ffe7, 0xffd7ffe7, 0xb40b1c6e,
+  0xd413160c, 0xffdfff9e, 0xffe7ffe7, 0xffe7ffe7, 0xffdfffe7, 0xffe7ffe7, 0xffefffe7, 0x80000003,
+  0xffffffff, 0x0000007b, 0x544cffd7, 0xf613940b, 0xffc73f9f, 0xffcfffd7, 0x595dffcf, 0xf713b50b,
+  0xff967213, 0xffcfffd7, 0xd42b5fa7, 0xf50bf513, 0x7965b313, 0xffffffe7, 0xbfdfffff, 0xf52b9d96,
+  0xb73cb413, 0xffd7ffc7, 0x9544dfbf, 0x370cb40b, 0x1614d60b, 0xd74cb513, 0xffffffe7, 0xffffffff,
+  0x997dffef, 0x36147213, 0xf5133714, 0xdf8e5213, 0x5123bfb7, 0xd40b9313, 0xd413d413, 0xb413b413,
+  0x940bb40b, 0xd513b413, 0xd513f613, 0x1c769313, 0x143cffc7, 0xf423b413, 0xffff9fcf, 0xffffffff,
+  0xffffffff, 0xffefffff, 0xf243ffd7, 0xb31b9223, 0xb22bd323, 0x5fb73033, 0x721b1c7e, 0xf42bb31b,
+  0x334c9fb7, 0xb3239223, 0xd423b41b, 0x3b965123, 0xffefffe7, 0xffffffef, 0xffffffff, 0xffffffff,
+  0x176dffef, 0x160cb413, 0xb40bf613, 0xb413d413, 0xb413b41b, 0xf513d413, 0x160c160c, 0xf5131614,
+  0xd41bb413, 0xd3139313, 0x150cd40b, 0xb413f60b, 0xffe79554, 0xffffffff, 0xffffffff, 0xd564788d,
+  0xd65cd664, 0xf664d664, 0xd664d664, 0xf75cf764, 0x3755f75c, 0xd513b73c, 0xf513150c, 0xd654b744,
+  0xf65cd65c, 0x165d165d, 0x165df65c, 0xd65cf65c, 0xb464d55c, 0xffffdbc6, 0xffffffff, 0xffffffff,
+  0x954cffcf, 0x9413d513, 0xffdf1b86, 0xffefffef, 0xdea6ffef, 0xb5139413, 0xffdf5544, 0xffefffef,
+  0xd654ffdf, 0xf613b413, 0x1fafd423, 0xffffffff, 0x3b96ffef, 0xf51b7213, 0x9d96721b, 0xffefffdf,
+  0x5b9effef, 0x160c9313, 0x16143714, 0xd423f60b, 0xffff9fd7, 0xffffffff, 0x51231a96, 0x160c151c,
+  0x1614160c, 0xdf969313, 0x33549fbf, 0x964c754c, 0x554c754c, 0x5544964c, 0xb64c964c, 0x59659554,
+  0x362c1534, 0x594d9313, 0x921bbf9f, 0x9644b413, 0xffffffdf, 0x80000003, 0xffffffff, 0x0000000a,
+  0xbfd7ffef, 0x9fcf7fcf, 0x5ecf9fcf, 0xffef7fdf, 0xf243d995, 0xb55c1344, 0x9ed7dfd7, 0x7ecf7ed7,
+  0x7fcf7fcf, 0xdfe77ecf, 0x80000004, 0xffffffff, 0x00000053, 0x176dffef, 0x160cb413, 0x9d8e152c,
+  0xddaefeae, 0xfeaeddae, 0x5534de96, 0xf513f613, 0xbe8ef423, 0xddaefda6, 0xfeaeddae, 0x542cfd96,
+  0xb51bd513, 0xffdf7554, 0xffffffff, 0xffefffff, 0x731b554c, 0xb50bd513, 0xb40bb40b, 0xb413d413,
+  0xb5139413, 0xb30bd413, 0xf613d40b, 0x160c370c, 0xd513f50b, 0xb40bb40b, 0xd40bb40b, 0xd513d50b,
+  0xb41bb413, 0x5123b413, 0xffff7cae, 0xffffffff, 0xffffffff, 0x9444ffcf, 0xb513d513, 0xffe77554,
+  0xffffffff, 0xffdfffff, 0x731b353c, 0xffef787d, 0xffffffff, 0x7c96ffef, 0x94139313, 0xffdfd754,
+  0xffffffff, 0x9654ffdf, 0xd413b413, 0xffd73444, 0xffffffef, 0xffdfffff, 0xb40b553c, 0xf60b1614,
+  0xb41b160c, 0xffff7cae, 0xffffffff, 0xf33b7fbf, 0xf513b31b, 0x16143614, 0x9d8e9313, 0xffdfffdf,
+  0xffb7dfbf, 0xffb7dfb7, 0xffb7bfb7, 0xbfb7ffb7, 0xffdfffd7, 0xf8549fbf, 0xd82cb313, 0xb313fc5d,
+  0x5965b413, 0xffffffe7, 0xffffffff, 0xffffffff, 0xffefffff, 0xffdfffe7, 0xffe7ffe7, 0xffe7ffe7,
+  0xffdfffe7, 0xffc7ffcf, 0xffbfffbf, 0xffe7ffd7, 0xffe7ffe7, 0xffdfffe7, 0xffe7ffe7, 0xffefffe7,
+  0x80000003, 0xffffffff, 0x00000053, 0x176dffef, 0xf513b413, 0xffc7f42b, 0xffefffe7, 0xffe7ffef,
+  0x7644ffd7, 0xd513d513, 0xffc71434, 0xffe7ffdf, 0xffe7ffef, 0x753cffd7, 0x9413d513, 0xffdf9554,
+  0xffffffef, 0xffefffff, 0x931b7554, 0xd50b940b, 0xd40bd50b, 0xf413b30b, 0xb4139413, 0xf413d413,
+  0x3614d50b, 0x370cf60b, 0xb50bd50b, 0xd513d513, 0xb50bb413, 0xb50bd50b, 0xb413b513, 0x7223b413,
+  0xffff9cae, 0xffffffff, 0xffffffff, 0x9544ffc7, 0xd613d513, 0x3fb79323, 0xffffffef, 0xffefffff,
+  0x30237975, 0xffff1dbf, 0xffffffff, 0xdfd7ffff, 0x7213152c, 0xffef9ca6, 0xffffffff, 0x7323ffae,
+  0x9413f613, 0xffefd98d, 0xffffffff, 0xffefffff, 0x921b7c8e, 0x160c3514, 0x9413170c, 0xffefb985,
+  0xffffffff, 0x1a96ffef, 0xfb6d3023, 0xf413b72c, 0x7d8e9313, 0xbfd7ffe7, 0x372c5644, 0x57245724,
+  0x562c772c, 0x34345624, 0xffe7fdb6, 0xb97dffe7, 0x36149313, 0x15143614, 0x7d967313, 0xffffffef,
+  0xffffffff, 0xffffffff, 0x988dffef, 0x5634153c, 0x563c7644, 0x96347634, 0x763c763c, 0x963c963c,
+  0x98349734, 0x76347734, 0x76347634, 0x5534963c, 0x563c763c, 0x1fbf1444, 0x80000003, 0xffffffff,
+  0x00000053, 0xf76cffef, 0xf5139313, 0xbfb7142c, 0xffdfffd7, 0xffd7ffdf, 0x763cffc7, 0xf613d50b,
+  0xdfb7152c, 0xffdfffd7, 0xffdfffdf, 0x563cffc7, 0xb513b513, 0xffdf9554, 0xffffffef, 0xffefffff,
+  0x534c3675, 0x754c754c, 0x954c5544, 0x754c954c, 0x7654554c, 0xb64c5544, 0x15143524, 0x1514150c,
+  0x764c5634, 0x554c764c, 0x7654554c, 0x764c764c, 0x554c554c, 0x134c764c, 0xffffbcc6, 0xffffffff,
+  0xffffffff, 0x9544ffcf, 0xf613d513, 0xfb7d931b, 0xffffffe7, 0xffefffff, 0x1254bdae, 0xffffffef,
+  0xffffffff, 0xffefffff, 0xf33b386d, 0xffffffdf, 0xffefffff, 0x931b5875, 0xf52bb513, 0xffffdfd7,
+  0xffffffff, 0xffefffff, 0x343cffd7, 0x160cd413, 0x9413170c, 0xffe7786d, 0xffffffff, 0xbfdfffff,
+  0xffc71a9e, 0xd4139634, 0x7d8e931b, 0xbfd7ffe7, 0xd60bf52b, 0xb50bd60b, 0xd413930b, 0x9213f50b,
+  0xffefdcae, 0xbcaeffef, 0x360c9213, 0xd413150c, 0x5fbff42b, 0xffffffef, 0xffffffff, 0xffffffff,
+  0xd66cffef, 0x9313521b, 0x93137313, 0xb30b9313, 0x93139413, 0x92139213, 0x94139413, 0x94139413,
+  0xb30bb313, 0x9413b313, 0x940bd50b, 0x1faf9323, 0x80000003, 0xffffffff, 0x0000001d, 0x176dffe7,
+  0x3614b413, 0xb63cf41b, 0x55449644, 0x964c764c, 0xf523b744, 0x1614f60b, 0x763cf51b, 0x754c964c,
+  0x764c9654, 0xd5237644, 0xb413f613, 0xffe79454, 0xffffffef, 0xffffffff, 0xffe7ffe7, 0xffe7ffdf,
+  0xffdfffdf, 0xffdfffdf, 0xffe7ffe7, 0xffd7ffe7, 0xb30b1c6e, 0xd41bf50b, 0xffdfdf9e, 0xffe7ffe7,
+  0xffdfffe7, 0xffdfffdf, 0xffe7ffe7, 0xffdfffdf, 0x80000003, 0xffffffff, 0x00000006, 0x954cffcf,
+  0x1614d513, 0x963cd50b, 0xffffffdf, 0xffffffff, 0x7bb67fd7, 0x80000003, 0xffffffff, 0x0000001b,
+  0x788d9cb6, 0xffffffff, 0x7ed7ffff, 0x953c9875, 0x9a6d9213, 0xffffffe7, 0xffffffff, 0xffffffff,
+  0x3b96ffef, 0x1614931b, 0xb413f60b, 0xffe7f65c, 0xffffffff, 0xffffffff, 0xffdfffef, 0xd4137534,
+  0x9d96931b, 0xbfd7ffef, 0xb40bf423, 0xf74c1424, 0x753c385d, 0x9313f513, 0xffefbca6, 0xbfd7ffff,
+  0x160cf42b, 0xd313150c, 0xffe79654, 0x80000003, 0xffffffff, 0x0000001c, 0xb895ffef, 0x744c1244,
+  0x544c344c, 0x5544554c, 0x55445544, 0x544c544c, 0x354c354c, 0x544c354c, 0x754c544c, 0x3534554c,
+  0xf613d513, 0xfeae9323, 0xffffffef, 0xffffffff, 0xffffffff, 0x1765ffe7, 0x1604b40b, 0xf50b160c,
+  0xf513f50b, 0xb40bd513, 0xf513930b, 0x160c3614, 0xd513f513, 0xd513d513, 0xd50b940b, 0x160cd50b,
+  0xb41b1614, 0xffe79554, 0x80000007, 0xffffffff, 0x00000009, 0xffe7ffff, 0x9413fb75, 0x73131614,
+  0xffeffeb6, 0xffefffef, 0xffefffef, 0xffffffff, 0xffffffff, 0xffefffe7, 0x80000003, 0xffffffff,
+  0x00000004, 0x964cffcf, 0x1714b413, 0xb31b1714, 0xffef5eb7, 0x80000005, 0xffffffff, 0x00000005,
+  0xdfefffef, 0xffffffff, 0xf99dffff, 0x78653b86, 0x9fbf912b, 0x80000003, 0xffffffff, 0x00000013,
+  0xdfdfffff, 0xd513343c, 0xb513160c, 0xffdfd65c, 0xffffffff, 0xffffffff, 0xdfdfffff, 0xd4135534,
+  0x7d8e931b, 0x9fcfffef, 0xd413352c, 0xffc7f32b, 0xda75ffd7, 0xb413b413, 0xffd73fa7, 0xffdf9edf,
+  0xb50b1955, 0xb313160c, 0xffef3b96, 0x80000003, 0xffffffff, 0x00000003, 0xdfe7ffff, 0xffd7ffd7,
+  0xffd7ffd7, 0x80000003, 0xffcfffcf, 0x00000017, 0xffd7ffd7, 0xffd7ffd7, 0xffcfffcf, 0x9e86ffcf,
+  0xf513d50b, 0x3fafb323, 0xffffffef, 0xffffffff, 0xffffffff, 0x1765ffe7, 0x370cb413, 0xb403360c,
+  0xb30bb40b, 0xd51b940b, 0xf513b413, 0x160c1614, 0xb40bf513, 0x940bb513, 0xd413b40b, 0xd413b40b,
+  0x51137313, 0xffdfb654, 0xffffffef, 0x80000006, 0xffffffff, 0x00000004, 0xffe7ffff, 0x9413bb75,
+  0xb41bf613, 0xffffddb6, 0x80000008, 0xffffffff, 0x00000004, 0x9654ffd7, 0x160cb413, 0x930b3714,
+  0xffefb97d, 0x80000003, 0xffffffff, 0x00000001, 0xdfe7dcc6, 0x80000003, 0xffffffff, 0x00000019,
+  0x7785dfdf, 0x3b967c9e, 0xffe75785, 0xffffffff, 0x5ab6ffef, 0xffffbfef, 0xffefffff, 0x721b3b8e,
+  0xb513f613, 0xffdfd75c, 0xffffffff, 0xffffffff, 0xffe7ffff, 0xd50b7634, 0x7d8e9313, 0x9fcfffe7,
+  0xb4131424, 0xffc7f433, 0xfb85ffdf, 0xd613530b, 0x553c9c55, 0xffdf577d, 0x950b3d76, 0x1424f613,
+  0xffffbfcf, 0x80000004, 0xffffffff, 0x0000001c, 0xbb755c9e, 0xfc75fc7d, 0x1c6e1c76, 0x1c6e1c6e,
+  0x1c761c76, 0xfc75fc75, 0xfc75fc75, 0x1c6e1c6e, 0x39453d6e, 0x1514b403, 0x1fa7b323, 0xffffffef,
+  0xffffffff, 0xffffffff, 0xf764ffe7, 0x16149413, 0x5955f51b, 0x78755865, 0x186d3875, 0x152c5965,
+  0x1614d513, 0x5955f41b, 0x596d5965, 0x386d796d, 0x386d386d, 0x5865586d, 0x3fa77644, 0xffffffe7,
+  0x80000006, 0xffffffff, 0x00000004, 0xffefffff, 0x9513fc7d, 0xb41bd613, 0xffffddb6, 0x80000008,
+  0xffffffff, 0x00000024, 0xb65cffdf, 0xf60bb413, 0xd413160c, 0xffdf5444, 0xffffffff, 0xffffffff,
+  0xffefffff, 0xddbe3364, 0xffffffef, 0xffffffff, 0xffffffff, 0x7885bcb6, 0xbcb65b9e, 0xffffdfe7,
+  0xffffffff, 0x5043bfcf, 0xffff9bb6, 0xffffffff, 0x3444ffdf, 0x9513b513, 0xffe7b65c, 0xffffffff,
+  0xffffffff, 0xffdfffff, 0xb40b763c, 0x9d8e9313, 0x5fbfffe7, 0xb413d41b, 0xffcf3544, 0x7975ffdf,
+  0x1714b413, 0x7213d513, 0xdfb7744c, 0xd6137734, 0xb41bf613, 0xffef7c9e, 0x80000004, 0xffffffff,
+  0x0000001c, 0x31237564, 0x721b5223, 0x721b921b, 0x921b921b, 0x721b721b, 0x72237223, 0x721b7223,
+  0x931b921b, 0xd4139213, 0x15143614, 0x1fafb323, 0xffffffef, 0xffffffff, 0xffffffff, 0xd66cffef,
+  0x731b521b, 0xdfc7922b, 0xffe7ffdf, 0xffe7ffef, 0x9644ffd7, 0xf513b513, 0xffc7f423, 0xffe7ffdf,
+  0xffe7ffe7, 0xffe7ffe7, 0xffd7ffe7, 0x931b5634, 0x7baed65c, 0x80000006, 0xffffffff, 0x00000004,
+  0xffe7ffff, 0x9513db75, 0x931b1614, 0xffffddb6, 0x80000008, 0xffffffff, 0x00000024, 0x586dffdf,
+  0x160cb413, 0xf51b1614, 0x3fafd323, 0xffffffef, 0xffffffff, 0x5ec7ffff, 0x9975302b, 0xffffffef,
+  0xffffffff, 0xffefffff, 0x3b969885, 0x5dcf5aa6, 0xffffffff, 0xffefffff, 0x311bfb7d, 0xffdf9554,
+  0xffffffef, 0xfa8dffef, 0x9413d423, 0xffe7d664, 0xffffffff, 0xffffffff, 0xffe7ffff, 0xb40b763c,
+  0x9d8e931b, 0x7c9effe7, 0xd413b413, 0xffdfb654, 0x343cbfbf, 0xd50bd413, 0xf42b941b, 0x79555b76,
+  0xf713940b, 0xf613f70b, 0xdfc7f42b, 0x80000003, 0xffffffff, 0x0000000c, 0xffefffff, 0x712b745c,
+  0xb22bb22b, 0xb22bd22b, 0xb32bb32b, 0xb22bb22b, 0xb22b922b, 0xb22bb22b, 0xb32bb22b, 0xf41bd32b,
+  0xf613f60b, 0x1fb79323, 0x80000003, 0xffffffff, 0x0000000f, 0x7bbeffff, 0xfa95f995, 0xdfdffa9d,
+  0xffffffff, 0xffefffff, 0x7644ffd7, 0xd513d513, 0xdfc7f333, 0xffffffef, 0xffffffff, 0xffffffff,
+  0x9fcfffff, 0xd50b1524, 0x9554b31b, 0xffffffef, 0x80000005, 0xffffffff, 0x00000004, 0xffefffff,
+  0xb413db75, 0x92131614, 0xffffdcb6, 0x80000008, 0xffffffff, 0x00000033, 0xfa8dffdf, 0x37149313,
+  0xf513150c, 0xba75b413, 0xffffffef, 0xffffffff, 0xf985ffe7, 0x553c7213, 0xffffffdf, 0xffffffff,
+  0x5dcfffff, 0x5c8e334c, 0xdfe75aa6, 0xffffffff, 0xdfd7ffff, 0xb41b553c, 0xfdae712b, 0xffffffef,
+  0x9fc7ffef, 0x9413d423, 0xffefb664, 0xffffffff, 0xffffffff, 0xffdfffff, 0xd5135634, 0x7d8e931b,
+  0x5975ffdf, 0x930bb413, 0xffdf5875, 0x7023fda6, 0x9313d423, 0xffaff84c, 0x920b9d76, 0xd613f51b,
+  0xd613b60b, 0xb64cb41b, 0xffefffdf, 0xffffffff, 0xffffffff, 0xffefffff, 0xbfafffc7, 0xdfafdfaf,
+  0xbfafdfaf, 0xbfafdfb7, 0xbfafbfaf, 0xbfb7bfb7, 0xbfb7bfb7, 0xbfafbfb7, 0x3d6edfaf, 0xf613d60b,
+  0xfeae9323, 0x80000004, 0xffffffff, 0x0000000e, 0xffefffff, 0xffffffff, 0xffffffff, 0xffefffff,
+  0x554cffdf, 0xd50bd513, 0x9fbfd323, 0xffefffe7, 0xffefffef, 0xffefffef, 0x9c9effef, 0x360cd413,
+  0xba75930b, 0xffffffef, 0x80000005, 0xffffffff, 0x00000004, 0xffe7ffff, 0x940bfc75, 0xb31bf60b,
+  0xfffffdb6, 0x80000008, 0xffffffff, 0x00000034, 0x1db7ffef, 0x160c931b, 0x350c150c, 0x763cd40b,
+  0xffffffe7, 0xffffffff, 0x9544ffd7, 0xb41bd513, 0xffffddae, 0xffffffff, 0xb885ffef, 0xba6d511b,
+  0xffff5ec7, 0xffffffff, 0x7b9effef, 0xd41b9313, 0x7fcff33b, 0xffffffff, 0xda85ffe7, 0xb4139413,
+  0xffe7b65c, 0xffffffff, 0xffffffff, 0xffdfffff, 0xd4137534, 0xdf96931b, 0xd433ffbf, 0x931bf513,
+  0xffe79ca6, 0x735cffe7, 0x7d86712b, 0x3c7effcf, 0xf413b313, 0x5a55b313, 0x7313bc65, 0xb213f41b,
+  0xdfcfd754, 0xffffffef, 0xffffffff, 0x1ebfffef, 0x9fa75faf, 0x9fa79fa7, 0x9fa79fa7, 0x7faf7faf,
+  0x9fa79fa7, 0x7faf7faf, 0x7faf7faf, 0x9fa79fa7, 0x3d6ebfa7, 0xf613b503, 0x3fafb323, 0xffffffef,
+  0x80000006, 0xffffffff, 0x0000000a, 0xffefffff, 0x965cffe7, 0xf60bb413, 0x1945d513, 0x5d8e5e86,
+  0x5c8e5c8e, 0x5c8e5c8e, 0x342c3c86, 0x360c160c, 0xbd9e9213, 0x80000004, 0xffffffff, 0x00000006,
+  0x1eb75ecf, 0x5fbf3fbf, 0x9faf7fb7, 0xd50b394d, 0x941bf70b, 0xffffddb6, 0x80000008, 0xffffffff,
+  0x00000034, 0xffdfffff, 0xf50b3534, 0x350c360c, 0xb31b160c, 0xfffffebe, 0xffefffff, 0xd31b5faf,
+  0x940bf60b, 0xffe7386d, 0xffffffff, 0x1344ffdf, 0xf744b313, 0xffffffdf, 0xffffffff, 0x9554ffe7,
+  0x9313d413, 0xffef997d, 0xffffffff, 0xf333bfcf, 0x730bf513, 0xffe7b65c, 0xffffffff, 0xffffffff,
+  0xffdfffff, 0xd4137534, 0x7f86931b, 0x93237a6d, 0xf433b41b, 0xffefdfd7, 0x5aaeffef, 0xffc7bcae,
+  0x521b1765, 0xd41bd41b, 0xffc7543c, 0x5544ffd7, 0xf413d313, 0x134c921b, 0xffffdfe7, 0xffffffff,
+  0x335cffe7, 0xb3237223, 0xb223b323, 0xb2239223, 0x9323932b, 0xb21bb31b, 0x922b9223, 0x9223922b,
+  0xb3239223, 0xb41bb323, 0x16141614, 0xfea6d323, 0xffffffef, 0x80000007, 0xffffffff, 0x00000009,
+  0x9985ffef, 0xf613731b, 0xb50b1614, 0xb41bb513, 0xb3139213, 0x9313b31b, 0xf51b930b, 0xb40bf60b,
+  0x9fcf343c, 0x80000004, 0xffffffff, 0x00000006, 0x4f33bcb6, 0xd32bb333, 0xb31bb323, 0x1614d513,
+  0x731bf613, 0xffff1ebf, 0x80000008, 0xffffffff, 0x0000002d, 0xffefffff, 0xb4133965, 0x160cf50b,
+  0xb413370c, 0xffe7ba7d, 0xffe7ffff, 0x930bda75, 0xd5133614, 0xdfc7f433, 0xffe7ffef, 0x92239c9e,
+  0x1524d513, 0xffffffcf, 0xffefffff, 0x921b1ea7, 0xd4239413, 0xffff3fc7, 0xffefffff, 0xb313b975,
+  0xd413160c, 0xffe7d65c, 0xffffffff, 0xffffffff, 0xffdfffff, 0xb413963c, 0xdf8e931b, 0x712b9e96,
+  0x1b865123, 0xffffffef, 0xffefffff, 0x1dbfffef, 0xb423712b, 0x353c941b, 0xffef7fcf, 0x3ebfffef,
+  0x9313d323, 0x7c9e922b, 0xffffffff, 0xffffffff, 0xd24bffe7, 0x9413521b, 0x931b941b, 0x931b931b,
+  0x9313931b, 0xb30bb40b, 0x80000003, 0x93139313, 0x00000004, 0xb40b9313, 0x1614160c, 0x3faf921b,
+  0xffffffef, 0x80000007, 0xffffffff, 0x00000009, 0x3ec7ffff, 0xb41b922b, 0xf60bf513, 0x1614f60b,
+  0x150c1514, 0x160c160c, 0xf613161c, 0x521bb513, 0xffefd98d, 0x80000004, 0xffffffff, 0x00000006,
+  0x955cffef, 0xf6137313, 0xd513f613, 0xd5131614, 0x75449313, 0xffffdfdf, 0x80000008, 0xffffffff,
+  0x00000033, 0xffefffff, 0x93231faf, 0x160cf513, 0xd513160c, 0x7fb7763c, 0x7fb7bfcf, 0xf513552c,
+  0xf513f513, 0x1c767313, 0x9fb7bfbf, 0xb413d74c, 0xb413f613, 0x7fbffa7d, 0x9fbf7fc7, 0xf423174d,
+  0xf7643634, 0xffffffef, 0xbfcfffef, 0xf50bf323, 0xb40b360c, 0xffe7d65c, 0xffffffff, 0xffffffff,
+  0xffe7ffff, 0x721bd333, 0x3b8e301b, 0xfa95ffdf, 0xffdf535c, 0xffffffff, 0xffffffff, 0xffefffff,
+  0x51239d9e, 0xbfc7754c, 0xffffffff, 0xffefffff, 0xd2333fa7, 0xffefd98d, 0xffffffff, 0xffffffff,
+  0x7785ffef, 0x195d1765, 0x395d395d, 0x1865185d, 0x385d385d, 0x59553955, 0x58555855, 0x385d5855,
+  0x395d395d, 0xb744595d, 0x93139313, 0xdca67123, 0x80000008, 0xffffffff, 0x00000009, 0xffefffff,
+  0x954c1eb7, 0xd323d32b, 0xd31b921b, 0xb31bb31b, 0xb413d41b, 0x731bb423, 0xfb8d153c, 0xffffffef,
+  0x80000004, 0xffffffff, 0x00000006, 0x5ba6ffef, 0xb413311b, 0x931b9313, 0xd42b931b, 0x9fbfb64c,
+  0xffffffef, 0x80000009, 0xffffffff, 0x0000001b, 0xb65cffe7, 0x3714b413, 0x1514f50b, 0xd4131514,
+  0x141cd31b, 0x150c1514, 0xf613f50b, 0x161cf613, 0xf41bf41b, 0xf613f613, 0x16141614, 0xf523d513,
+  0xf51bf523, 0x3524d40b, 0x9fd77fb7, 0xffefffff, 0x9975ffe7, 0x170cb413, 0xb413170c, 0xffe7d65c,
+  0xffffffff, 0xffffffff, 0xffefffff, 0x9985d995, 0x3dbf777d, 0xffefffef, 0xffff9fe7, 0x80000003,
+  0xffffffff, 0x0000000b, 0x3aaeffe7, 0xffffbfdf, 0xffffffff, 0xffffffff, 0x7ecfffe7, 0xffffbee7,
+  0xffffffff, 0xffffffff, 0xffefffff, 0xffefffef, 0xffe7ffe7, 0x80000003, 0xffefffef, 0x00000006,
+  0xffe7ffef, 0xffe7ffe7, 0xffe7ffe7, 0xfebeffe7, 0x376dd66c, 0x5ec7f66c, 0x80000009, 0xffffffff,
+  0x00000007, 0xffefffef, 0x1dc77fd7, 0x1ebf1ebf, 0xfebe1ebf, 0x1fbfffb6, 0x7fc7fdb6, 0xffefdfdf,
+  0x80000005, 0xffffffff, 0x00000005, 0xbfdfffff, 0xda85d995, 0x5b9efa8d, 0x7fcfbdae, 0xdfefffef,
+  0x8000000a, 0xffffffff, 0x00000014, 0x1eb7ffff, 0xf50b931b, 0x36141514, 0x160c160c, 0x1504160c,
+  0x360c3604, 0xf613f613, 0xf603160c, 0x160cf603, 0xf70b170c, 0x16141614, 0xf70bf70b, 0xf60bf603,
+  0x35241604, 0xffffbfcf, 0xffffffff, 0xb22b7fc7, 0xf703d513, 0xb413170c, 0xffe7d65c, 0x80000003,
+  0xffffffff, 0x00000002, 0xffe7ffef, 0xffefffef, 0x80000017, 0xffffffff, 0x00000002, 0xffefffef,
+  0xffefffef, 0x80000016, 0xffffffff, 0x00000002, 0xffefffef, 0xffefffef, 0x8000000c, 0xffffffff,
+  0x00000014, 0xffefffff, 0xb3139975, 0x160c1514, 0x170c170c, 0x160c3714, 0x160c360c, 0xf70b170c,
+  0x370c170c, 0x160c360c, 0x1714f60b, 0x1614f50b, 0x170c170c, 0xf60b3714, 0x152c160c, 0xffff5fc7,
+  0xffffffff, 0x375dffdf, 0x160cb413, 0xb3133614, 0xffe7b65c, 0x80000043, 0xffffffff, 0x00000013,
+  0x964cffd7, 0x1614b313, 0x170c170c, 0x3614f60b, 0x160c160c, 0x170cf70b, 0x160c170c, 0x160c3614,
+  0xf60b1614, 0x16141614, 0x170c170c, 0x1614f60b, 0x142cf50b, 0xffff9fcf, 0xffe7ffff, 0xd3233b8e,
+  0x1614f413, 0xb413160c, 0xffe7d65c, 0x80000015, 0xffffffff, 0x00000001, 0xffefffff, 0x8000000f,
+  0xffffffff, 0x00000001, 0xffefffff, 0x80000008, 0xffffffff, 0x00000001, 0xffefffef, 0x80000014,
+  0xffffffff, 0x00000006, 0x9fc7ffef, 0xd4131434, 0x360c160c, 0x360cf50b, 0x160c360c, 0x1714160c,
+  0x80000004, 0x160c160c, 0x00000047, 0x3714f60b, 0x3714f60b, 0xd32bf50b, 0xffefbfd7, 0x596dffdf,
+  0xf513931b, 0xf60bf613, 0xb40b5714, 0xffe7d654, 0xffffffff, 0xffffffff, 0xffff9fe7, 0xbfe7ffff,
+  0xffefbfe7, 0x9fdfffef, 0xffffffff, 0xffe79fdf, 0x9ee7ffef, 0xffffffff, 0xffffffff, 0xffe79fe7,
+  0x7ec77ec7, 0x3dcf5ec7, 0xffefffef, 0xdcbe9fd7, 0xffef7fd7, 0xdfe7ffef, 0xffffffff, 0x7ee7ffff,
+  0xffffffff, 0x9fd7ffef, 0xffffffff, 0xbfdfffff, 0x3ec75ecf, 0xffe79fcf, 0xdfe7ffff, 0x7fb79fc7,
+  0x5dcf5ebf, 0xffffdfef, 0xffefffff, 0x5ebf9fcf, 0x3dcf7ec7, 0xffffbee7, 0xffffbfdf, 0xffffffff,
+  0x7ecfffe7, 0x5fcf3ec7, 0xdfe73ecf, 0xffefffef, 0xfcc63dc7, 0xffe7dfe7, 0x5fc7bfd7, 0x7fc77fc7,
+  0xffdf3dc7, 0x3fc7ffdf, 0x7fc75fc7, 0xffefffef, 0xffe7ffef, 0x1db75ec7, 0xffefbfd7, 0xbfe7ffef,
+  0xffefffef, 0xbfefffff, 0xffffdfef, 0xffefbfe7, 0xdfe7ffef, 0x1ec7fdbe, 0xffefffef, 0xbfdfffef,
+  0x7ecffcb6, 0xffefffef, 0x80000005, 0xffffffff, 0x00000051, 0xffefffff, 0xf4337fbf, 0x150cb413,
+  0x150c3614, 0x1614160c, 0xf60b1614, 0x160c1614, 0xf60bf60b, 0x370c160c, 0x160c360c, 0x160cf60b,
+  0xf60b370c, 0x152cf613, 0xffd7dfc7, 0xb41bf75c, 0x160cf513, 0x3814f613, 0xd513f603, 0xffe7f654,
+  0xffffffff, 0x7de7ffff, 0xdfdfb384, 0x947cffef, 0xffe7f584, 0xd47cbfd7, 0x5ed7ffef, 0xdcb6d053,
+  0x937cffe7, 0xffff3cd7, 0x3ab6dfef, 0xd99dd8a5, 0x577d7364, 0x778d567d, 0x9cb6ffdf, 0x7785b46c,
+  0x3aaeb574, 0xd47cffdf, 0xffff5edf, 0xf584ffef, 0xffeffdd6, 0xd15bdfdf, 0xffef3aae, 0x3585ffef,
+  0x7885d574, 0xb474367d, 0xbcb6bfdf, 0x98755354, 0x55855675, 0xffff3cd7, 0x7edfffff, 0x5775535c,
+  0x1585567d, 0xdccedcc6, 0xffef358d, 0xffffffff, 0x32549bae, 0x167d7885, 0x7ed71585, 0x568dffe7,
+  0x568d1585, 0x3ecf7374, 0x167d5bae, 0xd56c545c, 0x1dbf357d, 0x1775d674, 0x1675787d, 0xffe7d57c,
+  0x578dffe7, 0x77851575, 0xbbb6946c, 0xd47cffe7, 0xffe7f57c, 0x979dffef, 0xfcce7abe, 0xffeff484,
+  0x9574fec6, 0xf57c788d, 0xffe7568d, 0xb56c1ec7, 0xd46c9785, 0xffff979d, 0x80000006, 0xffffffff,
+  0x00000050, 0x7fc7ffef, 0xd41b343c, 0x160cf513, 0x16143614, 0x17141614, 0x160cf60b, 0x370c3714,
+  0xf50b160c, 0x360c160c, 0x370c160c, 0x370c1704, 0x3624d50b, 0xb6443f97, 0xf50bb30b, 0x1614f50b,
+  0xd60b1614, 0xb4131714, 0xffe7b554, 0xffffffff, 0xffffffff, 0x3ebf1585, 0xd574ffd7, 0xffdff67c,
+  0x9785bca6, 0x18a6ffe7, 0x567d1575, 0xd8a5ffe7, 0xffe77695, 0xd57cffe7, 0x98955fcf, 0xffdf9ca6,
+  0xffe7ffe7, 0xb474ffe7, 0xffdffdae, 0x9895dfd7, 0xf474ffdf, 0xffdfdfd7, 0xf574ffd7, 0xffffdcce,
+  0x167df99d, 0xffe73785, 0xf47cffe7, 0xffdf3ec7, 0x567dffdf, 0x7ba65aa6, 0xffd7987d, 0xffefffe7,
+  0xffffffff, 0x5edfffff, 0xffd7d574, 0xffe7ffdf, 0x7bbeffef, 0xffef168d, 0xffffffff, 0xda8d3b9e,
+  0xffe7ffdf, 0xffefffff, 0x367dd995, 0xffffffef, 0x97a55abe, 0xffefffff, 0x7aa67685, 0xffffffff,
+  0xdfcfb56c, 0xffe7ffdf, 0x1fb7946c, 0x167d5c9e, 0xffefffef, 0x53645ecf, 0x7885dfd7, 0xbda6d24b,
+  0x5695ffe7, 0x3dcf7ab6, 0xffe7f584, 0xfdb6946c, 0xffefffef, 0x7fcf3595, 0x3a8e5675, 0xffe7ffdf,
+  0xdfef5695, 0x80000006, 0xffffffff, 0x00000050, 0xffefffff, 0x3865ffd7, 0xb4139323, 0xf613f513,
+  0xf60b1614, 0x160c160c, 0xf60bf70b, 0x1614160c, 0x360c160c, 0xf603360c, 0x170c380c, 0xf6131714,
+  0xf413151c, 0x360c160c, 0x16141614, 0x170c1714, 0xb413f713, 0xffe7d55c, 0xffffffff, 0xffffffff,
+  0x7b9ed895, 0x1a9eddb6, 0x3fbfb98d, 0x9b9e3a96, 0xf474ffdf, 0x3675ffd7, 0xdfdf5ec7, 0xffdfb374,
+  0xf6747fbf, 0x9895ffdf, 0x1a9ed56c, 0x3aaeb89d, 0x9baeffe7, 0x767d7264, 0xffe79bae, 0xb36cffdf,
+  0xd98d367d, 0x735cd985, 0xffef3dcf, 0xffcf1575, 0xddae787d, 0x557dffdf, 0x7ca65685, 0xb5645b9e,
+  0xdcae9fc7, 0x1996735c, 0xf8adb89d, 0xffffffff, 0x7fdfffff, 0xfa8d5364, 0xb99dfa95, 0x9bbebfdf,
+  0xffef168d, 0xffffffff, 0x745c9ca6, 0xb7a5f99d, 0xffe7f8b5, 0xfdb61675, 0xffffffff, 0xffefffef,
+  0xffffffff, 0x7bae5685, 0xffffffff, 0xfa8df574, 0x199e5aa6, 0xdfcfd56c, 0xfdb6176d, 0xffffffff,
+  0x167dffe7, 0x9985deb6, 0xb5645b96, 0xd895ffd7, 0x3dc79bb6, 0x7fc7568d, 0xffdfd564, 0xffffffff,
+  0xffe7ffff, 0xb4641db7, 0x5bb63685, 0xffefffef, 0x80000007, 0xffffffff, 0x0000004f, 0xffe7ffef,
+  0x554c7ca6, 0xd513731b, 0x370c160c, 0x170c170c, 0x170c170c, 0x16141714, 0x160c160c, 0x170c160c,
+  0xf70b170c, 0x3614160c, 0xf60bf60b, 0xd60b170c, 0x16143614, 0x3714160c, 0xd413f60b, 0xffe7d55c,
+  0xffffffff, 0xffffffff, 0xb88dfcbe, 0x3ebfd895, 0xb88dddb6, 0xffcf7785, 0x534c7faf, 0x74649c9e,
+  0xffdf988d, 0x3ebf5685, 0x5b963b96, 0x988dffdf, 0x7ba61675, 0x9abe19ae, 0xffefffef, 0x39a6bed7,
+  0x367d1575, 0xd474ffd7, 0xbcb63aa6, 0x535cdda6, 0x7ec77ecf, 0x5b8e524c, 0x5775f65c, 0x357dffdf,
+  0xd98d367d, 0x1eaff343, 0x5aaeffdf, 0x7aa6b36c, 0x59b65aae, 0xffffffff, 0x7fdfffff, 0x5b9e7364,
+  0x19a67bae, 0xdbbedfdf, 0xffe75685, 0xffefffff, 0xb564bca6, 0x39ae7bae, 0xffe739b6, 0x3ebff674,
+  0xffffffff, 0xffe7ffef, 0xffefffff, 0x7ca65785, 0xffefffff, 0xd97dd46c, 0xf04bb885, 0xffdf7ec7,
+  0xddb6f66c, 0xffffffff, 0x3675ffe7, 0x9885dda6, 0x7ba67fc7, 0x1a8e7875, 0x1ec79cae, 0xbfcf3685,
+  0xffdff56c, 0xffffffff, 0xdfdfffe7, 0xdfdfffef, 0xf57c3aae, 0xdfd7f474, 0x80000008, 0xffffffff,
+  0x0000004f, 0xffdfffef, 0x76447d96, 0xb313b31b, 0xd513b413, 0xf613d513, 0xd51bd61b, 0x1614f513,
+  0x1614f513, 0xf6131614, 0xf5131614, 0x1614f513, 0x161c1614, 0xf51bf513, 0xf50bf513, 0xb31b1614,
+  0xffe7f65c, 0xffffffff, 0xffffffff, 0x157dffe7, 0xffdff57c, 0xb474bfd7, 0xffdf1585, 0xd97d7775,
+  0x7cae9da6, 0xffdf7364, 0x567dddb6, 0xdfcf1675, 0x988dffdf, 0xffdf9ca6, 0xffefffef, 0xf484ffef,
+  0xffdfdfdf, 0x7464ffdf, 0xf57c9fcf, 0xffef7ed7, 0x167dffdf, 0x978d7ecf, 0xdda6777d, 0x745c9d9e,
+  0x357ddfcf, 0xffdffdbe, 0x745cdda6, 0x5aaeffdf, 0xffdf978d, 0xffefffe7, 0xffffffff, 0x5ed7ffff,
+  0xffd7d574, 0xffe7ffdf, 0x9bb6ffef, 0xffdf567d, 0xffe7ffef, 0xb9857b9e, 0xffe7ffe7, 0xffe7ffef,
+  0x5785d995, 0xffffffef, 0xf4849bbe, 0xffefffff, 0x5ba65785, 0xffefffef, 0xffc7d46c, 0x1996ffdf,
+  0xffdff474, 0x578dfa95, 0xffefffef, 0x9364dfd7, 0x5685ffcf, 0xffe7dbbe, 0xf2435775, 0x3ec7feb6,
+  0xffdf157d, 0x5ebf9464, 0xffffffe7, 0xbbbe158d, 0x5fd73695, 0xffe7ffe7, 0x1cbfb36c, 0xffffffef,
+  0x80000008, 0xffffffff, 0x0000004d, 0xffe7ffef, 0xd9853dbf, 0x5444b554, 0x9223d32b, 0x93237323,
+  0xb31b931b, 0x931bb31b, 0x721bb31b, 0x921b921b, 0xb41b931b, 0x931bb31b, 0x92239223, 0xb31b931b,
+  0x5123931b, 0xffe7535c, 0xffffffff, 0xffffffff, 0x3585ffef, 0xffe7f47c, 0x326cffe7, 0xdfe7d9a5,
+  0xffe7936c, 0xffefffef, 0x3a9e1685, 0x526cffe7, 0xffef5695, 0x768dffef, 0x9985b46c, 0x778d7885,
+  0xb8a5bfe7, 0xf9859364, 0x998d1675, 0xb47cffe7, 0xffef5ddf, 0xf584ffe7, 0xd47c9bb6, 0xffefdfe7,
+  0x788dffe7, 0x768d199e, 0xffefbbbe, 0x1585ffe7, 0x9bb619a6, 0xb985335c, 0x56859885, 0xffff1ccf,
+  0x9edfffff, 0x997d535c, 0x1685998d, 0xdcbe7bb6, 0x9885335c, 0x9cb6578d, 0x135c9dae, 0x7785b88d,
+  0x3dc75685, 0xf57cdfdf, 0xb8955785, 0xfcc6736c, 0xffffffff, 0x5aae568d, 0xffefffff, 0x3ec7d47c,
+  0xffffffff, 0x5aa6b374, 0xd584ffe7, 0xf9955785, 0x5aa6b46c, 0xf484ffe7, 0xffefdbce, 0x704bbfd7,
+  0x3dc7bcb6, 0xffe7f47c, 0x536c9cb6, 0x1685d99d, 0xffe7d584, 0x73647cae, 0x567db88d, 0xdfe7568d,
+  0x8000000a, 0xffffffff, 0x0000004c, 0xffefffff, 0xffd7ffe7, 0x3faf9fbf, 0xdfa6ffae, 0xfea6fea6,
+  0xfea61ea7, 0x1fafffa6, 0xfea6fea6, 0xffa61fa7, 0xffa6ff9e, 0xfea6fea6, 0xfea61ea7, 0xdeaedea6,
+  0xffef1dbf, 0xffffffff, 0xffffffff, 0x7edfffff, 0xffef9edf, 0x7edfffef, 0x9fe7bfe7, 0xffff5dd7,
+  0xffffffff, 0x7ecfbfdf, 0x5dd7ffe7, 0xffffbeef, 0xbedfffff, 0xddb6dcbe, 0xddbefdb6, 0xffffbfef,
+  0x7b9e5ec7, 0xffefddbe, 0x5edfffef, 0xffffffff, 0x5edfffff, 0x5ed79fdf, 0xffffffff, 0xbfe7ffff,
+  0x7ed77ed7, 0xffefbee7, 0xdfefffff, 0xffe71ccf, 0xddb6fdbe, 0xdcbeddb6, 0xffff7ddf, 0xffefffff,
+  0xddae3ec7, 0xddbebdb6, 0xdfe73dd7, 0xddb6febe, 0x3ecfbdbe, 0xfebedfdf, 0xdcb6dcb6, 0x9ed7dcb6,
+  0xffefffef, 0x5ba6bcb6, 0xffefbfdf, 0xffffffff, 0xbfe77edf, 0xffffffff, 0xdfe75ed7, 0xffffffff,
+  0x3dcfbedf, 0xffefffff, 0x5ba6fdbe, 0xffef7fcf, 0x5ddfffef, 0xffffbeef, 0x7fd7ffef, 0xdfe7bfe7,
+  0xffe77edf, 0x7fd7ffef, 0x9cb63bae, 0xffefffef, 0x7fc7ffe7, 0xbbb69bae, 0xffffffef, 0x8000000c,
+  0xffffffff, 0x8000000a, 0xffefffef, 0x00000001, 0xffffffef, 0x800001f0, 0xffffffff,
+};
+
+const LCD_3IN49_IMAGE splash_img = {
+  .WIDTH = 172,
+  .HEIGHT = 54,
+  .FORMAT = LCD_3IN49_IMAGE_RLE,
+  .DATA = splash_data,
+};
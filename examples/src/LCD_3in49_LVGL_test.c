@@ -29,63 +29,240 @@
 ******************************************************************************/
 #include "LCD_3IN49.h"
 #include "LCD_test.h"
+#include "ImageData.h"
+#include "boot_prof.h"
+#include "frame_prof.h"
 #include "PCF85063A.h"
 #include "QMI8658.h"
+#include "battery.h"
+#include "motion.h"
 #include "Touch.h"
+#include "touch_indev.h"
+#include "hid_app.h"
+#include "idle.h"
+#include "tusb.h"
 #include "pico/multicore.h"
 #include "qspi_pio.h"
+#include "rp_pico_alloc.h"
+#include "sys_clock.h"
+#include <string.h>
 
 void core1_entry();
 
-int LCD_3IN49_LVGL_Init(void) {
-  if (DEV_Module_Init() != 0) {
-    return -1;
+// Default gesture bindings: face down locks the workstation, shake aborts
+static void gesture_lock_workstation(void) {
+  hid_send_key_combo(KEYBOARD_MODIFIER_LEFTGUI, HID_KEY_L);
+}
+
+// Set once the panel clock is calibrated; clk_sys stays put until then
+static volatile bool m_display_up;
+
+// The flush DMA reads the draw buffers and feeds the frame engine; the PIO
+// dividers change between flushes only
+static bool display_clock_quiet(void) {
+  return m_display_up && !LCD_3IN49_Flush_Busy();
+}
+
+static void display_clock_retime(uint32_t sys_hz) { QSPI_Update_Clock(qspi); }
+
+static void psram_clock_retime(uint32_t sys_hz) { rp_mem_update_timing(); }
+
+static const sys_clock_domain_t m_display_clock = {
+    "display", display_clock_quiet, display_clock_retime};
+static const sys_clock_domain_t m_psram_clock = {"psram", NULL,
+                                                 psram_clock_retime};
+
+// Full clock while LVGL has something to draw
+static void render_boost(void) {
+  lv_disp_t *disp = lv_disp_get_default();
+
+  if ((disp && disp->inv_p) || lv_anim_count_running())
+    sys_clock_boost();
+}
+
+#if STDIO_UART
+// Line commands on the UART console. Read on the LVGL core, since the
+// profiler export has to run on the core that records the spans.
+//   overlay   toggle the frame profiler overlay
+//   dump      frame profiler ring as Chrome trace JSON; blocks the UI for
+//             the few seconds the UART takes to send it
+#define CONSOLE_LINE_MAX 16
+
+static volatile bool m_console_rx;
+static char m_console_line[CONSOLE_LINE_MAX];
+static uint32_t m_console_len;
+static bool m_prof_overlay = FRAME_PROF_OVERLAY;
+
+// From the UART interrupt, which stays off until the input is read
+static void console_rx(void *user) {
+  (void)user;
+  m_console_rx = true;
+  idle_kick();
+}
+
+static void console_exec(const char *line) {
+  if (!strcmp(line, "overlay")) {
+    m_prof_overlay = !m_prof_overlay;
+    LVGL_Profiler_Overlay(m_prof_overlay);
+  } else if (!strcmp(line, "dump")) {
+    LVGL_Profiler_Dump();
+  } else if (line[0]) {
+    printf("commands: overlay, dump\r\n");
   }
+}
 
-  /*PWR*/
-  multicore_launch_core1(core1_entry);
+static void console_task(void) {
+  int c;
 
-  printf("LCD_3IN49_LCGL_test Demo\r\n");
+  if (!m_console_rx)
+    return;
+  m_console_rx = false;
+  while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+    if (c == '\r' || c == '\n') {
+      m_console_line[m_console_len] = '\0';
+      console_exec(m_console_line);
+      m_console_len = 0;
+    } else if (m_console_len < CONSOLE_LINE_MAX - 1) {
+      m_console_line[m_console_len++] = (char)c;
+    }
+  }
+}
+#endif
+
+// Display, touch and LVGL; runs on the core that owns LVGL
+static void display_init(void) {
   /*QSPI PIO Init*/
   QSPI_GPIO_Init(qspi);
   QSPI_PIO_Init(qspi);
   QSPI_4Wrie_Mode(&qspi);
   /*Init LCD*/
   LCD_3IN49_Init();
+  boot_mark(BOOT_PANEL);
+  if (LCD_3IN49_Calibrate_Clock(LCD_3IN49_SCLK_MIN_HZ, LCD_3IN49_SCLK_MAX_HZ,
+                                LCD_3IN49_SCLK_STEP_HZ) == 0) {
+    printf("QSPI calibration failed, SCLK %lu Hz\r\n", QSPI_Get_Clock());
+  } else {
+    printf("QSPI SCLK %lu Hz\r\n", QSPI_Get_Clock());
+  }
+  m_display_up = true;
+  boot_mark(BOOT_PANEL_CLOCK);
+  // The splash goes from flash straight to the panel, and the backlight
+  // comes on with it rather than over whatever panel RAM held
+  LCD_3IN49_Splash(&splash_img, SPLASH_BG);
   DEV_SET_PWM(60);
-  LCD_3IN49_Clear(WHITE);
-  /*Init RTC*/
-  PCF85063A_Init();
-  /*Init IMU*/
-  QMI8658_init();
+  boot_mark(BOOT_SPLASH);
   /*Init LVGL*/
   LVGL_Init();
   Widgets_Init();
+#if FRAME_PROF_OVERLAY
+  LVGL_Profiler_Overlay(true);
+#endif
+#if STDIO_UART
+  // The RX interrupt goes to this core, so input wakes the LVGL loop
+  stdio_set_chars_available_callback(console_rx, NULL);
+#endif
+  boot_mark(BOOT_LVGL);
+}
+
+int LCD_3IN49_LVGL_Init(void) {
+  if (DEV_Module_Init() != 0) {
+    return -1;
+  }
+  boot_mark(BOOT_DEV_INIT);
+
+  printf("LCD_3IN49_LCGL_test Demo\r\n");
+  sys_clock_register(&m_display_clock);
+  sys_clock_register(&m_psram_clock);
+#if LVGL_ON_CORE1
+  // Shared state core1 reads during bring-up is built here first. PSRAM
+  // setup takes the QMI out of XIP mode, so it must not run while this core
+  // is executing from flash.
+  hid_app_init();
+  rp_mem_init();
+  /*PWR, display*/
+  multicore_launch_core1(core1_entry);
+#else
+  /*PWR*/
+  multicore_launch_core1(core1_entry);
+  display_init();
+#endif
+  /*Init RTC*/
+  PCF85063A_Init();
+  /*Battery ADC*/
+  battery_init();
+  /*Init IMU*/
+  if (QMI8658_init()) {
+    if (motion_init()) {
+      motion_set_gesture_action(MOTION_GESTURE_FLIP, gesture_lock_workstation);
+      motion_set_gesture_action(MOTION_GESTURE_SHAKE, hid_cancel_macro);
+    }
+  }
+  boot_mark(BOOT_PERIPHERALS);
 
   return 0;
 }
 
 void LCD_3IN49_LVGL_Task(void) {
-  lv_task_handler();
+#if STDIO_UART
+  console_task();
+#endif
+  LVGL_UI_Poll();
+  render_boost();
+  LVGL_Frame_Pacer();
+  touch_indev_poll();
+  uint32_t t0 = prof_now();
+  uint32_t next_ms = lv_task_handler();
+  uint32_t t1 = prof_now();
+  if (t1 - t0 >= FRAME_PROF_HANDLER_MIN_US)
+    prof_record(PROF_TIMER_HANDLER, t0, 0);
+  // Input read in the handler may have left a frame for the next pass
+  render_boost();
+  // Sleep until LVGL's next timer; with nothing animating or dirty, and the
+  // touch timer stopped, that is none, and only an interrupt wakes the loop
+  if (next_ms != LV_NO_TIMER_READY)
+    idle_wake_at(t1 + next_ms * 1000);
   // DEV_Delay_ms(5); // Blocking delay removed/reduced for USB performance, or
   // use non-blocking status check if possible. Small delay is fine if USB task
   // runs frequently enough. Ideally we shouldn't block, but lv_task_handler
   // takes time anyway.
 }
 
-void core1_entry() {
+// Power button, sampled every 5 ms
+static void power_button_task(void) {
   static int press_time = 0;
-  while (1) {
-    DEV_Delay_ms(5);
-    if (DEV_Digital_Read(SYS_OUT) == 0) {
-      press_time++;
-      if (press_time > 300) // shutdown
-      {
-        press_time = 0;
-        DEV_Digital_Write(SYS_EN, 0);
-      }
-    } else {
+  static uint32_t last_ms = 0;
+  uint32_t now = to_ms_since_boot(get_absolute_time());
+
+  if (now - last_ms >= 5) {
+    last_ms = now;
+    press_time = DEV_Digital_Read(SYS_OUT) == 0 ? press_time + 1 : 0;
+    if (press_time > 300) // shutdown
+    {
       press_time = 0;
+      DEV_Digital_Write(SYS_EN, 0);
     }
   }
+  // Sampled on while held; a new press comes in on the pin interrupt
+  if (press_time || DEV_Digital_Read(SYS_OUT) == 0)
+    idle_wake_at((last_ms + 5) * 1000u);
+}
+
+void core1_entry() {
+  // Parked by core0 for the length of a clk_sys change
+  multicore_lockout_victim_init();
+#if LVGL_ON_CORE1
+  display_init();
+  // A press wakes the loop; the callback registered above ignores the pin
+  gpio_set_irq_enabled(SYS_OUT, GPIO_IRQ_EDGE_FALL, true);
+  while (1) {
+    LCD_3IN49_LVGL_Task();
+    power_button_task();
+    idle_sleep();
+  }
+#else
+  while (1) {
+    DEV_Delay_ms(5);
+    power_button_task();
+  }
+#endif
 }
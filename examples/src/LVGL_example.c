@@ -1,4 +1,6 @@
 #include "hid_app.h"
+#include "hid_cmd.h"
+#include "hardware/sync.h"
 #include "pico/multicore.h"
 #include "pico/stdlib.h"
 #include "psram_tool.h"
@@ -10,33 +12,19 @@
 #include "DEV_Config.h"
 #include "LCD_3IN49.h"
 #include "Touch.h"
+#include "disp_drv.h"
 #include "lvgl.h"
 #include "qspi_pio.h"
+#include "touch_indev.h"
+#include "ui_bridge.h"
+#include "LVGL_example.h"
 
-#define DISP_HOR_RES 172
-#define DISP_VER_RES 640
-
-// LVGL
-static lv_disp_drv_t disp_drv;
-static lv_disp_draw_buf_t disp_buf;
-static lv_color_t *buf0;
-
-// Touch
-static uint16_t ts_x;
-static uint16_t ts_y;
-static lv_indev_state_t ts_act;
-static lv_indev_drv_t indev_ts;
-
-// Timer
-static struct repeating_timer lvgl_timer;
+// Widgets updated from bridge events
+static lv_obj_t *ui_title;
+static lv_obj_t *ui_battery;
 
 // Forward declarations
-static void disp_flush_cb(lv_disp_drv_t *disp, const lv_area_t *area,
-                          lv_color_t *color_p);
 static void touch_callback(uint gpio, uint32_t events);
-static void ts_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data);
-static void dma_handler(void);
-static bool repeating_lvgl_timer_callback(struct repeating_timer *t);
 
 void event_handler(lv_event_t *e) {
   lv_event_code_t code = lv_event_get_code(e);
@@ -51,25 +39,25 @@ void event_handler(lv_event_t *e) {
     if (id[0] == 'M' && id[1] >= '0' && id[1] <= '9') {
       // Extract macro index from ID (e.g., "M0" -> 0, "M1" -> 1)
       uint8_t macro_index = id[1] - '0';
-      hid_run_macro_by_index(macro_index);
+      hid_post_macro(macro_index);
     } else if (strcmp(id, "LC") == 0) {
-      hid_mouse_click(1); // Left click
+      hid_post_mouse_click(1); // Left click
     } else if (strcmp(id, "RC") == 0) {
-      hid_mouse_click(2); // Right click
+      hid_post_mouse_click(2); // Right click
     }
   } else if (code == LV_EVENT_PRESSED) {
     if (strcmp(id, "UP") == 0)
-      hid_set_mouse_velocity(0, -5);
+      hid_post_mouse_velocity(0, -5);
     else if (strcmp(id, "DN") == 0)
-      hid_set_mouse_velocity(0, 5);
+      hid_post_mouse_velocity(0, 5);
     else if (strcmp(id, "LT") == 0)
-      hid_set_mouse_velocity(-5, 0);
+      hid_post_mouse_velocity(-5, 0);
     else if (strcmp(id, "RT") == 0)
-      hid_set_mouse_velocity(5, 0);
+      hid_post_mouse_velocity(5, 0);
   } else if (code == LV_EVENT_RELEASED || code == LV_EVENT_PRESS_LOST) {
     if (strcmp(id, "UP") == 0 || strcmp(id, "DN") == 0 ||
         strcmp(id, "LT") == 0 || strcmp(id, "RT") == 0) {
-      hid_set_mouse_velocity(0, 0);
+      hid_post_mouse_velocity(0, 0);
     }
   }
 }
@@ -80,9 +68,14 @@ void Widgets_Init(void) {
   lv_obj_t *btn;
 
   // Title
-  lv_obj_t *title = lv_label_create(lv_scr_act());
-  lv_label_set_text(title, "HID Control");
-  lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+  ui_title = lv_label_create(lv_scr_act());
+  lv_label_set_text(ui_title, "HID Control");
+  lv_obj_align(ui_title, LV_ALIGN_TOP_MID, 0, 10);
+
+  // Battery, filled in by the first bridge event
+  ui_battery = lv_label_create(lv_scr_act());
+  lv_label_set_text(ui_battery, "");
+  lv_obj_align(ui_battery, LV_ALIGN_TOP_MID, 0, 30);
 
   // Mouse D-Pad - Compact vertical (172px wide screen)
   btn = lv_btn_create(lv_scr_act());
@@ -164,77 +157,49 @@ void Widgets_Init(void) {
   }
 }
 
-static void disp_flush_cb(lv_disp_drv_t *disp, const lv_area_t *area,
-                          lv_color_t *color_p) {
-  LCD_3IN49_SetWindows(area->x1, area->y1, area->x2 + 1, area->y2 + 1);
-  QSPI_Select(qspi);
-  QSPI_Pixel_Write(qspi, 0x2c);
-
-  dma_channel_configure(
-      dma_tx, &c, &qspi.pio->txf[qspi.sm], color_p,
-      ((area->x2 + 1 - area->x1) * (area->y2 + 1 - area->y1)) * 2, true);
-}
-
 static void touch_callback(uint gpio, uint32_t events) {
   if (gpio == TOUCH_INT_PIN) {
-    Touch_Read_State();
-    ts_x = TOUCH.Point1_x;
-    ts_y = TOUCH.Point1_y;
-    ts_act = LV_INDEV_STATE_PRESSED;
+    // Only queue the bus read here; the report lands in TOUCH_RING
+    Touch_Read_Async(NULL);
   }
 }
 
-static void ts_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data) {
-  data->point.x = ts_x;
-  data->point.y = ts_y;
-  data->state = ts_act;
-  ts_act = LV_INDEV_STATE_RELEASED;
-}
-
-static void dma_handler(void) {
-  if (dma_channel_get_irq0_status(dma_tx)) {
-    dma_channel_acknowledge_irq0(dma_tx);
-    QSPI_Deselect(qspi);
-    lv_disp_flush_ready(&disp_drv);
+void LVGL_UI_Poll(void) {
+  ui_event_t ev;
+
+  while (ui_bridge_poll(&ev)) {
+    if (ev.type == UI_EVENT_USB_STATE && ui_title) {
+      lv_label_set_text(ui_title, ev.value == UI_USB_MOUNTED     ? "HID Control"
+                                  : ev.value == UI_USB_SUSPENDED ? "USB Suspended"
+                                                                 : "No USB Host");
+      lv_obj_align(ui_title, LV_ALIGN_TOP_MID, 0, 10);
+    } else if (ev.type == UI_EVENT_BATTERY && ui_battery) {
+      lv_label_set_text_fmt(ui_battery, "%s %u%%",
+                            ev.value > 80   ? LV_SYMBOL_BATTERY_FULL
+                            : ev.value > 55 ? LV_SYMBOL_BATTERY_3
+                            : ev.value > 30 ? LV_SYMBOL_BATTERY_2
+                            : ev.value > 10 ? LV_SYMBOL_BATTERY_1
+                                            : LV_SYMBOL_BATTERY_EMPTY,
+                            ev.value);
+      lv_obj_align(ui_battery, LV_ALIGN_TOP_MID, 0, 30);
+    }
   }
 }
 
-static bool repeating_lvgl_timer_callback(struct repeating_timer *t) {
-  lv_tick_inc(5);
-  return true;
-}
-
 void LVGL_Init(void) {
-  // 1. Init Timer for LVGL tick
-  add_repeating_timer_ms(5, repeating_lvgl_timer_callback, NULL, &lvgl_timer);
-
-  // 2. Init LVGL core
+  // 1. Init LVGL core; its tick is read from the system timer
+  // (LV_TICK_CUSTOM), so no periodic interrupt keeps the loop awake
   lv_init();
 
-  // 3. Init LVGL display
-  buf0 = (lv_color_t *)malloc(DISP_HOR_RES * DISP_VER_RES * sizeof(lv_color_t));
-  lv_disp_draw_buf_init(&disp_buf, buf0, NULL, DISP_HOR_RES * DISP_VER_RES);
-  lv_disp_drv_init(&disp_drv);
-  disp_drv.flush_cb = disp_flush_cb;
-  disp_drv.draw_buf = &disp_buf;
-  disp_drv.hor_res = DISP_HOR_RES;
-  disp_drv.ver_res = DISP_VER_RES;
-  disp_drv.full_refresh = 1;
-  disp_drv.direct_mode = 0;
-  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
-
-  // 4. Init touch screen as input device
-  lv_indev_drv_init(&indev_ts);
-  indev_ts.type = LV_INDEV_TYPE_POINTER;
-  indev_ts.read_cb = ts_read_cb;
-  lv_indev_t *ts_indev = lv_indev_drv_register(&indev_ts);
+  // 2. Init LVGL display
+  disp_drv_init();
+
+  // 3. Init touch screen as input device, in the display's orientation
+  Touch_Init();
+  Touch_Set_Scan_Dir(LCD_3IN49.SCAN_DIR);
+  touch_indev_init();
 
   // Enable touch IRQ
   DEV_KEY_Config(TOUCH_INT_PIN);
   DEV_IRQ_SET(TOUCH_INT_PIN, GPIO_IRQ_EDGE_FALL, &touch_callback);
-
-  // 5. Init DMA for transmit color data from memory to SPI
-  dma_channel_set_irq0_enabled(dma_tx, true);
-  irq_set_exclusive_handler(DMA_IRQ_0, dma_handler);
-  irq_set_enabled(DMA_IRQ_0, true);
 }
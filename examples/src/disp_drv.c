@@ -0,0 +1,511 @@
+#include "disp_drv.h"
+#include "LCD_3IN49.h"
+#include "boot_prof.h"
+#include "frame_prof.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include "rp_pico_alloc.h"
+#include <stdio.h>
+#include <string.h>
+
+// The display DMA sends buffer bytes in memory order, which is only the
+// panel's big-endian RGB565 when LVGL stores colors swapped
+#if LV_COLOR_DEPTH != 16 || !LV_COLOR_16_SWAP
+#error "LCD_3IN49 flush expects LV_COLOR_DEPTH 16 with LV_COLOR_16_SWAP"
+#endif
+
+// The SH8601 takes column/row windows in pairs: start even, end odd. Even
+// areas are also a whole number of 32-bit words, as the flush DMA requires.
+#define DISP_ALIGN 2
+
+// Partial draw buffer. LVGL renders each dirty area into it separately, so
+// it only has to hold the largest area worth flushing in one go. Sized in
+// portrait lines; in landscape the same pixels hold fewer, longer lines.
+#define DISP_BUF_LINES 128
+
+// LVGL
+static lv_disp_drv_t disp_drv;
+static lv_disp_draw_buf_t disp_buf;
+static lv_color_t *buf0;
+static lv_color_t *buf1;
+
+// Flush accounting
+static lvgl_flush_stats_t flush_stats;
+static uint32_t flush_frame_start_us;
+static uint32_t flush_frame_bytes;
+static volatile bool flush_last;
+
+// Frame pacing: with TE running, LVGL's refresh timer is paused and a frame
+// is rendered once per panel vsync instead
+static volatile bool disp_vsync_pending;
+static bool disp_paced;
+
+// Hardware scroll: the object whose rows are the panel's scroll area, and
+// the offset for the next refresh
+static lv_obj_t *hw_scroll_obj;
+static lv_area_t hw_scroll_area;
+static uint32_t hw_scroll_offset;
+static lv_coord_t hw_scroll_carry;
+static lv_area_t hw_scroll_thumb; // scrollbar as last drawn
+
+// Image overlays (LVGL_Image_Overlay_Create), and those the area being
+// flushed touches, queued with their position to follow it to the panel
+#define DISP_OVERLAYS 4
+static lv_obj_t *overlay_obj[DISP_OVERLAYS];
+static const LCD_3IN49_IMAGE *overlay_img[DISP_OVERLAYS];
+typedef struct {
+  UWORD x, y;
+  const LCD_3IN49_IMAGE *img;
+} disp_overlay_t;
+static disp_overlay_t overlay_queue[DISP_OVERLAYS];
+static volatile uint8_t overlay_queued;
+static uint8_t overlay_sent;
+
+// Profiler stage marks; a draw area runs from the refresh start or the
+// previous flush_cb up to its own flush_cb, minus any wait for a buffer
+static uint32_t prof_refr_start_us;
+static uint32_t prof_area_start_us;
+static uint32_t prof_wait_start_us;
+static uint32_t prof_flush_start_us;
+static lv_obj_t *prof_label;
+static lv_timer_t *prof_timer;
+
+// Forward declarations
+static void disp_flush_done(void *user);
+
+static void disp_rounder_cb(lv_disp_drv_t *disp, lv_area_t *area) {
+  // Widen to the controller's pixel pairs; the extra line or column is
+  // redrawn from the same buffer, so nothing stale reaches the panel
+  area->x1 &= ~(DISP_ALIGN - 1);
+  area->y1 &= ~(DISP_ALIGN - 1);
+  area->x2 |= DISP_ALIGN - 1;
+  area->y2 |= DISP_ALIGN - 1;
+  if (area->x2 >= disp->hor_res)
+    area->x2 = disp->hor_res - 1;
+  if (area->y2 >= disp->ver_res)
+    area->y2 = disp->ver_res - 1;
+}
+
+// Queues the overlays an area touches. Only an overlay shown whole and at
+// an even position is sent; LVGL's own pixels stand in for any other.
+static void overlay_queue_area(const lv_area_t *area) {
+  lv_area_t a, tmp;
+
+  overlay_queued = overlay_sent = 0;
+  for (int i = 0; i < DISP_OVERLAYS; i++) {
+    lv_obj_t *obj = overlay_obj[i];
+    if (!obj || !_lv_area_intersect(&tmp, area, &obj->coords))
+      continue;
+    a = obj->coords;
+    if (!lv_obj_area_is_visible(obj, &a) ||
+        !_lv_area_is_in(&obj->coords, &a, 0) || a.x1 % DISP_ALIGN ||
+        a.y1 % DISP_ALIGN)
+      continue;
+    overlay_queue[overlay_queued].x = a.x1;
+    overlay_queue[overlay_queued].y = a.y1;
+    overlay_queue[overlay_queued].img = overlay_img[i];
+    overlay_queued++;
+  }
+}
+
+static void disp_flush_cb(lv_disp_drv_t *disp, const lv_area_t *area,
+                          lv_color_t *color_p) {
+  uint32_t px = lv_area_get_size(area);
+  uint32_t bytes = px * sizeof(lv_color_t);
+  uint32_t now = prof_now();
+
+  if (!prof_frame_open())
+    prof_frame_begin(prof_refr_start_us);
+  if (prof_wait_start_us) {
+    prof_span(PROF_DRAW_AREA, prof_area_start_us, prof_wait_start_us, px);
+    prof_span(PROF_DMA_WAIT, prof_wait_start_us, now, 0);
+    prof_wait_start_us = 0;
+  } else {
+    prof_span(PROF_DRAW_AREA, prof_area_start_us, now, px);
+  }
+  prof_flush_start_us = now;
+
+  if (flush_frame_bytes == 0) {
+    flush_frame_start_us = time_us_32();
+    // A frame starts going out on a vsync, so it never races the scan
+    LCD_3IN49_Flush_Sync_Next();
+  }
+  flush_frame_bytes += bytes;
+  flush_stats.flushes++;
+  flush_stats.bytes += bytes;
+  flush_last = lv_disp_flush_is_last(disp);
+  overlay_queue_area(area);
+
+  // Window commands and pixels go out as one chained DMA; disp_flush_done
+  // runs from the DMA interrupt once color_p has been consumed
+  LCD_3IN49_Flush_Async(area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_p,
+                        disp_flush_done, disp);
+  prof_area_start_us = prof_now();
+}
+
+static void disp_flush_done(void *user) {
+  // Each overlay the area touched goes out after it, straight from flash,
+  // before LVGL gets the buffer back
+  if (overlay_sent < overlay_queued) {
+    const disp_overlay_t *o = &overlay_queue[overlay_sent++];
+    LCD_3IN49_Image_Async(o->x, o->y, o->img, disp_flush_done, user);
+    return;
+  }
+  prof_record(PROF_FLUSH, prof_flush_start_us, 0);
+  if (flush_last) {
+    uint32_t us = time_us_32() - flush_frame_start_us;
+    flush_stats.frames++;
+    flush_stats.frame_bytes = flush_frame_bytes;
+    if (flush_frame_bytes > flush_stats.frame_bytes_max)
+      flush_stats.frame_bytes_max = flush_frame_bytes;
+    flush_stats.frame_us = us;
+    if (us > flush_stats.frame_us_max)
+      flush_stats.frame_us_max = us;
+    flush_frame_bytes = 0;
+    prof_frame_end();
+    if (!boot_phase_done(BOOT_FIRST_FRAME))
+      boot_mark(BOOT_FIRST_FRAME);
+  }
+  lv_disp_flush_ready((lv_disp_drv_t *)user);
+}
+
+static void disp_vsync(void *user) {
+  (void)user;
+  disp_vsync_pending = true;
+}
+
+static void disp_refr_timer(lv_timer_t *t) {
+  // Stands in for LVGL's own refresh timer callback to time each run
+  prof_refr_start_us = prof_area_start_us = prof_now();
+  // Shift the panel together with the frame that fills in the exposed rows
+  if (hw_scroll_obj && LCD_3IN49_GetScrollStart() != hw_scroll_offset)
+    LCD_3IN49_SetScrollStart(hw_scroll_offset);
+  _lv_disp_refr_timer(t);
+  prof_record(PROF_REFRESH, prof_refr_start_us, 0);
+}
+
+// Whether anything drawn in the scroll object's rows would not move with it
+static bool hw_scroll_covered(lv_obj_t *obj) {
+  const lv_area_t *a = &hw_scroll_area;
+  lv_area_t tmp;
+
+  for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+    if (lv_obj_has_flag(lv_obj_get_child(obj, i), LV_OBJ_FLAG_FLOATING))
+      return true;
+  }
+  // Later siblings of the object and of each ancestor are drawn on top
+  for (lv_obj_t *o = obj, *parent; (parent = lv_obj_get_parent(o)); o = parent) {
+    for (uint32_t i = lv_obj_get_index(o) + 1; i < lv_obj_get_child_cnt(parent);
+         i++) {
+      if (_lv_area_intersect(&tmp, a, &lv_obj_get_child(parent, i)->coords))
+        return true;
+    }
+  }
+  lv_obj_t *layers[] = {lv_layer_top(), lv_layer_sys()};
+  for (int l = 0; l < 2; l++) {
+    for (uint32_t i = 0; i < lv_obj_get_child_cnt(layers[l]); i++) {
+      if (_lv_area_intersect(&tmp, a, &lv_obj_get_child(layers[l], i)->coords))
+        return true;
+    }
+  }
+  return false;
+}
+
+// Whether the panel can take a shift of the object's content
+static bool hw_scroll_possible(lv_obj_t *obj, lv_coord_t shift) {
+  const lv_area_t *a = &hw_scroll_area;
+  lv_disp_t *disp = lv_obj_get_disp(obj);
+  lv_area_t hor, ver;
+
+  if (LCD_3IN49.SCAN_DIR != VERTICAL || memcmp(a, &obj->coords, sizeof(*a)) ||
+      LV_ABS(shift) >= lv_area_get_height(a))
+    return false;
+  // Only a plain background looks the same shifted
+  if (lv_obj_get_style_bg_grad_dir(obj, LV_PART_MAIN) != LV_GRAD_DIR_NONE ||
+      lv_obj_get_style_bg_img_src(obj, LV_PART_MAIN))
+    return false;
+  lv_obj_get_scrollbar_area(obj, &hor, &ver);
+  if (lv_area_get_width(&hor) > 0)
+    return false;
+  // Pending redraws inside the object have to move with it
+  for (uint16_t i = 0; i < disp->inv_p; i++) {
+    const lv_area_t *inv = &disp->inv_areas[i];
+    if (inv->y2 >= a->y1 && inv->y1 <= a->y2 &&
+        (inv->y1 < a->y1 || inv->y2 > a->y2))
+      return false;
+  }
+  return !hw_scroll_covered(obj);
+}
+
+static bool disp_scroll_cb(lv_disp_drv_t *drv, lv_obj_t *obj, lv_coord_t dy) {
+  const lv_area_t *a = &hw_scroll_area;
+  lv_disp_t *disp = lv_obj_get_disp(obj);
+  lv_area_t strip, hor, thumb;
+
+  (void)drv;
+  if (obj != hw_scroll_obj)
+    return false;
+
+  // Panel rows go in pairs, so the shift has to be even: the odd pixel is
+  // taken back now and carried into the next step
+  lv_coord_t want = dy + hw_scroll_carry;
+  lv_coord_t shift = want - want % 2;
+  if (!hw_scroll_possible(obj, shift)) {
+    hw_scroll_carry = 0;
+    flush_stats.scrolls_redrawn++;
+    lv_obj_get_scrollbar_area(obj, &hor, &hw_scroll_thumb);
+    return false;
+  }
+  hw_scroll_carry = want - shift;
+  if (shift != dy) {
+    lv_obj_move_children_by(obj, 0, shift - dy, true);
+    obj->spec_attr->scroll.y += shift - dy;
+  }
+  if (shift == 0)
+    return true;
+  flush_stats.scrolls_hw++;
+
+  // Content moving down by shift means the ring starts shift rows earlier
+  lv_coord_t h = lv_area_get_height(a);
+  hw_scroll_offset = (hw_scroll_offset + h - shift) % h;
+  for (uint16_t i = 0; i < disp->inv_p;) {
+    lv_area_t *inv = &disp->inv_areas[i];
+    if (inv->y1 >= a->y1 && inv->y2 <= a->y2) {
+      inv->y1 = LV_MAX(inv->y1 + shift, a->y1);
+      inv->y2 = LV_MIN(inv->y2 + shift, a->y2);
+      if (inv->y1 > inv->y2) {
+        // Scrolled out of view
+        disp->inv_areas[i] = disp->inv_areas[--disp->inv_p];
+        continue;
+      }
+    }
+    i++;
+  }
+
+  // The rows brought in at one end, plus the border and corners, which
+  // don't move with the content, at both ends
+  lv_coord_t edge = lv_obj_get_style_border_width(obj, LV_PART_MAIN) +
+                    lv_obj_get_style_radius(obj, LV_PART_MAIN);
+  lv_coord_t top = shift > 0 ? shift + edge : edge;
+  lv_coord_t bottom = shift < 0 ? edge - shift : edge;
+  strip = *a;
+  if (top > 0) {
+    strip.y2 = a->y1 + top - 1;
+    lv_obj_invalidate_area(obj, &strip);
+  }
+  if (bottom > 0) {
+    strip.y1 = a->y2 - bottom + 1;
+    strip.y2 = a->y2;
+    lv_obj_invalidate_area(obj, &strip);
+  }
+  // The scrollbar doesn't move with the content: clear the copy the panel
+  // shifted and draw it where it is now
+  lv_obj_get_scrollbar_area(obj, &hor, &thumb);
+  if (lv_area_get_width(&hw_scroll_thumb) > 0) {
+    lv_area_move(&hw_scroll_thumb, 0, shift);
+    lv_obj_invalidate_area(obj, &hw_scroll_thumb);
+  }
+  if (lv_area_get_width(&thumb) > 0)
+    lv_obj_invalidate_area(obj, &thumb);
+  hw_scroll_thumb = thumb;
+  return true;
+}
+
+static void disp_wait_cb(lv_disp_drv_t *disp) {
+  (void)disp;
+  if (!prof_wait_start_us)
+    prof_wait_start_us = prof_now();
+  // LVGL spins here while both buffers are queued; don't let a held flush
+  // outlive the TE line
+  LCD_3IN49_TE_Poll();
+}
+
+void LVGL_Frame_Pacer(void) {
+  lv_disp_t *disp = lv_disp_get_default();
+
+  if (!disp)
+    return;
+  if (!LCD_3IN49_TE_Active()) {
+    if (disp_paced) {
+      lv_timer_resume(disp->refr_timer);
+      disp_paced = false;
+    }
+    return;
+  }
+  if (!disp_paced) {
+    lv_timer_pause(disp->refr_timer);
+    disp_vsync_pending = false;
+    disp_paced = true;
+  }
+  if (disp_vsync_pending) {
+    disp_vsync_pending = false;
+    // Steps animations and redraws what changed, once per displayed frame.
+    // Same as lv_refr_now(), but through the profiled refresh callback
+    lv_anim_refr_now();
+    disp_refr_timer(disp->refr_timer);
+  }
+}
+
+static void hw_scroll_delete_cb(lv_event_t *e) {
+  (void)e;
+  LCD_3IN49_SetScrollArea(0, 0);
+  hw_scroll_obj = NULL;
+}
+
+static void overlay_delete_cb(lv_event_t *e) {
+  lv_obj_t *obj = lv_event_get_target(e);
+
+  for (int i = 0; i < DISP_OVERLAYS; i++) {
+    if (overlay_obj[i] == obj)
+      overlay_obj[i] = NULL;
+  }
+}
+
+lv_obj_t *LVGL_Image_Overlay_Create(lv_obj_t *parent,
+                                    const LCD_3IN49_IMAGE *img) {
+  int i = 0;
+
+  while (i < DISP_OVERLAYS && overlay_obj[i])
+    i++;
+  if (i == DISP_OVERLAYS || img->WIDTH % DISP_ALIGN || img->HEIGHT % DISP_ALIGN)
+    return NULL;
+
+  // A bare object holds the place; the panel gets the image itself
+  lv_obj_t *obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_size(obj, img->WIDTH, img->HEIGHT);
+  lv_obj_add_event_cb(obj, overlay_delete_cb, LV_EVENT_DELETE, NULL);
+  overlay_img[i] = img;
+  overlay_obj[i] = obj;
+  return obj;
+}
+
+bool LVGL_HW_Scroll_Attach(lv_obj_t *obj) {
+  if (hw_scroll_obj) {
+    // Panel memory is rotated by the offset; redraw it straight
+    lv_obj_remove_event_cb(hw_scroll_obj, hw_scroll_delete_cb);
+    LCD_3IN49_SetScrollArea(0, 0);
+    lv_obj_invalidate(hw_scroll_obj);
+    hw_scroll_obj = NULL;
+  }
+  if (!obj)
+    return true;
+
+  lv_obj_update_layout(obj);
+  const lv_area_t *a = &obj->coords;
+  lv_disp_t *disp = lv_obj_get_disp(obj);
+  if (LCD_3IN49.SCAN_DIR != VERTICAL || a->x1 > 0 ||
+      a->x2 < lv_disp_get_hor_res(disp) - 1 || a->y1 < 0 ||
+      a->y2 >= lv_disp_get_ver_res(disp) || a->y1 % DISP_ALIGN ||
+      (a->y2 + 1) % DISP_ALIGN)
+    return false;
+
+  LCD_3IN49_SetScrollArea(a->y1, lv_area_get_height(a));
+  hw_scroll_obj = obj;
+  hw_scroll_area = *a;
+  hw_scroll_offset = 0;
+  hw_scroll_carry = 0;
+  lv_area_t hor;
+  lv_obj_get_scrollbar_area(obj, &hor, &hw_scroll_thumb);
+  lv_obj_add_event_cb(obj, hw_scroll_delete_cb, LV_EVENT_DELETE, NULL);
+  return true;
+}
+
+void LVGL_Get_Flush_Stats(lvgl_flush_stats_t *stats) {
+  uint32_t save = save_and_disable_interrupts();
+  *stats = flush_stats;
+  restore_interrupts(save);
+}
+
+void LVGL_Reset_Flush_Stats(void) {
+  uint32_t save = save_and_disable_interrupts();
+  memset(&flush_stats, 0, sizeof(flush_stats));
+  restore_interrupts(save);
+}
+
+static void prof_overlay_update(lv_timer_t *t) {
+  prof_frame_t f;
+
+  (void)t;
+  prof_last_frame(&f);
+  // Frame time, then render / buffer wait / DMA flush and idle before it
+  lv_label_set_text_fmt(prof_label,
+                        "F%lu.%lu R%lu.%lu W%lu.%lu\nX%lu.%lu I%lu.%lu A%u",
+                        f.frame_us / 1000, f.frame_us / 100 % 10,
+                        f.stage_us[PROF_DRAW_AREA] / 1000,
+                        f.stage_us[PROF_DRAW_AREA] / 100 % 10,
+                        f.stage_us[PROF_DMA_WAIT] / 1000,
+                        f.stage_us[PROF_DMA_WAIT] / 100 % 10,
+                        f.stage_us[PROF_FLUSH] / 1000,
+                        f.stage_us[PROF_FLUSH] / 100 % 10, f.idle_us / 1000,
+                        f.idle_us / 100 % 10, f.areas);
+}
+
+void LVGL_Profiler_Overlay(bool on) {
+  if (on && !prof_label) {
+    // On the system layer so it stays above screen changes
+    prof_label = lv_label_create(lv_layer_sys());
+    lv_obj_set_style_text_font(prof_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_bg_color(prof_label, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(prof_label, LV_OPA_70, 0);
+    lv_obj_set_style_text_color(prof_label, lv_color_white(), 0);
+    lv_obj_align(prof_label, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_label_set_text(prof_label, "");
+    prof_timer = lv_timer_create(prof_overlay_update, 500, NULL);
+  } else if (!on && prof_label) {
+    lv_timer_del(prof_timer);
+    lv_obj_del(prof_label);
+    prof_timer = NULL;
+    prof_label = NULL;
+  }
+}
+
+static void prof_write_stdout(const char *s, size_t len, void *user) {
+  (void)user;
+  fwrite(s, 1, len, stdout);
+}
+
+void LVGL_Profiler_Dump(void) {
+  prof_export_chrome(prof_write_stdout, NULL);
+  fflush(stdout);
+}
+
+lv_disp_t *disp_drv_init(void) {
+  // Only the invalidated areas are redrawn and sent; a button highlight is
+  // a few KB instead of the whole 220 KB frame.
+  // With two buffers LVGL renders the next area into one while the DMA
+  // streams the other. Both are drawn into on every frame and read by the
+  // DMA, so both want SRAM; if the pool can't take the second it goes to
+  // PSRAM, which the DMA reads through the XIP cache, so CPU writes are
+  // still visible to it.
+  // LVGL only calls flush_cb once the previous flush has been acknowledged
+  // from disp_flush_done, so a buffer is never redrawn while it is on the bus.
+  const size_t buf_px = LCD_3IN49_WIDTH * DISP_BUF_LINES;
+  buf0 = (lv_color_t *)rp_mem_malloc_hint(buf_px * sizeof(lv_color_t),
+                                          RP_MEM_DMA);
+  if (!buf0)
+    buf0 = (lv_color_t *)malloc(buf_px * sizeof(lv_color_t));
+  buf1 = (lv_color_t *)rp_mem_malloc_hint(buf_px * sizeof(lv_color_t),
+                                          RP_MEM_DMA);
+  if (!buf1)
+    buf1 = (lv_color_t *)rp_mem_malloc_hint(buf_px * sizeof(lv_color_t),
+                                            RP_MEM_BULK);
+  lv_disp_draw_buf_init(&disp_buf, buf0, buf1, buf_px);
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.flush_cb = disp_flush_cb;
+  disp_drv.rounder_cb = disp_rounder_cb;
+  disp_drv.wait_cb = disp_wait_cb;
+  disp_drv.scroll_cb = disp_scroll_cb;
+  disp_drv.draw_buf = &disp_buf;
+  // The panel rotates in hardware (LCD_3IN49_SetAttributes), so LVGL draws
+  // at the panel's current resolution and never rotates itself
+  disp_drv.hor_res = LCD_3IN49.WIDTH;
+  disp_drv.ver_res = LCD_3IN49.HEIGHT;
+  disp_drv.full_refresh = 0;
+  disp_drv.direct_mode = 0;
+  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+  disp->refr_timer->timer_cb = disp_refr_timer;
+  LCD_3IN49_Set_Vsync_Cb(disp_vsync, NULL);
+  return disp;
+}
@@ -0,0 +1,129 @@
+#include "lv_mem_rp.h"
+#include "rp_pico_alloc.h"
+#include "tlsf/tlsf.h"
+#include <stdbool.h>
+#include <string.h>
+
+static uint8_t m_pool[LV_MEM_RP_POOL_SIZE] __attribute__((aligned(8)));
+static tlsf_t m_tlsf;
+static lv_mem_rp_stats_t m_stats;
+
+static bool in_pool(const void *ptr) {
+  return (const uint8_t *)ptr >= m_pool &&
+         (const uint8_t *)ptr < m_pool + sizeof(m_pool);
+}
+
+// lv_init() allocates before anything else runs, so this is set up lazily
+static tlsf_t pool(void) {
+  if (!m_tlsf) {
+    m_tlsf = tlsf_create_with_pool(m_pool, sizeof(m_pool), sizeof(m_pool));
+    m_stats.pool_size = sizeof(m_pool);
+  }
+  return m_tlsf;
+}
+
+static void *pool_alloc(size_t size) {
+  void *ptr = tlsf_malloc(pool(), size);
+
+  if (ptr) {
+    m_stats.pool_used += tlsf_block_size(ptr);
+    if (m_stats.pool_used > m_stats.pool_peak)
+      m_stats.pool_peak = m_stats.pool_used;
+  }
+  return ptr;
+}
+
+static void *bulk_alloc(size_t size) {
+  void *ptr = rp_mem_malloc_hint(size, RP_MEM_BULK);
+
+  if (ptr && ++m_stats.bulk_live > m_stats.bulk_peak)
+    m_stats.bulk_peak = m_stats.bulk_live;
+  return ptr;
+}
+
+void *lv_mem_rp_alloc(size_t size) {
+  void *ptr = NULL;
+
+  if (size <= LV_MEM_RP_SMALL) {
+    ptr = pool_alloc(size);
+    if (!ptr) {
+      m_stats.spills++;
+      ptr = bulk_alloc(size);
+    }
+  } else {
+    m_stats.bulk++;
+    ptr = bulk_alloc(size);
+  }
+  if (ptr)
+    m_stats.allocs++;
+  else
+    m_stats.failed++;
+  return ptr;
+}
+
+void lv_mem_rp_free(void *ptr) {
+  if (!ptr)
+    return;
+  m_stats.frees++;
+  if (in_pool(ptr)) {
+    m_stats.pool_used -= tlsf_block_size(ptr);
+    tlsf_free(m_tlsf, ptr);
+  } else {
+    m_stats.bulk_live--;
+    rp_mem_free(ptr);
+  }
+}
+
+void *lv_mem_rp_realloc(void *ptr, size_t size) {
+  if (!ptr)
+    return lv_mem_rp_alloc(size);
+
+  if (!in_pool(ptr)) {
+    void *p = rp_mem_realloc(ptr, size);
+    if (!p)
+      m_stats.failed++;
+    return p;
+  }
+
+  size_t old = tlsf_block_size(ptr);
+  if (size <= LV_MEM_RP_SMALL) {
+    void *p = tlsf_realloc(m_tlsf, ptr, size);
+    if (p) {
+      m_stats.pool_used += tlsf_block_size(p) - old;
+      if (m_stats.pool_used > m_stats.pool_peak)
+        m_stats.pool_peak = m_stats.pool_used;
+      return p;
+    }
+  }
+  // Grown past the sub-pool, or it can't fit the new size: move out
+  void *p = lv_mem_rp_alloc(size);
+  if (!p)
+    return NULL;
+  memcpy(p, ptr, old < size ? old : size);
+  lv_mem_rp_free(ptr);
+  // One block moved, not one more allocated
+  m_stats.allocs--;
+  m_stats.frees--;
+  return p;
+}
+
+static bool free_walker(void *ptr, size_t size, int used, void *user) {
+  size_t *acc = user; // total free, largest free
+
+  (void)ptr;
+  if (!used) {
+    acc[0] += size;
+    if (size > acc[1])
+      acc[1] = size;
+  }
+  return true;
+}
+
+void lv_mem_rp_get_stats(lv_mem_rp_stats_t *stats) {
+  size_t acc[2] = {0, 0};
+
+  tlsf_walk_pool(tlsf_get_pool(pool()), free_walker, acc);
+  *stats = m_stats;
+  stats->pool_max_free = acc[1];
+  stats->pool_frag_pct = acc[0] ? 100 - acc[1] * 100 / acc[0] : 0;
+}
@@ -0,0 +1,92 @@
+#include "touch_indev.h"
+#include "Touch.h"
+#include "pico/stdlib.h"
+#include <string.h>
+
+static lv_indev_drv_t m_drv;
+static lv_indev_t *m_indev;
+static touch_reader_t m_reader;
+static touch_indev_stats_t m_stats;
+static lv_point_t m_point;
+static bool m_pressed = false;
+static uint32_t m_last_us;
+static touch_filter_t m_filter;
+
+static void touch_indev_latency(uint32_t latency) {
+  m_stats.latency_us = latency;
+  if (latency > m_stats.latency_max_us)
+    m_stats.latency_max_us = latency;
+  if (m_stats.samples == 1)
+    m_stats.latency_avg_us = latency;
+  else
+    m_stats.latency_avg_us += ((int32_t)(latency - m_stats.latency_avg_us)) / 16;
+}
+
+static void touch_indev_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  touch_sample_t s;
+  uint32_t now = time_us_32();
+
+  if (touch_ring_pop(&TOUCH_RING, &m_reader, &s)) {
+    bool pressed = s.fingers > 0;
+    if (pressed) {
+      if (!m_pressed) {
+        m_stats.presses++;
+        touch_filter_reset(&m_filter);
+      }
+      uint16_t x, y;
+      touch_filter_update(&m_filter, s.x, s.y, s.t_us, &x, &y);
+      m_point.x = x;
+      m_point.y = y;
+    }
+    m_pressed = pressed;
+    m_last_us = s.t_us;
+
+    m_stats.samples++;
+    touch_indev_latency(now - s.t_us);
+    data->continue_reading = touch_ring_pending(&TOUCH_RING, &m_reader) > 0;
+  } else if (m_pressed && now - m_last_us > TOUCH_INDEV_RELEASE_TIMEOUT_US) {
+    m_pressed = false;
+    m_stats.timeouts++;
+  }
+  m_stats.lost = m_reader.lost;
+
+  // Between samples LVGL sees the last known state, so a held finger stays
+  // pressed instead of flickering
+  data->point = m_point;
+  data->state = m_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+
+  // Released, nothing queued and no scroll still coasting: stop polling
+  // until the next report, so the loop can sleep. touch_indev_poll()
+  // resumes the timer, which then reads at once.
+  if (!m_pressed && !data->continue_reading && m_indev &&
+      !lv_indev_get_scroll_obj(m_indev))
+    lv_timer_pause(drv->read_timer);
+}
+
+lv_indev_t *touch_indev_init(void) {
+  touch_filter_config_t cfg;
+  touch_filter_default_config(&cfg);
+  touch_filter_init(&m_filter, &cfg);
+
+  touch_reader_init(&m_reader, &TOUCH_RING);
+  lv_indev_drv_init(&m_drv);
+  m_drv.type = LV_INDEV_TYPE_POINTER;
+  m_drv.read_cb = touch_indev_read;
+  m_indev = lv_indev_drv_register(&m_drv);
+  return m_indev;
+}
+
+void touch_indev_poll(void) {
+  lv_timer_t *t = m_drv.read_timer;
+
+  if (t && t->paused && touch_ring_pending(&TOUCH_RING, &m_reader))
+    lv_timer_resume(t);
+}
+
+void touch_indev_get_stats(touch_indev_stats_t *stats) { *stats = m_stats; }
+
+void touch_indev_reset_stats(void) { memset(&m_stats, 0, sizeof(m_stats)); }
+
+void touch_indev_set_filter(const touch_filter_config_t *cfg) {
+  touch_filter_init(&m_filter, cfg);
+}
@@ -0,0 +1,44 @@
+#include "ui_bridge.h"
+#include "battery.h"
+#include "idle.h"
+#include "pico/time.h"
+#include "spsc_queue.h"
+#include "tusb.h"
+
+#define UI_EVENT_QUEUE_SIZE 8 // power of two
+#define UI_BRIDGE_RETRY_US 10000
+
+static ui_event_t m_event_storage[UI_EVENT_QUEUE_SIZE];
+static spsc_queue_t m_event_queue = SPSC_QUEUE_INIT(m_event_storage);
+static int m_usb_state = -1; // nothing posted yet
+static int m_battery = -1;
+
+static bool ui_bridge_post(uint8_t type, uint8_t value) {
+  ui_event_t ev = {.type = type, .value = value};
+
+  if (!spsc_queue_push(&m_event_queue, &ev)) {
+    idle_wake_at(time_us_32() + UI_BRIDGE_RETRY_US);
+    return false;
+  }
+  idle_kick(); // the LVGL loop may be asleep, or on the other core
+  return true;
+}
+
+void ui_bridge_task(void) {
+  int state = tud_suspended() ? UI_USB_SUSPENDED
+              : tud_mounted() ? UI_USB_MOUNTED
+                              : UI_USB_DETACHED;
+
+  battery_snapshot_t bat;
+
+  // Retried shortly if the UI is behind
+  if (state != m_usb_state && ui_bridge_post(UI_EVENT_USB_STATE, state))
+    m_usb_state = state;
+  if (battery_get_snapshot(&bat) && bat.percent != m_battery &&
+      ui_bridge_post(UI_EVENT_BATTERY, bat.percent))
+    m_battery = bat.percent;
+}
+
+bool ui_bridge_poll(ui_event_t *ev) {
+  return spsc_queue_pop(&m_event_queue, ev);
+}
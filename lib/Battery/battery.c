@@ -0,0 +1,86 @@
+#include "battery.h"
+#include "DEV_Config.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "idle.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+#define BATTERY_RING_LEN ((1u << BATTERY_RING_BITS) / sizeof(uint16_t))
+
+// The DMA write address wraps on the ring size, so it must be aligned to it
+static uint16_t m_ring[BATTERY_RING_LEN]
+    __attribute__((aligned(1u << BATTERY_RING_BITS)));
+static int m_dma = -1;
+static uint32_t m_tail;    // next sample to take
+static uint32_t m_pass_us; // when m_tail was taken
+static uint32_t m_due_us;
+static uint32_t m_report_us;
+static battery_est_t m_est;
+
+bool battery_init(void) {
+  m_dma = dma_claim_unused_channel(false);
+  if (m_dma < 0)
+    return false;
+  battery_est_init(&m_est);
+
+  // DEV_Module_Init set up the pin; clk_adc is 48 MHz from PLL_USB, so
+  // clock scaling doesn't move the rate
+  adc_run(false);
+  adc_select_input(BAT_CHANNEL);
+  adc_fifo_drain();
+  adc_fifo_setup(true, true, 1, false, false);
+  adc_set_clkdiv(48000000.f / BATTERY_SAMPLE_HZ - 1);
+
+  dma_channel_config c = dma_channel_get_default_config(m_dma);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, false);
+  channel_config_set_write_increment(&c, true);
+  channel_config_set_ring(&c, true, BATTERY_RING_BITS);
+  channel_config_set_dreq(&c, DREQ_ADC);
+  dma_channel_configure(m_dma, &c, m_ring, &adc_hw->fifo,
+                        dma_encode_endless_transfer_count(), true);
+  adc_run(true);
+
+  m_tail = 0;
+  m_pass_us = time_us_32();
+  m_due_us = m_report_us = m_pass_us + BATTERY_PERIOD_US;
+  return true;
+}
+
+void battery_task(void) {
+  uint32_t now = time_us_32();
+
+  if (m_dma < 0)
+    return;
+  if ((int32_t)(now - m_due_us) < 0) {
+    idle_wake_at(m_due_us);
+    return;
+  }
+  m_due_us = now + BATTERY_PERIOD_US;
+  idle_wake_at(m_due_us);
+
+  // Everything the DMA wrote since the last pass. The write address only
+  // gives that modulo the ring, so the time since the last pass tells
+  // whether it lapped; a pass that late takes the last ring's worth.
+  uint32_t head = (dma_hw->ch[m_dma].write_addr - (uintptr_t)m_ring) /
+                  sizeof(m_ring[0]);
+  uint32_t n = (head - m_tail) & (BATTERY_RING_LEN - 1);
+  uint32_t due = (uint32_t)((uint64_t)(now - m_pass_us) * BATTERY_SAMPLE_HZ /
+                            1000000);
+  if (due >= n + BATTERY_RING_LEN / 2)
+    n = BATTERY_RING_LEN;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < n; i++)
+    sum += m_ring[(head - n + i) & (BATTERY_RING_LEN - 1)];
+  m_tail = head;
+  m_pass_us = now;
+
+  battery_est_update(&m_est, sum, n);
+  battery_est_publish(&m_est, now);
+
+  if (now - m_report_us < BATTERY_REPORT_US || !m_est.seeded)
+    return;
+  m_report_us = now;
+  printf("battery %u mV, %u%%\r\n", battery_est_mv(&m_est), m_est.percent);
+}
@@ -0,0 +1,28 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include "battery_est.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Battery monitor. The ADC free-runs on BAT_CHANNEL at BATTERY_SAMPLE_HZ and
+// a DMA channel in endless mode writes every sample into a ring; nothing
+// interrupts the CPU. Every BATTERY_PERIOD_US battery_task() sums what
+// arrived since the last pass into one block for the estimator and
+// publishes the result through battery_est_get_snapshot(). The ring holds
+// about twice a period, so a late pass loses nothing.
+
+#define BATTERY_SAMPLE_HZ 1000
+#define BATTERY_PERIOD_US 500000
+#define BATTERY_RING_BITS 11 // ring size in bytes, log2
+// battery_task() prints the estimate this often
+#define BATTERY_REPORT_US 10000000
+
+bool battery_init(void);
+void battery_task(void);
+
+static inline bool battery_get_snapshot(battery_snapshot_t *out) {
+  return battery_est_get_snapshot(out);
+}
+
+#endif
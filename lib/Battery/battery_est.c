@@ -0,0 +1,97 @@
+#include "battery_est.h"
+#include "seqlock.h"
+#include <string.h>
+
+// Resting single-cell Li-ion/LiPo voltage against charge, highest first
+static const struct {
+  uint16_t mv;
+  uint16_t permille;
+} m_curve[] = {
+    {4200, 1000}, {4150, 950}, {4110, 900}, {4080, 850}, {4020, 800},
+    {3980, 750},  {3950, 700}, {3910, 650}, {3870, 600}, {3850, 550},
+    {3840, 500},  {3820, 450}, {3800, 400}, {3790, 350}, {3770, 300},
+    {3750, 250},  {3730, 200}, {3710, 150}, {3690, 100}, {3610, 50},
+    {3270, 0},
+};
+
+#define CURVE_LEN (sizeof(m_curve) / sizeof(m_curve[0]))
+
+void battery_est_init(battery_est_t *e) {
+  memset(e, 0, sizeof(*e));
+}
+
+uint16_t battery_est_soc(uint16_t mv) {
+  if (mv >= m_curve[0].mv)
+    return m_curve[0].permille;
+  for (unsigned i = 1; i < CURVE_LEN; i++) {
+    if (mv >= m_curve[i].mv) {
+      uint32_t span = m_curve[i - 1].mv - m_curve[i].mv;
+      uint32_t rise = m_curve[i - 1].permille - m_curve[i].permille;
+      return m_curve[i].permille + (mv - m_curve[i].mv) * rise / span;
+    }
+  }
+  return 0;
+}
+
+void battery_est_update(battery_est_t *e, uint32_t sum, uint32_t n) {
+  if (!n)
+    return;
+  // sum < 2^32 for any ring the caller can fill, and the product fits 64
+  int32_t x_q8 = (uint64_t)sum * BATTERY_ADC_FULL_SCALE_MV * 256 /
+                 ((uint64_t)n * BATTERY_ADC_COUNTS);
+
+  e->block_mv = x_q8 >> 8;
+  if (!e->seeded) {
+    e->mv_q8 = x_q8;
+    e->seeded = true;
+  } else {
+    e->mv_q8 += (x_q8 - e->mv_q8) >> BATTERY_EST_SHIFT;
+  }
+  e->soc_permille = battery_est_soc(battery_est_mv(e));
+  // Rounded on the first block, then only a whole percent away moves it
+  int32_t tenths = e->soc_permille - e->percent * 10;
+  if (e->blocks == 0)
+    e->percent = (e->soc_permille + 5) / 10;
+  else if (tenths >= 10)
+    e->percent = e->soc_permille / 10;
+  else if (tenths <= -10)
+    e->percent = (e->soc_permille + 9) / 10;
+  e->blocks++;
+  e->samples += n;
+}
+
+uint16_t battery_est_mv(const battery_est_t *e) {
+  return (e->mv_q8 + 128) >> 8;
+}
+
+//--------------------------------------------------------------------+
+// Snapshot
+//--------------------------------------------------------------------+
+static seqlock_t m_snapshot_seq;
+static battery_snapshot_t m_snapshot;
+static bool m_snapshot_valid;
+
+void battery_est_publish(const battery_est_t *e, uint32_t timestamp_us) {
+  if (!e->seeded)
+    return;
+  seqlock_write_begin(&m_snapshot_seq);
+  m_snapshot.mv = battery_est_mv(e);
+  m_snapshot.block_mv = e->block_mv;
+  m_snapshot.soc_permille = e->soc_permille;
+  m_snapshot.percent = e->percent;
+  m_snapshot.timestamp_us = timestamp_us;
+  m_snapshot.samples = e->samples;
+  m_snapshot_valid = true;
+  seqlock_write_end(&m_snapshot_seq);
+}
+
+bool battery_est_get_snapshot(battery_snapshot_t *out) {
+  uint32_t seq;
+  bool valid;
+  do {
+    seq = seqlock_read_begin(&m_snapshot_seq);
+    *out = m_snapshot;
+    valid = m_snapshot_valid;
+  } while (seqlock_read_retry(&m_snapshot_seq, seq));
+  return valid;
+}
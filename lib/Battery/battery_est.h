@@ -0,0 +1,55 @@
+#ifndef BATTERY_EST_H
+#define BATTERY_EST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed-point battery state estimator for the ADC stream.
+//
+// Input is one decimated block at a time: the sum of n raw 12-bit samples,
+// so the boxcar average costs one add per sample in the caller and one
+// division here. Block voltages go through a first-order IIR (weight
+// 1 / 2^BATTERY_EST_SHIFT, mV in Q8), the first block seeding it, and the
+// filtered voltage is mapped to charge through a resting Li-ion discharge
+// curve by linear interpolation. The whole percent shown to the user moves
+// only once the estimate is a full percent away, so load steps don't make
+// it flicker.
+//
+// The estimator is hardware independent and builds unchanged on the host,
+// where synthetic discharge curves can be fed through battery_est_update().
+
+// ADC full scale at the battery: 3.3 V reference behind a 1:3 divider
+#define BATTERY_ADC_FULL_SCALE_MV 9900
+#define BATTERY_ADC_COUNTS 4096
+#define BATTERY_EST_SHIFT 3
+
+typedef struct {
+  int32_t mv_q8;         // filtered voltage
+  uint16_t block_mv;     // last block average, unfiltered
+  uint16_t soc_permille; // of the filtered voltage
+  uint8_t percent;       // with the 1% deadband
+  bool seeded;
+  uint32_t blocks;
+  uint32_t samples;
+} battery_est_t;
+
+typedef struct {
+  uint16_t mv;
+  uint16_t block_mv;
+  uint16_t soc_permille;
+  uint8_t percent;
+  uint32_t timestamp_us;
+  uint32_t samples;      // ADC samples folded in since init
+} battery_snapshot_t;
+
+void battery_est_init(battery_est_t *e);
+void battery_est_update(battery_est_t *e, uint32_t sum, uint32_t n);
+uint16_t battery_est_mv(const battery_est_t *e);
+// Resting voltage to charge, 0..1000
+uint16_t battery_est_soc(uint16_t mv);
+
+// Lock-free publication for the UI and telemetry (see seqlock.h)
+void battery_est_publish(const battery_est_t *e, uint32_t timestamp_us);
+bool battery_est_get_snapshot(battery_snapshot_t *out);
+
+#endif
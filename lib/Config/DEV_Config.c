@@ -28,6 +28,11 @@
 ******************************************************************************/
 #include "DEV_Config.h"
 #include "qspi_pio.h"
+#include "sys_clock.h"
+
+#define DEV_I2C_BAUD (400 * 1000)
+// Backlight PWM counter clock; 29.7 kHz with the wrap of 100
+#define DEV_PWM_COUNT_HZ (3 * 1000 * 1000)
 
 uint slice_num;
 uint dma_tx;
@@ -61,30 +66,30 @@ void DEV_SPI_Write_nByte(uint8_t pData[], uint32_t Len)
 
 /**
  * I2C
+ * Blocking helpers on top of the DMA engine (i2c_dma.c), for init and
+ * configuration paths. Periodic reads should submit transactions instead.
 **/
 void DEV_I2C_Write_Byte(uint8_t addr, uint8_t reg, uint8_t Value)
 {
     uint8_t data[2] = {reg, Value};
-    i2c_write_blocking(I2C_PORT, addr, data, 2, false);
+    i2c_dma_transfer_blocking(I2C_PORT, addr, data, 2, NULL, 0);
 }
 
 void DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len)
 {
-    i2c_write_blocking(I2C_PORT, addr, pData, Len, false);
+    i2c_dma_transfer_blocking(I2C_PORT, addr, pData, Len, NULL, 0);
 }
 
 uint8_t DEV_I2C_Read_Byte(uint8_t addr, uint8_t reg)
 {
-    uint8_t buf;
-    i2c_write_blocking(I2C_PORT,addr,&reg,1,true);
-    i2c_read_blocking(I2C_PORT,addr,&buf,1,false);
+    uint8_t buf = 0;
+    i2c_dma_transfer_blocking(I2C_PORT, addr, &reg, 1, &buf, 1);
     return buf;
 }
 
 void DEV_I2C_Read_nByte(uint8_t addr,uint8_t reg, uint8_t *pData, uint32_t Len)
 {
-    i2c_write_blocking(I2C_PORT,addr,&reg,1,true);
-    i2c_read_blocking(I2C_PORT,addr,pData,Len,false);
+    i2c_dma_transfer_blocking(I2C_PORT, addr, &reg, 1, pData, Len);
 }
 
 /**
@@ -140,6 +145,44 @@ void DEV_IRQ_SET(uint gpio, uint32_t events, gpio_irq_callback_t callback)
     gpio_set_irq_enabled_with_callback(gpio,events,true,callback);
 }
 
+/******************************************************************************
+function:	Attach a per-pin interrupt handler
+parameter:
+Info:   Unlike DEV_IRQ_SET this does not replace the shared GPIO callback, so
+        it can be used alongside the touch interrupt. The handler must call
+        gpio_acknowledge_irq() itself.
+******************************************************************************/
+void DEV_IRQ_ADD_RAW(uint gpio, uint32_t events, irq_handler_t handler)
+{
+    gpio_add_raw_irq_handler(gpio, handler);
+    gpio_set_irq_enabled(gpio, events, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+/******************************************************************************
+function:	Clock domains owned here: both I2C buses and the backlight PWM
+Info:	Both divide clk_sys, so each clk_sys change recomputes them; the
+	I2C buses only change between transactions
+******************************************************************************/
+static bool DEV_I2C_Quiet(void)
+{
+    return !i2c_dma_busy(I2C_PORT) && !i2c_dma_busy(TOUCH_I2C_PORT);
+}
+
+static void DEV_I2C_Retime(uint32_t sys_hz)
+{
+    i2c_set_baudrate(I2C_PORT, DEV_I2C_BAUD);
+    i2c_set_baudrate(TOUCH_I2C_PORT, DEV_I2C_BAUD);
+}
+
+static void DEV_PWM_Retime(uint32_t sys_hz)
+{
+    pwm_set_clkdiv(slice_num, (float)sys_hz / DEV_PWM_COUNT_HZ);
+}
+
+static const sys_clock_domain_t dev_i2c_clock = {"i2c", DEV_I2C_Quiet, DEV_I2C_Retime};
+static const sys_clock_domain_t dev_pwm_clock = {"pwm", NULL, DEV_PWM_Retime};
+
 /******************************************************************************
 function:	Module Initialize, the library and initialize the pins, SPI protocol
 parameter:
@@ -148,7 +191,11 @@ Info:
 UBYTE DEV_Module_Init(void)
 {
     stdio_init_all();   
+#if !FAST_BOOT
+    // Only the UART backend can be enabled (STDIO_UART), and it needs no
+    // time to settle; clk_peri stays at 150 MHz below, so its baud holds
     sleep_ms(100);
+#endif
 
     set_sys_clock_khz(PLL_SYS_KHZ, true);
     clock_configure(
@@ -158,6 +205,8 @@ UBYTE DEV_Module_Init(void)
         PLL_SYS_KHZ * 1000,                               
         PLL_SYS_KHZ * 1000                              
     );
+    // clk_sys drops below PLL_SYS_KHZ when idle; clk_peri stays on the PLL
+    sys_clock_init();
 
     //GPIO
     DEV_GPIO_Init();
@@ -170,33 +219,42 @@ UBYTE DEV_Module_Init(void)
     // DMA
     dma_tx = dma_claim_unused_channel(true);
     c = dma_channel_get_default_config(dma_tx);
-    channel_config_set_transfer_data_size(&c, DMA_SIZE_8); 
+    // Whole words into the QSPI FIFO; byte swapping keeps the in-memory
+    // byte order on the wire
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32); 
+    channel_config_set_bswap(&c, true);
     channel_config_set_read_increment(&c, true); 
     channel_config_set_write_increment(&c, false); 
-    channel_config_set_dreq(&c, pio_get_dreq(qspi.pio, qspi.sm, false));
+    channel_config_set_dreq(&c, pio_get_dreq(qspi.pio, qspi.sm, true));
     irq_set_enabled(DMA_IRQ_0, false);
 
     // I2C Config
-    i2c_init(I2C_PORT, 400 * 1000);
+    i2c_init(I2C_PORT, DEV_I2C_BAUD);
     gpio_set_function(DEV_SDA_PIN, GPIO_FUNC_I2C);
     gpio_set_function(DEV_SCL_PIN, GPIO_FUNC_I2C);
     gpio_pull_up(DEV_SDA_PIN);
     gpio_pull_up(DEV_SCL_PIN);
 
     // TOUCH I2C
-    i2c_init(TOUCH_I2C_PORT, 400 * 1000);
+    i2c_init(TOUCH_I2C_PORT, DEV_I2C_BAUD);
     gpio_set_function(TOUCH_SDA_PIN, GPIO_FUNC_I2C);
     gpio_set_function(TOUCH_SCL_PIN, GPIO_FUNC_I2C);
     gpio_pull_up(TOUCH_SDA_PIN);
     gpio_pull_up(TOUCH_SCL_PIN);
 
+    // Both buses are driven by the queued DMA engine from here on
+    i2c_dma_init(I2C_PORT);
+    i2c_dma_init(TOUCH_I2C_PORT);
+    sys_clock_register(&dev_i2c_clock);
+
     // PWM Config
     gpio_set_function(LCD_BL_PIN, GPIO_FUNC_PWM);
     slice_num = pwm_gpio_to_slice_num(LCD_BL_PIN);
     pwm_set_wrap(slice_num, 100);
     pwm_set_chan_level(slice_num, PWM_CHAN_A, 1);
-    pwm_set_clkdiv(slice_num, 50);
+    DEV_PWM_Retime(clock_get_hz(clk_sys));
     pwm_set_enabled(slice_num, true);
+    sys_clock_register(&dev_pwm_clock);
     DEV_SET_PWM(0);
     
     printf("DEV_Module_Init OK \r\n");
@@ -40,6 +40,7 @@
 #include "hardware/dma.h"
 #include "hardware/pio.h"
 #include "hardware/watchdog.h"
+#include "i2c_dma.h"
 
 #define PLL_SYS_KHZ 150 * 1000
 
@@ -94,6 +95,7 @@ uint8_t DEV_I2C_Read_Byte(uint8_t addr, uint8_t reg);
 void DEV_I2C_Read_nByte(uint8_t addr,uint8_t reg, uint8_t *pData, uint32_t Len);
 
 void DEV_IRQ_SET(uint gpio, uint32_t events, gpio_irq_callback_t callback);
+void DEV_IRQ_ADD_RAW(uint gpio, uint32_t events, irq_handler_t handler);
 
 void DEV_SET_PWM(uint8_t Value);
 
@@ -0,0 +1,98 @@
+#include "boot_prof.h"
+#include "hardware/sync.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+static volatile uint32_t m_phase_us[BOOT_PHASE_COUNT];
+static volatile uint32_t m_marked;   // bit per phase
+static uint32_t m_printed;
+static uint32_t m_last_us;           // end of the last phase printed
+static void (*m_service)(void);
+static uint m_service_core;
+static bool m_in_service;
+
+static const char *const m_names[BOOT_PHASE_COUNT] = {
+    [BOOT_MAIN] = "main",
+    [BOOT_USB_INIT] = "usb_init",
+    [BOOT_DEV_INIT] = "dev_init",
+    [BOOT_PANEL] = "panel",
+    [BOOT_PANEL_CLOCK] = "panel_clock",
+    [BOOT_SPLASH] = "splash",
+    [BOOT_LVGL] = "lvgl",
+    [BOOT_FIRST_FRAME] = "first_frame",
+    [BOOT_PERIPHERALS] = "peripherals",
+    [BOOT_USB_MOUNTED] = "usb_mounted",
+    [BOOT_FIRST_KEY] = "first_key",
+};
+
+// Not from interrupts, nor from inside the service itself (a TinyUSB
+// callback that marks a phase)
+static bool boot_service(void) {
+  if (!m_service || m_in_service || get_core_num() != m_service_core ||
+      __get_current_exception())
+    return false;
+  m_in_service = true;
+  m_service();
+  m_in_service = false;
+  return true;
+}
+
+void boot_mark(boot_phase_t phase) {
+  uint32_t now = time_us_32();
+  uint32_t save = save_and_disable_interrupts();
+
+  if (!(m_marked & 1u << phase)) {
+    m_phase_us[phase] = now;
+    __dmb();
+    m_marked |= 1u << phase;
+  }
+  restore_interrupts(save);
+  boot_service();
+}
+
+bool boot_phase_done(boot_phase_t phase) {
+  return m_marked & 1u << phase;
+}
+
+uint32_t boot_phase_us(boot_phase_t phase) {
+  return boot_phase_done(phase) ? m_phase_us[phase] : 0;
+}
+
+const char *boot_phase_name(boot_phase_t phase) {
+  return phase < BOOT_PHASE_COUNT ? m_names[phase] : "?";
+}
+
+void boot_set_service(void (*service)(void)) {
+  m_service_core = get_core_num();
+  m_service = service;
+}
+
+void boot_sleep_us(uint32_t us) {
+  uint32_t start = time_us_32();
+
+  while (time_us_32() - start < us) {
+    if (!boot_service()) {
+      sleep_us(us - (time_us_32() - start));
+      return;
+    }
+  }
+}
+
+void boot_prof_task(void) {
+  uint32_t pending = m_marked & ~m_printed;
+
+  if (!pending)
+    return;
+  // In phase order; a phase the other core finished earlier shows as +0
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    if (!(pending & 1u << i))
+      continue;
+    uint32_t t = m_phase_us[i];
+    uint32_t d = (int32_t)(t - m_last_us) > 0 ? t - m_last_us : 0;
+    printf("boot %-12s %6lu.%lu ms  +%lu.%lu\r\n", m_names[i], t / 1000,
+           t / 100 % 10, d / 1000, d / 100 % 10);
+    m_last_us += d;
+    m_printed |= 1u << i;
+  }
+}
@@ -0,0 +1,43 @@
+#ifndef BOOT_PROF_H
+#define BOOT_PROF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Boot timeline. Each bring-up phase is stamped once, with the time since
+// reset, when it completes; boot_prof_task() prints the phases as they
+// arrive, so the log reads as a timeline ending at the first keystroke.
+//
+// Bring-up waits go through boot_sleep_us(), which keeps calling a service
+// function (tud_task) instead of sleeping, so USB enumerates while the panel
+// is still coming up. The service only runs on the core that set it.
+
+typedef enum {
+  BOOT_MAIN = 0,    // main() entered: boot ROM, runtime and clock setup
+  BOOT_USB_INIT,    // TinyUSB started
+  BOOT_DEV_INIT,    // DEV_Module_Init: clocks, GPIO, DMA, I2C, PWM
+  BOOT_PANEL,       // panel reset and init sequence
+  BOOT_PANEL_CLOCK, // QSPI clock calibration
+  BOOT_SPLASH,      // splash on the panel, backlight on
+  BOOT_LVGL,        // LVGL and the widgets built
+  BOOT_FIRST_FRAME, // first LVGL frame flushed
+  BOOT_PERIPHERALS, // RTC and IMU
+  BOOT_USB_MOUNTED, // host configured the device
+  BOOT_FIRST_KEY,   // first keyboard report sent
+  BOOT_PHASE_COUNT
+} boot_phase_t;
+
+// Stamps a phase, first call only, then runs the service; any core or
+// interrupt
+void boot_mark(boot_phase_t phase);
+bool boot_phase_done(boot_phase_t phase);
+uint32_t boot_phase_us(boot_phase_t phase); // 0 until marked
+const char *boot_phase_name(boot_phase_t phase);
+
+void boot_set_service(void (*service)(void));
+void boot_sleep_us(uint32_t us);
+
+// Prints phases marked since the last call
+void boot_prof_task(void);
+
+#endif
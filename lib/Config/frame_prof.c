@@ -0,0 +1,132 @@
+#include "frame_prof.h"
+#include "hardware/sync.h"
+#include "pico/platform.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PROF_RING_MASK (FRAME_PROF_RING_SIZE - 1)
+
+static prof_record_t m_ring[FRAME_PROF_RING_SIZE];
+static uint32_t m_head; // records written since reset
+
+static bool m_frame_open;
+static uint32_t m_frame_start_us;
+static uint32_t m_frame_end_us;
+static prof_frame_t m_frame; // being accumulated
+static prof_frame_t m_last;  // latched at prof_frame_end
+
+static const char *const m_names[PROF_STAGE_COUNT] = {
+    [PROF_TIMER_HANDLER] = "timer_handler",
+    [PROF_REFRESH] = "refresh",
+    [PROF_DRAW_AREA] = "draw_area",
+    [PROF_DMA_WAIT] = "dma_wait",
+    [PROF_FLUSH] = "flush",
+    [PROF_DMA_IRQ] = "dma_irq",
+};
+
+void __not_in_flash_func(prof_span)(prof_stage_t stage, uint32_t start_us,
+                                    uint32_t end_us, uint16_t arg) {
+  uint32_t dur = end_us - start_us;
+  uint32_t save = save_and_disable_interrupts();
+
+  prof_record_t *r = &m_ring[m_head & PROF_RING_MASK];
+  r->t_us = start_us;
+  r->dur_us = dur;
+  r->arg = arg;
+  r->stage = stage;
+  r->core = get_core_num();
+  m_head++;
+
+  prof_frame_t *f = NULL;
+  if (m_frame_open)
+    f = &m_frame;
+  else if ((int32_t)(start_us - m_frame_start_us) >= 0 &&
+           (int32_t)(start_us - m_frame_end_us) < 0)
+    f = &m_last;
+  if (f) {
+    f->stage_us[stage] += dur;
+    if (stage == PROF_DRAW_AREA)
+      f->areas++;
+  }
+  restore_interrupts(save);
+}
+
+void prof_frame_begin(uint32_t start_us) {
+  uint32_t save = save_and_disable_interrupts();
+  if (!m_frame_open) {
+    memset(&m_frame, 0, sizeof(m_frame));
+    m_frame_start_us = start_us;
+    // The next refresh may start drawing while the last frame is still on
+    // the bus, in which case there was no idle time between them
+    int32_t gap = (int32_t)(start_us - m_frame_end_us);
+    m_frame.idle_us = m_frame_end_us && gap > 0 ? (uint32_t)gap : 0;
+    m_frame_open = true;
+  }
+  restore_interrupts(save);
+}
+
+void __not_in_flash_func(prof_frame_end)(void) {
+  uint32_t save = save_and_disable_interrupts();
+  if (m_frame_open) {
+    m_frame_end_us = time_us_32();
+    m_frame.frame_us = m_frame_end_us - m_frame_start_us;
+    m_last = m_frame;
+    m_frame_open = false;
+  }
+  restore_interrupts(save);
+}
+
+bool prof_frame_open(void) { return m_frame_open; }
+
+void prof_last_frame(prof_frame_t *out) {
+  uint32_t save = save_and_disable_interrupts();
+  *out = m_last;
+  restore_interrupts(save);
+}
+
+void prof_reset(void) {
+  uint32_t save = save_and_disable_interrupts();
+  m_head = 0;
+  m_frame_open = false;
+  m_frame_start_us = 0;
+  m_frame_end_us = 0;
+  memset(&m_last, 0, sizeof(m_last));
+  restore_interrupts(save);
+}
+
+const char *prof_stage_name(prof_stage_t stage) {
+  return stage < PROF_STAGE_COUNT ? m_names[stage] : "?";
+}
+
+void prof_export_chrome(prof_write_fn write, void *user) {
+  char line[128];
+  uint32_t head, first;
+  bool sep = false;
+  int n;
+
+  // Records are copied out one at a time so interrupts are only masked
+  // briefly; any overwritten while exporting are skipped
+  head = m_head;
+  first = head > FRAME_PROF_RING_SIZE ? head - FRAME_PROF_RING_SIZE : 0;
+
+  n = snprintf(line, sizeof(line), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  write(line, n, user);
+  for (uint32_t i = first; i < head; i++) {
+    prof_record_t r;
+    uint32_t save = save_and_disable_interrupts();
+    bool valid = m_head - i <= FRAME_PROF_RING_SIZE;
+    r = m_ring[i & PROF_RING_MASK];
+    restore_interrupts(save);
+    if (!valid)
+      continue;
+    n = snprintf(line, sizeof(line),
+                 "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,"
+                 "\"pid\":0,\"tid\":%u,\"args\":{\"n\":%u}}\n",
+                 sep ? "," : "", prof_stage_name(r.stage),
+                 (unsigned long)r.t_us, (unsigned long)r.dur_us, r.core, r.arg);
+    write(line, n, user);
+    sep = true;
+  }
+  n = snprintf(line, sizeof(line), "]}\n");
+  write(line, n, user);
+}
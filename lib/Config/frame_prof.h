@@ -0,0 +1,73 @@
+#ifndef FRAME_PROF_H
+#define FRAME_PROF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/time.h"
+
+// Frame pipeline profiler. Each stage of getting a frame to the panel is
+// recorded as a timestamped span in a ring (the newest FRAME_PROF_RING_SIZE
+// kept) and summed into per-frame totals. A frame runs from the start of
+// the refresh that draws it until its last flush leaves the DMA; spans that
+// started inside a frame but end after it still count towards it.
+//
+// The ring exports as Chrome trace JSON ("X" events, tid = core), which
+// chrome://tracing and Perfetto open directly.
+//
+// Spans may be recorded from interrupts; recording masks interrupts on the
+// calling core only, so every stage, and the export, must run on one core.
+
+#define FRAME_PROF_RING_SIZE 512 // power of two
+// Timer handler passes shorter than this found nothing due and aren't kept
+#define FRAME_PROF_HANDLER_MIN_US 20
+
+typedef enum {
+  PROF_TIMER_HANDLER = 0, // lv_task_handler
+  PROF_REFRESH,           // one refresh timer run
+  PROF_DRAW_AREA,         // rendering one area, up to its flush_cb
+  PROF_DMA_WAIT,          // LVGL spinning for a free draw buffer
+  PROF_FLUSH,             // flush_cb until the DMA is done with the buffer
+  PROF_DMA_IRQ,           // flush completion interrupt
+  PROF_STAGE_COUNT
+} prof_stage_t;
+
+typedef struct {
+  uint32_t t_us;   // span start
+  uint32_t dur_us;
+  uint16_t arg;    // stage specific, e.g. pixels in an area
+  uint8_t stage;
+  uint8_t core;
+} prof_record_t;
+
+typedef struct {
+  uint32_t frame_us;                   // first refresh -> last flush done
+  uint32_t idle_us;                    // gap since the previous frame ended
+  uint32_t stage_us[PROF_STAGE_COUNT]; // summed spans; stages overlap
+  uint16_t areas;
+} prof_frame_t;
+
+typedef void (*prof_write_fn)(const char *s, size_t len, void *user);
+
+void prof_span(prof_stage_t stage, uint32_t start_us, uint32_t end_us,
+               uint16_t arg);
+
+static inline uint32_t prof_now(void) { return time_us_32(); }
+
+// Records a span from start_us (a prof_now() value) until now
+static inline void prof_record(prof_stage_t stage, uint32_t start_us,
+                               uint16_t arg) {
+  prof_span(stage, start_us, time_us_32(), arg);
+}
+
+void prof_frame_begin(uint32_t start_us);
+void prof_frame_end(void);
+bool prof_frame_open(void);
+void prof_last_frame(prof_frame_t *out);
+
+void prof_reset(void);
+const char *prof_stage_name(prof_stage_t stage);
+void prof_export_chrome(prof_write_fn write, void *user);
+
+#endif
@@ -0,0 +1,176 @@
+#include "i2c_dma.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+typedef struct {
+  i2c_inst_t *i2c;
+  i2c_queue_t q;
+  spin_lock_t *lock;
+  uint tx_dma;
+  uint rx_dma;
+  bool ready;
+  // IC_DATA_CMD words for the active transaction. 32-bit so the DMA write
+  // is not replicated into the reserved upper half of the register.
+  uint32_t cmd[I2C_DMA_MAX_LEN];
+} i2c_dma_port_t;
+
+static i2c_dma_port_t m_ports[2];
+
+static inline i2c_dma_port_t *port_of(i2c_inst_t *i2c) {
+  return &m_ports[i2c_get_index(i2c)];
+}
+
+// Called with the port lock held, bus idle
+static void i2c_dma_start(i2c_dma_port_t *p, i2c_txn_t *t) {
+  i2c_hw_t *hw = i2c_get_hw(p->i2c);
+  uint32_t n = 0;
+
+  for (uint16_t i = 0; i < t->wr_len; i++)
+    p->cmd[n++] = t->wr[i];
+  for (uint16_t i = 0; i < t->rd_len; i++) {
+    uint32_t w = I2C_IC_DATA_CMD_CMD_BITS;
+    if (i == 0 && t->wr_len)
+      w |= I2C_IC_DATA_CMD_RESTART_BITS;
+    p->cmd[n++] = w;
+  }
+  p->cmd[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  // Target address can only change while the controller is disabled
+  hw->enable = 0;
+  hw->tar = t->addr;
+  hw->enable = 1;
+  (void)hw->clr_intr;
+
+  if (t->rd_len) {
+    dma_channel_set_write_addr(p->rx_dma, t->rd, false);
+    dma_channel_set_trans_count(p->rx_dma, t->rd_len, true);
+  }
+  dma_channel_set_read_addr(p->tx_dma, p->cmd, false);
+  dma_channel_set_trans_count(p->tx_dma, n, true);
+}
+
+static void i2c_dma_irq(i2c_dma_port_t *p) {
+  i2c_hw_t *hw = i2c_get_hw(p->i2c);
+  uint32_t stat = hw->intr_stat;
+  uint32_t abort_source = 0;
+
+  if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+    // The controller flushes both FIFOs and issues a STOP on abort; retire
+    // the transaction when that STOP is seen.
+    abort_source = hw->tx_abrt_source;
+    dma_channel_abort(p->tx_dma);
+    dma_channel_abort(p->rx_dma);
+    (void)hw->clr_tx_abrt;
+    if (p->q.head)
+      p->q.head->abort_source = abort_source;
+  }
+  if (!(stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS))
+    return;
+  (void)hw->clr_stop_det;
+
+  uint32_t save = spin_lock_blocking(p->lock);
+  i2c_txn_t *done = i2c_queue_active(&p->q);
+  if (!done) {
+    spin_unlock(p->lock, save);
+    return;
+  }
+  // The last byte lands in the RX FIFO just before STOP; let DMA drain it
+  while (dma_channel_is_busy(p->rx_dma))
+    tight_loop_contents();
+  if (dma_channel_is_busy(p->tx_dma))
+    dma_channel_abort(p->tx_dma);
+
+  abort_source |= done->abort_source;
+  i2c_txn_t *next = i2c_queue_complete(&p->q, abort_source == 0, abort_source);
+  if (next)
+    i2c_dma_start(p, next);
+  spin_unlock(p->lock, save);
+
+  if (done->cb)
+    done->cb(done);
+}
+
+static void i2c0_dma_irq(void) { i2c_dma_irq(&m_ports[0]); }
+static void i2c1_dma_irq(void) { i2c_dma_irq(&m_ports[1]); }
+
+void i2c_dma_init(i2c_inst_t *i2c) {
+  i2c_dma_port_t *p = port_of(i2c);
+  i2c_hw_t *hw = i2c_get_hw(i2c);
+  uint idx = i2c_get_index(i2c);
+
+  p->i2c = i2c;
+  i2c_queue_init(&p->q);
+  p->lock = spin_lock_instance(spin_lock_claim_unused(true));
+
+  p->tx_dma = dma_claim_unused_channel(true);
+  dma_channel_config tc = dma_channel_get_default_config(p->tx_dma);
+  channel_config_set_transfer_data_size(&tc, DMA_SIZE_32);
+  channel_config_set_read_increment(&tc, true);
+  channel_config_set_write_increment(&tc, false);
+  channel_config_set_dreq(&tc, i2c_get_dreq(i2c, true));
+  dma_channel_configure(p->tx_dma, &tc, &hw->data_cmd, p->cmd, 0, false);
+
+  p->rx_dma = dma_claim_unused_channel(true);
+  dma_channel_config rc = dma_channel_get_default_config(p->rx_dma);
+  channel_config_set_transfer_data_size(&rc, DMA_SIZE_8);
+  channel_config_set_read_increment(&rc, false);
+  channel_config_set_write_increment(&rc, true);
+  channel_config_set_dreq(&rc, i2c_get_dreq(i2c, false));
+  dma_channel_configure(p->rx_dma, &rc, NULL, &hw->data_cmd, 0, false);
+
+  // Refill the TX FIFO before it runs dry so SCL is not held between words
+  hw->dma_tdlr = 4;
+  hw->dma_rdlr = 0;
+  hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+  hw->intr_mask =
+      I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+  uint irq = idx ? I2C1_IRQ : I2C0_IRQ;
+  irq_set_exclusive_handler(irq, idx ? i2c1_dma_irq : i2c0_dma_irq);
+  irq_set_enabled(irq, true);
+  p->ready = true;
+}
+
+bool i2c_dma_submit(i2c_inst_t *i2c, i2c_txn_t *txn) {
+  i2c_dma_port_t *p = port_of(i2c);
+  uint32_t len = (uint32_t)txn->wr_len + txn->rd_len;
+  if (!p->ready || len == 0 || len > I2C_DMA_MAX_LEN)
+    return false;
+
+  bool start;
+  uint32_t save = spin_lock_blocking(p->lock);
+  bool queued = i2c_queue_push(&p->q, txn, &start);
+  if (start)
+    i2c_dma_start(p, txn);
+  spin_unlock(p->lock, save);
+  return queued;
+}
+
+bool i2c_dma_busy(i2c_inst_t *i2c) {
+  return i2c_queue_active(&port_of(i2c)->q) != NULL;
+}
+
+void i2c_dma_get_stats(i2c_inst_t *i2c, i2c_queue_t *stats) {
+  i2c_dma_port_t *p = port_of(i2c);
+  uint32_t save = spin_lock_blocking(p->lock);
+  *stats = p->q;
+  spin_unlock(p->lock, save);
+}
+
+bool i2c_dma_transfer_blocking(i2c_inst_t *i2c, uint8_t addr,
+                               const uint8_t *wr, uint16_t wr_len,
+                               uint8_t *rd, uint16_t rd_len) {
+  i2c_txn_t t = {
+      .addr = addr,
+      .wr = wr,
+      .wr_len = wr_len,
+      .rd = rd,
+      .rd_len = rd_len,
+  };
+  if (!i2c_dma_submit(i2c, &t))
+    return false;
+  while (i2c_txn_pending(&t))
+    tight_loop_contents();
+  return t.status == I2C_TXN_DONE;
+}
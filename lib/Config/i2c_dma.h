@@ -0,0 +1,35 @@
+#ifndef I2C_DMA_H
+#define I2C_DMA_H
+
+#include "hardware/i2c.h"
+#include "i2c_queue.h"
+
+// Queued, DMA-driven I2C engine for both controllers. A transaction is an
+// optional write followed by an optional read after a repeated start; the
+// whole thing is expanded into IC_DATA_CMD words and streamed by one DMA
+// channel while a second channel drains the RX FIFO. Completion is signalled
+// by the controller's STOP_DET / TX_ABRT interrupt, which retires the
+// transaction, starts the next queued one and then runs the callback, so the
+// CPU never waits on the bus.
+//
+// The *_blocking helpers submit through the same queue and spin until the
+// transaction retires. They are for init and configuration paths only and
+// must not be called from an I2C completion callback.
+
+#define I2C_DMA_MAX_LEN 256 // write + read bytes per transaction
+
+void i2c_dma_init(i2c_inst_t *i2c);
+
+// Queues txn on the bus. Returns false if the transaction is too long or is
+// still pending from an earlier submit.
+bool i2c_dma_submit(i2c_inst_t *i2c, i2c_txn_t *txn);
+
+bool i2c_dma_busy(i2c_inst_t *i2c);
+void i2c_dma_get_stats(i2c_inst_t *i2c, i2c_queue_t *stats);
+
+// Returns true on ACK of every byte
+bool i2c_dma_transfer_blocking(i2c_inst_t *i2c, uint8_t addr,
+                               const uint8_t *wr, uint16_t wr_len,
+                               uint8_t *rd, uint16_t rd_len);
+
+#endif
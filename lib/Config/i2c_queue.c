@@ -0,0 +1,49 @@
+#include "i2c_queue.h"
+#include <string.h>
+
+void i2c_queue_init(i2c_queue_t *q) { memset(q, 0, sizeof(*q)); }
+
+bool i2c_queue_push(i2c_queue_t *q, i2c_txn_t *txn, bool *start) {
+  *start = false;
+  if (i2c_txn_pending(txn))
+    return false;
+
+  txn->next = NULL;
+  txn->abort_source = 0;
+  if (q->tail) {
+    txn->status = I2C_TXN_QUEUED;
+    q->tail->next = txn;
+  } else {
+    txn->status = I2C_TXN_ACTIVE;
+    q->head = txn;
+    *start = true;
+  }
+  q->tail = txn;
+
+  q->submitted++;
+  if (++q->depth > q->max_depth)
+    q->max_depth = q->depth;
+  return true;
+}
+
+i2c_txn_t *i2c_queue_complete(i2c_queue_t *q, bool ok, uint32_t abort_source) {
+  i2c_txn_t *txn = q->head;
+  if (!txn)
+    return NULL;
+
+  q->head = txn->next;
+  if (!q->head)
+    q->tail = NULL;
+  q->depth--;
+  q->completed++;
+  if (!ok)
+    q->errors++;
+
+  txn->next = NULL;
+  txn->abort_source = abort_source;
+  txn->status = ok ? I2C_TXN_DONE : I2C_TXN_ERROR;
+
+  if (q->head)
+    q->head->status = I2C_TXN_ACTIVE;
+  return q->head;
+}
@@ -0,0 +1,73 @@
+#ifndef I2C_QUEUE_H
+#define I2C_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Transaction queue behind the DMA I2C engine (i2c_dma.h). Transactions are
+// caller-owned and linked intrusively, so queueing never allocates and a
+// driver can keep its request in static storage. The head of the queue is
+// the transaction currently on the bus.
+//
+// The queue itself does no locking; i2c_dma.c wraps every call in the bus
+// spin lock. It has no hardware dependencies so the ordering and completion
+// rules can be exercised against a simulated bus on the host.
+
+typedef enum {
+  I2C_TXN_IDLE = 0, // never submitted or already reaped
+  I2C_TXN_QUEUED,
+  I2C_TXN_ACTIVE,
+  I2C_TXN_DONE,
+  I2C_TXN_ERROR,    // NAK / arbitration loss, see abort_source
+} i2c_txn_status_t;
+
+typedef struct i2c_txn i2c_txn_t;
+
+// Runs in I2C interrupt context: keep it short and never block on the bus.
+// Submitting a follow-up transaction from here is fine.
+typedef void (*i2c_txn_cb_t)(i2c_txn_t *txn);
+
+struct i2c_txn {
+  uint8_t addr;
+  const uint8_t *wr; // bytes written first (register address, payload)
+  uint16_t wr_len;
+  uint8_t *rd;       // bytes read after a repeated start
+  uint16_t rd_len;
+  i2c_txn_cb_t cb;
+  void *user;
+
+  volatile i2c_txn_status_t status;
+  uint32_t abort_source;
+  i2c_txn_t *next;
+};
+
+typedef struct {
+  i2c_txn_t *head;
+  i2c_txn_t *tail;
+  uint32_t submitted;
+  uint32_t completed;
+  uint32_t errors;
+  uint16_t depth;
+  uint16_t max_depth;
+} i2c_queue_t;
+
+void i2c_queue_init(i2c_queue_t *q);
+
+// Appends txn; *start is set when the bus was idle and txn must be started
+// now. Returns false (and leaves txn untouched) if it is already pending.
+bool i2c_queue_push(i2c_queue_t *q, i2c_txn_t *txn, bool *start);
+
+// Retires the active transaction with the given outcome and returns the next
+// one to start, or NULL if the bus goes idle.
+i2c_txn_t *i2c_queue_complete(i2c_queue_t *q, bool ok, uint32_t abort_source);
+
+static inline i2c_txn_t *i2c_queue_active(const i2c_queue_t *q) {
+  return q->head;
+}
+
+static inline bool i2c_txn_pending(const i2c_txn_t *txn) {
+  return txn->status == I2C_TXN_QUEUED || txn->status == I2C_TXN_ACTIVE;
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "idle.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include <stdio.h>
+#include <string.h>
+#if !PICO_RISCV
+#include "hardware/structs/scb.h"
+#endif
+
+typedef struct {
+  idle_stats_t stats;
+  uint32_t deadline_us;
+  bool deadline_set;
+  volatile bool kicked;
+  bool ready;
+  uint alarm;              // hardware alarm for the deadline
+  uint32_t mark_us;        // end of the last sleep, or of the last pass
+  uint32_t window_start_us;
+  uint32_t window_busy_us;
+  uint32_t window_wakes;
+} idle_core_t;
+
+static idle_core_t m_core[NUM_CORES];
+static uint32_t m_report_us;
+
+// Nothing to do: taking the interrupt is what ends the WFE
+static void idle_alarm_irq(uint alarm) {}
+
+// Per core, on the first idle_sleep(): the alarm interrupt is enabled on
+// the core that registers it
+static void idle_core_init(idle_core_t *c, uint32_t now) {
+  c->alarm = hardware_alarm_claim_unused(true);
+  hardware_alarm_set_callback(c->alarm, idle_alarm_irq);
+#if !PICO_RISCV
+  // An interrupt raised between the last check and the WFE still wakes it
+  hw_set_bits(&scb_hw->scr, M33_SCR_SEVONPEND_BITS);
+#endif
+  c->mark_us = c->window_start_us = now;
+  c->ready = true;
+}
+
+static void idle_account(idle_core_t *c, uint32_t now, bool woke) {
+  uint32_t d = now - c->mark_us;
+
+  if (woke) {
+    c->stats.idle_us += d;
+    c->stats.wakes++;
+    c->window_wakes++;
+  } else {
+    c->stats.busy_us += d;
+    c->window_busy_us += d;
+  }
+  c->mark_us = now;
+
+  uint32_t window = now - c->window_start_us;
+  if (window >= IDLE_WINDOW_US) {
+    c->stats.duty_permille = (uint64_t)c->window_busy_us * 1000 / window;
+    c->stats.wakes_per_s = (uint64_t)c->window_wakes * 1000000 / window;
+    c->window_start_us = now;
+    c->window_busy_us = 0;
+    c->window_wakes = 0;
+  }
+}
+
+void idle_wake_at(uint32_t t_us) {
+  idle_core_t *c = &m_core[get_core_num()];
+
+  if (!c->deadline_set || (int32_t)(t_us - c->deadline_us) < 0) {
+    c->deadline_us = t_us;
+    c->deadline_set = true;
+  }
+}
+
+void idle_kick(void) {
+  for (int i = 0; i < NUM_CORES; i++)
+    m_core[i].kicked = true;
+  // Sets the event register on both cores, so a WFE about to start returns
+  __sev();
+}
+
+void idle_sleep(void) {
+  idle_core_t *c = &m_core[get_core_num()];
+  uint32_t now = time_us_32();
+  int32_t wait = c->deadline_set ? (int32_t)(c->deadline_us - now)
+                                 : IDLE_MAX_SLEEP_US;
+
+  if (!c->ready)
+    idle_core_init(c, now);
+  c->deadline_set = false;
+  c->stats.passes++;
+  idle_account(c, now, false);
+  if (c->kicked || wait < IDLE_MIN_SLEEP_US) {
+    c->kicked = false;
+    return;
+  }
+  if (wait > IDLE_MAX_SLEEP_US)
+    wait = IDLE_MAX_SLEEP_US;
+
+  // One WFE: it ends at the deadline, on any interrupt or on a kick. The
+  // event register may still be set from an interrupt during the pass;
+  // that costs one extra pass, and that interrupt may have left work.
+  if (!hardware_alarm_set_target(c->alarm,
+                                 delayed_by_us(get_absolute_time(), wait)))
+    __wfe();
+  hardware_alarm_cancel(c->alarm);
+  idle_account(c, time_us_32(), true);
+}
+
+void idle_get_stats(unsigned core, idle_stats_t *stats) {
+  *stats = m_core[core].stats;
+}
+
+void idle_reset_stats(void) {
+  for (int i = 0; i < NUM_CORES; i++)
+    memset(&m_core[i].stats, 0, sizeof(m_core[i].stats));
+}
+
+void idle_report_task(void) {
+  uint32_t now = time_us_32();
+  idle_stats_t s;
+
+  if (now - m_report_us < IDLE_REPORT_US)
+    return;
+  m_report_us = now;
+  for (unsigned i = 0; i < NUM_CORES; i++) {
+    idle_get_stats(i, &s);
+    if (!s.passes)
+      continue;
+    printf("idle core%u: busy %u.%u%%, %u wakes/s\r\n", i,
+           s.duty_permille / 10, s.duty_permille % 10, s.wakes_per_s);
+  }
+}
@@ -0,0 +1,47 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Idle manager for the main loops. Each pass runs every task; a task with
+// timed work ahead says when it next needs to run (idle_wake_at), and
+// idle_sleep() at the end of the pass waits in WFE until the earliest of
+// those. Any interrupt ends the wait too (SEVONPEND is set, so one raised
+// just before the WFE still counts), which is how USB, touch, DMA and TE
+// events get in. Work handed to a loop from outside an interrupt, say from
+// the other core or from a task that runs after its consumer, is flagged
+// with idle_kick() so the loop takes another pass instead of sleeping.
+//
+// Per core: a core's loop sets deadlines for and sleeps on that core only.
+// The time between sleeps counts as busy, the time in them as idle; over
+// each IDLE_WINDOW_US that gives the core's duty cycle and wake rate.
+
+// Shorter sleeps aren't worth arming the alarm for; the loop just runs on
+#define IDLE_MIN_SLEEP_US 50
+// Longest sleep with no deadline set, a backstop against a lost wakeup
+#define IDLE_MAX_SLEEP_US 100000
+#define IDLE_WINDOW_US 1000000
+// idle_report_task() prints both cores this often
+#define IDLE_REPORT_US 10000000
+
+typedef struct {
+  uint32_t passes;        // idle_sleep() calls, slept or not
+  uint32_t wakes;         // sleeps ended, by deadline, interrupt or kick
+  uint32_t busy_us;       // since the last reset
+  uint32_t idle_us;
+  uint16_t duty_permille; // busy share of the last full window
+  uint16_t wakes_per_s;   // wakes in the last full window
+} idle_stats_t;
+
+// Deadline for this pass, as a time_us_32() value; the earliest one wins
+void idle_wake_at(uint32_t t_us);
+// Next idle_sleep() on either core returns at once; any core or interrupt
+void idle_kick(void);
+void idle_sleep(void);
+
+void idle_get_stats(unsigned core, idle_stats_t *stats);
+void idle_reset_stats(void);
+void idle_report_task(void);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Single-writer sequence lock for publishing small snapshots (IMU attitude,
+// battery state, ...) to readers on the other core without taking a lock.
+// The writer bumps the counter to odd before touching the payload and back to
+// even afterwards; a reader retries if it saw an odd counter or the counter
+// moved while it was copying.
+//
+//   writer: seqlock_write_begin(&seq); copy payload; seqlock_write_end(&seq);
+//   reader: do { s = seqlock_read_begin(&seq); copy payload; }
+//           while (seqlock_read_retry(&seq, s));
+//
+// A reader running in an IRQ that preempted the writer on the same core can
+// never succeed, so IRQ-context readers must bound their retries.
+
+typedef volatile uint32_t seqlock_t;
+
+static inline void seqlock_write_begin(seqlock_t *seq) {
+  *seq = *seq + 1;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void seqlock_write_end(seqlock_t *seq) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  *seq = *seq + 1;
+}
+
+static inline uint32_t seqlock_read_begin(seqlock_t *seq) {
+  uint32_t s = *seq;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  return s;
+}
+
+static inline bool seqlock_read_retry(seqlock_t *seq, uint32_t start) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  return (start & 1u) || *seq != start;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Lock-free single-producer single-consumer queue of fixed-size items, for
+// handing messages from one core (or an IRQ) to another. Only the producer
+// writes head and only the consumer writes tail, so neither side ever waits;
+// a push into a full queue fails and is counted in dropped.
+//
+//   static msg_t storage[16]; // power of two
+//   static spsc_queue_t q = SPSC_QUEUE_INIT(storage);
+//
+// Hardware independent.
+
+typedef struct {
+  uint8_t *buf;
+  uint32_t item_size;
+  uint32_t mask;          // capacity - 1
+  volatile uint32_t head; // items pushed
+  volatile uint32_t tail; // items popped
+  uint32_t dropped;       // pushes refused while full (producer side)
+} spsc_queue_t;
+
+#define SPSC_QUEUE_INIT(storage)                                               \
+  {(uint8_t *)(storage), sizeof((storage)[0]),                                 \
+   sizeof(storage) / sizeof((storage)[0]) - 1, 0, 0, 0}
+
+static inline bool spsc_queue_push(spsc_queue_t *q, const void *item) {
+  uint32_t head = q->head;
+  if (head - q->tail > q->mask) {
+    q->dropped++;
+    return false;
+  }
+  // The consumer is done with the slot once it has moved tail past it
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  memcpy(q->buf + (head & q->mask) * q->item_size, item, q->item_size);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  q->head = head + 1;
+  return true;
+}
+
+static inline bool spsc_queue_pop(spsc_queue_t *q, void *item) {
+  uint32_t tail = q->tail;
+  if (q->head == tail)
+    return false;
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  memcpy(item, q->buf + (tail & q->mask) * q->item_size, q->item_size);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  q->tail = tail + 1;
+  return true;
+}
+
+static inline uint32_t spsc_queue_pending(const spsc_queue_t *q) {
+  return q->head - q->tail;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include "sys_clock.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "idle.h"
+#include "pico/multicore.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include <string.h>
+
+static const sys_clock_domain_t *m_domains[SYS_CLOCK_MAX_DOMAINS];
+static volatile unsigned m_domain_count;
+static sys_clock_stats_t m_stats;
+static uint32_t m_pll_hz;
+static uint m_core;
+static bool m_ready;
+static bool m_high = true;
+static uint32_t m_level_us;           // when the current level began
+static volatile bool m_holding;       // a boost within the hold time
+static volatile uint32_t m_demand_us; // last boost
+
+void sys_clock_init(void) {
+  m_pll_hz = clock_get_hz(clk_sys);
+  m_core = get_core_num();
+  m_level_us = m_demand_us = time_us_32();
+  m_holding = true;
+  m_ready = true;
+}
+
+bool sys_clock_register(const sys_clock_domain_t *domain) {
+  uint32_t save = save_and_disable_interrupts();
+  bool ok = m_domain_count < SYS_CLOCK_MAX_DOMAINS;
+
+  if (ok) {
+    m_domains[m_domain_count] = domain;
+    __dmb();
+    m_domain_count++;
+  }
+  restore_interrupts(save);
+  return ok;
+}
+
+static void sys_clock_account(uint32_t now) {
+  if (m_high)
+    m_stats.high_us += now - m_level_us;
+  else
+    m_stats.low_us += now - m_level_us;
+  m_level_us = now;
+}
+
+static bool sys_clock_quiet(unsigned count) {
+  for (unsigned i = 0; i < count; i++) {
+    if (m_domains[i]->quiet && !m_domains[i]->quiet())
+      return false;
+  }
+  return true;
+}
+
+static bool sys_clock_switch(bool high) {
+  uint32_t t0 = time_us_32();
+  uint32_t hz = high ? m_pll_hz : m_pll_hz / SYS_CLOCK_LOW_DIV;
+  unsigned count = m_domain_count;
+  // The other core may be running from PSRAM or mid-way through a transfer
+  // it set up; once parked it touches nothing until the domains are retimed
+  bool park = multicore_lockout_victim_is_initialized(m_core ^ 1);
+
+  // A busy domain is usually busy for a while (a flush, display bring-up);
+  // ask first, so the retries don't stop the other core every time
+  if (!sys_clock_quiet(count) ||
+      (park && !multicore_lockout_start_timeout_us(SYS_CLOCK_LOCKOUT_US))) {
+    m_stats.deferred++;
+    return false;
+  }
+  // It may have started something since; this answer holds until restore
+  uint32_t save = save_and_disable_interrupts();
+  bool quiet = sys_clock_quiet(count);
+  if (quiet) {
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, m_pll_hz,
+                    hz);
+    for (unsigned i = 0; i < count; i++)
+      m_domains[i]->retime(hz);
+  }
+  restore_interrupts(save);
+  if (park)
+    multicore_lockout_end_blocking();
+
+  uint32_t now = time_us_32();
+  if (!quiet) {
+    m_stats.deferred++;
+    return false;
+  }
+  sys_clock_account(now);
+  m_high = high;
+  m_stats.switches++;
+  if (now - t0 > m_stats.switch_us_max)
+    m_stats.switch_us_max = now - t0;
+  return true;
+}
+
+void sys_clock_boost(void) {
+  m_demand_us = time_us_32();
+  m_holding = true;
+  if (m_high || !m_ready)
+    return;
+  m_stats.boosts++;
+  if (get_core_num() == m_core && !__get_current_exception())
+    sys_clock_task();
+  else
+    idle_kick();
+}
+
+bool sys_clock_is_high(void) {
+  return m_high;
+}
+
+void sys_clock_task(void) {
+  uint32_t now = time_us_32();
+
+  if (!m_ready || get_core_num() != m_core)
+    return;
+  if (m_holding && now - m_demand_us >= SYS_CLOCK_HOLD_US)
+    m_holding = false;
+  if (m_holding != m_high && !sys_clock_switch(m_holding))
+    idle_wake_at(now + SYS_CLOCK_RETRY_US);
+  // Back down once the hold runs out
+  if (m_high && m_holding)
+    idle_wake_at(m_demand_us + SYS_CLOCK_HOLD_US);
+}
+
+// Any core; the current level counts up to now
+void sys_clock_get_stats(sys_clock_stats_t *stats) {
+  uint32_t d = time_us_32() - m_level_us;
+
+  *stats = m_stats;
+  if (m_high)
+    stats->high_us += d;
+  else
+    stats->low_us += d;
+}
+
+void sys_clock_reset_stats(void) {
+  uint32_t save = save_and_disable_interrupts();
+
+  memset(&m_stats, 0, sizeof(m_stats));
+  m_level_us = time_us_32();
+  restore_interrupts(save);
+}
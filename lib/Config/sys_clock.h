@@ -0,0 +1,65 @@
+#ifndef SYS_CLOCK_H
+#define SYS_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Clock-domain manager. clk_sys runs straight from PLL_SYS while anything
+// has asked for throughput in the last SYS_CLOCK_HOLD_US (a frame to draw,
+// keys or mouse reports going out), and from PLL_SYS / SYS_CLOCK_LOW_DIV
+// otherwise. The PLL never moves: clock_configure() moves clk_sys over to
+// clk_ref, sets the aux source and divider and switches back, so clk_sys
+// briefly runs from clk_ref. clk_peri, clk_usb, clk_adc and the timer tick
+// keep their own sources.
+//
+// Everything else timed from clk_sys registers a domain: the QSPI PIO
+// dividers, I2C SCL, the backlight PWM, the PSRAM window. Changes are made
+// on the core that called sys_clock_init(), from sys_clock_task() or from a
+// boost there. Each domain is first asked whether it is quiet, with no DMA
+// or bus transfer in flight; only once all are is the other core parked
+// (multicore lockout) and interrupts turned off, and the domains asked
+// again. If they are still quiet, clk_sys is switched and every domain
+// retimed before anything else runs; if not, the change waits for a later
+// pass, without having disturbed the other core.
+
+#define SYS_CLOCK_LOW_DIV 3         // 50 MHz; USB needs clk_sys >= 48 MHz
+#define SYS_CLOCK_HOLD_US 200000    // full speed this long after a boost
+#define SYS_CLOCK_RETRY_US 1000     // after a change put off by a busy domain
+#define SYS_CLOCK_LOCKOUT_US 1000   // for the other core to park
+#define SYS_CLOCK_MAX_DOMAINS 8
+
+typedef struct {
+  const char *name;
+  // Nothing in flight that a change would break; NULL if always. Asked
+  // once with interrupts on, then again with them off
+  bool (*quiet)(void);
+  // Reprogram for the new clk_sys. Runs with interrupts off and the other
+  // core parked, so must not wait on either
+  void (*retime)(uint32_t sys_hz);
+} sys_clock_domain_t;
+
+typedef struct {
+  uint32_t boosts;        // boosts that found the clock low
+  uint32_t switches;
+  uint32_t deferred;      // by a busy domain or a core that didn't park
+  uint32_t high_us;       // at each level, since the last reset
+  uint32_t low_us;
+  uint32_t switch_us_max; // longest change, other core parked throughout
+} sys_clock_stats_t;
+
+// Once clk_sys runs from PLL_SYS at full speed; the calling core makes the
+// changes from then on
+void sys_clock_init(void);
+// The domain must stay valid; false if the table is full
+bool sys_clock_register(const sys_clock_domain_t *domain);
+
+// Full speed for the next SYS_CLOCK_HOLD_US; at once if called on the
+// managing core outside an interrupt, otherwise on its next pass. Any core
+void sys_clock_boost(void);
+bool sys_clock_is_high(void);
+void sys_clock_task(void);
+
+void sys_clock_get_stats(sys_clock_stats_t *stats);
+void sys_clock_reset_stats(void);
+
+#endif
@@ -28,9 +28,20 @@
 ******************************************************************************/
 #include "DEV_Config.h"
 #include "LCD_3IN49.h"
+#include "boot_prof.h"
+#include "frame_prof.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include <string.h>
 
 LCD_3IN49_ATTRIBUTES LCD_3IN49;
 
+static void LCD_3IN49_Flush_Segment(void);
+static void LCD_3IN49_Rle_Batch(void);
+#if LCD_3IN49_TE_PIN >= 0
+static void LCD_3IN49_TE_Init(void);
+#endif
+
 /********************************************************************************
 function:	Sets the start position and size of the display area
 parameter:
@@ -39,27 +50,19 @@ parameter:
 		Ystart  :   Y direction Start coordinates
 		Xend    :   X direction end coordinates
 		Yend    :   Y direction end coordinates
+info     :	Coordinates are in the current orientation. In HORIZONTAL the
+            controller's MV bit makes CASET select along the long side and
+            RASET along the short one, so no swapping is needed here.
+            Rows are panel memory rows: unlike the flush calls, this is not
+            remapped when hardware scroll is on.
 ********************************************************************************/
 void LCD_3IN49_SetWindows(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend){
-    QSPI_Select(qspi); 
-    QSPI_REGISTER_Write(qspi, 0x2a); 
-    QSPI_DATA_Write(qspi, Xstart>>8);
-    QSPI_DATA_Write(qspi, Xstart&0xff);
-    QSPI_DATA_Write(qspi, (Xend-1)>>8);
-    QSPI_DATA_Write(qspi, (Xend-1)&0xff);
-    QSPI_Deselect(qspi); 
-    
-    QSPI_Select(qspi); 
-    QSPI_REGISTER_Write(qspi, 0x2b);
-    QSPI_DATA_Write(qspi, Ystart>>8);
-    QSPI_DATA_Write(qspi, Ystart&0xff);
-    QSPI_DATA_Write(qspi, (Yend-1)>>8);
-    QSPI_DATA_Write(qspi, (Yend-1)&0xff);
-    QSPI_Deselect(qspi); 
-    
-    QSPI_Select(qspi); 
-    QSPI_REGISTER_Write(qspi, 0x2c);
-    QSPI_Deselect(qspi); 
+    uint8_t caset[4] = {Xstart>>8, Xstart&0xff, (Xend-1)>>8, (Xend-1)&0xff};
+    uint8_t raset[4] = {Ystart>>8, Ystart&0xff, (Yend-1)>>8, (Yend-1)&0xff};
+
+    LCD_3IN49_Flush_Wait();
+    QSPI_Command_Write(qspi, 0x2a, caset, 4);
+    QSPI_Command_Write(qspi, 0x2b, raset, 4);
 }
 
 typedef struct {
@@ -100,51 +103,90 @@ static const sh8601_lcd_init_cmd_t lcd_init_cmds[] =
     {0xA4, (uint8_t []){0x85, 0x85, 0x95, 0x82, 0xAF, 0xAA, 0xAA, 0x80, 0x10, 0x30, 0x40, 0x40, 0x20, 0xFF, 0x60, 0x30}, 16, 0},
     {0xA4, (uint8_t []){0x85, 0x85, 0x95, 0x85}, 4, 0},
     {0xBB, (uint8_t []){0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 8, 0},
+#if LCD_3IN49_TE_PIN >= 0
+    // TEON, V-blank only
+    {0x35, (uint8_t []){0x00}, 1, 0},
+#endif
 
     // {0x11,(uint8_t []){0x00},0,100},
     // {0x29,(uint8_t []){0x00},0,100},
 };
 
+#define LCD_INIT_BATCH_BYTES 256
+
+/******************************************************************************
+function :	Start streaming a batch of init frames
+parameter:
+        buf     :   frames, a whole number of words
+        len     :   bytes in buf
+info     :	Waits for the previous batch, so the caller may refill the other
+            buffer while this one is on the bus
+******************************************************************************/
+static void LCD_3IN49_Send_Init_Batch(const uint8_t *buf, size_t len){
+    dma_channel_config cfg = dma_channel_get_default_config(dma_tx);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_bswap(&cfg, true);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(qspi.pio, qspi.sm, true));
+    channel_config_set_irq_quiet(&cfg, true);
+
+    dma_channel_wait_for_finish_blocking(dma_tx);
+    if (len)
+        dma_channel_configure(dma_tx, &cfg, &qspi.pio->txf[qspi.sm], buf, len / 4, true);
+}
+
 /******************************************************************************
 function :	Initialize the lcd register
 parameter:
         qspi    ：  qspi structure
+info     :	The command frames are built into two buffers in turn and
+            streamed by DMA, one batch per buffer, instead of being pushed
+            into the FIFO word by word. A command with a delay ends its
+            batch and is waited out on the wire.
 ******************************************************************************/
 static void LCD_3IN49_InitReg(){
-    // Traverse the initialization command array
+    static uint8_t buf[2][LCD_INIT_BATCH_BYTES] __attribute__((aligned(4)));
+    int cur = 0;
+    size_t len = 0;
+
     for (int i = 0; i < sizeof(lcd_init_cmds) / sizeof(lcd_init_cmds[0]); i++) 
     {
         const sh8601_lcd_init_cmd_t *cmd = &lcd_init_cmds[i];
-        
-        // Send commands and data
-        QSPI_Select(qspi);
-        QSPI_REGISTER_Write(qspi, cmd->cmd);
-        
-        // Write data byte
-        for (int j = 0; j < cmd->data_bytes; j++) {
-            QSPI_DATA_Write(qspi, cmd->data[j]);
+
+        if (len + QSPI_CMD_BYTES(cmd->data_bytes) > LCD_INIT_BATCH_BYTES) {
+            LCD_3IN49_Send_Init_Batch(buf[cur], len);
+            cur ^= 1;
+            len = 0;
         }
-        QSPI_Deselect(qspi);
-        
-        // Delay
+        len += QSPI_Build_Command(&buf[cur][len], cmd->cmd, cmd->data, cmd->data_bytes);
+
         if (cmd->delay_ms > 0) {
-            sleep_ms(cmd->delay_ms);
+            LCD_3IN49_Send_Init_Batch(buf[cur], len);
+            LCD_3IN49_Send_Init_Batch(NULL, 0);
+            QSPI_Wait_Idle(qspi);
+            boot_sleep_us(cmd->delay_ms * 1000);
+            cur ^= 1;
+            len = 0;
         }
     }
+    LCD_3IN49_Send_Init_Batch(buf[cur], len);
+    LCD_3IN49_Send_Init_Batch(NULL, 0);
 }
 
 /********************************************************************************
 function :	Reset the lcd
 parameter:
         qspi    ：  qspi structure
+info     :	Timings are LCD_3IN49_RESET_*; USB is serviced while waiting
 ********************************************************************************/
 static void LCD_3IN49_Reset(pio_qspi_t qspi){
     gpio_put(qspi.pin_rst,1);
-    DEV_Delay_ms(200);
+    boot_sleep_us(LCD_3IN49_RESET_SETTLE_US);
     gpio_put(qspi.pin_rst,0);
-    DEV_Delay_ms(200);
+    boot_sleep_us(LCD_3IN49_RESET_LOW_US);
     gpio_put(qspi.pin_rst,1);
-    DEV_Delay_ms(200);
+    boot_sleep_us(LCD_3IN49_RESET_WAIT_US);
 }
 
 /********************************************************************************
@@ -160,8 +202,158 @@ void LCD_3IN49_Init()
     //Set the initialization register
     LCD_3IN49_InitReg(qspi);
 
-    LCD_3IN49.HEIGHT  = LCD_3IN49_HEIGHT;
-    LCD_3IN49.WIDTH   = LCD_3IN49_WIDTH;
+    LCD_3IN49_Flush_Init();
+
+    //Set the resolution and scanning method of the screen
+    LCD_3IN49_SetAttributes(LCD_3IN49_SCAN_DIR);
+#if LCD_3IN49_TE_PIN >= 0
+    LCD_3IN49_TE_Init();
+#endif
+}
+
+/********************************************************************************
+function :	Set the resolution and scanning method of the screen
+parameter:
+        Scan_dir:   HORIZONTAL (640x172) or VERTICAL (172x640)
+info     :	Takes effect from the next window; what is already on the panel
+            stays where it is. Hardware scroll is turned off. Touch
+            coordinates have to follow, see Touch_Set_Scan_Dir.
+********************************************************************************/
+void LCD_3IN49_SetAttributes(UBYTE Scan_dir){
+    uint8_t madctl;
+
+    LCD_3IN49.SCAN_DIR = Scan_dir;
+    if (Scan_dir == HORIZONTAL) {
+        LCD_3IN49.WIDTH  = LCD_3IN49_HEIGHT;
+        LCD_3IN49.HEIGHT = LCD_3IN49_WIDTH;
+        madctl = LCD_3IN49_MADCTL_HORIZONTAL;
+    } else {
+        LCD_3IN49.WIDTH  = LCD_3IN49_WIDTH;
+        LCD_3IN49.HEIGHT = LCD_3IN49_HEIGHT;
+        madctl = LCD_3IN49_MADCTL_VERTICAL;
+    }
+
+    LCD_3IN49_Flush_Wait();
+    QSPI_Command_Write(qspi, 0x36, &madctl, 1);
+    // Scroll runs along memory rows, which are columns in HORIZONTAL
+    LCD_3IN49_SetScrollArea(0, 0);
+}
+
+/******************************************************************************
+function :	Check that register writes arrive intact at the current clock
+parameter:
+info     :	Writes test patterns to the brightness register and reads them
+            back; the read itself runs at the slow read clock
+******************************************************************************/
+#define LCD_CLOCK_TRIALS 8
+#define LCD_PIXEL_TRIALS 2
+#define LCD_PIXEL_W 8
+#define LCD_PIXEL_H 2
+#define LCD_PIXEL_READ 52 // a dummy byte and up to 3 bytes per pixel
+
+static bool LCD_3IN49_Check_Link(void){
+    static const uint8_t patterns[] = {0xff, 0x00, 0x55, 0xaa, 0x0f, 0xf0};
+    uint8_t v;
+
+    for (int t = 0; t < LCD_CLOCK_TRIALS; t++) {
+        for (size_t i = 0; i < sizeof(patterns); i++) {
+            QSPI_Command_Write(qspi, 0x51, &patterns[i], 1);
+            QSPI_Register_Read(qspi, 0x52, &v, 1);
+            if (v != patterns[i])
+                return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+function :	Write a pixel pattern through the flush path and read it back
+parameter:
+        Pattern :   LCD_PIXEL_W x LCD_PIXEL_H pixels, word aligned
+        Out     :   LCD_PIXEL_READ bytes as RAMRD returns them
+info     :	The window is at the top left; the splash covers it afterwards
+******************************************************************************/
+static const uint16_t lcd_pixel_pattern[2][LCD_PIXEL_W * LCD_PIXEL_H] __attribute__((aligned(4))) = {
+    {0xffff, 0x0000, 0x5555, 0xaaaa, 0x0f0f, 0xf0f0, 0x3333, 0xcccc,
+     0x0001, 0x0002, 0x0004, 0x0008, 0x1000, 0x2000, 0x4000, 0x8000},
+    {0x0000, 0xffff, 0xaaaa, 0x5555, 0xf0f0, 0x0f0f, 0xcccc, 0x3333,
+     0xfffe, 0xfffd, 0xfffb, 0xfff7, 0xefff, 0xdfff, 0xbfff, 0x7fff},
+};
+static uint8_t lcd_pixel_golden[2][LCD_PIXEL_READ];
+
+static void LCD_3IN49_Read_Pixels(const uint16_t *Pattern, uint8_t *Out){
+    LCD_3IN49_Flush_Async(0, 0, LCD_PIXEL_W, LCD_PIXEL_H, Pattern, NULL, NULL);
+    LCD_3IN49_Flush_Wait();
+    QSPI_Register_Read(qspi, 0x2e, Out, LCD_PIXEL_READ);
+}
+
+/******************************************************************************
+function :	Check that pixels written on all four lanes arrive intact
+parameter:
+info     :	Compares the read-back with what the first clock gave, so the
+            panel's RAMRD format does not matter
+******************************************************************************/
+static bool LCD_3IN49_Check_Pixels(void){
+    uint8_t v[LCD_PIXEL_READ];
+
+    for (int t = 0; t < LCD_PIXEL_TRIALS; t++) {
+        for (size_t i = 0; i < 2; i++) {
+            LCD_3IN49_Read_Pixels(lcd_pixel_pattern[i], v);
+            if (memcmp(v, lcd_pixel_golden[i], sizeof(v)) != 0)
+                return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+function :	Find the fastest QSPI clock this panel takes reliably
+parameter:
+        min_hz  :   first clock tried, expected to work
+        max_hz  :   last clock tried
+        step_hz :   increment between tries
+info     :	Steps the clock up until a register or pixel read-back
+            mismatches, then settles one step below the last clock that
+            passed. The pixel reference is read at min_hz; if the panel
+            gives the same bytes back for a pattern and its inverse, RAMRD
+            is of no use and only the single-lane register path is checked,
+            so the clock settles two steps below instead, leaving three
+            steps (7.5 MHz at the default step) to the first failure.
+            Returns the clock set, or 0 if even min_hz failed, in which case
+            the previous clock is kept. Either way the brightness read at the
+            start is written back over the test patterns.
+******************************************************************************/
+uint32_t LCD_3IN49_Calibrate_Clock(uint32_t min_hz, uint32_t max_hz, uint32_t step_hz){
+    uint32_t prev = QSPI_Get_Clock();
+    uint32_t good = 0;
+    uint8_t level;
+    bool pixels;
+
+    LCD_3IN49_Flush_Wait();
+    QSPI_Register_Read(qspi, 0x52, &level, 1);
+
+    QSPI_Set_Clock(qspi, min_hz);
+    for (size_t i = 0; i < 2; i++)
+        LCD_3IN49_Read_Pixels(lcd_pixel_pattern[i], lcd_pixel_golden[i]);
+    pixels = memcmp(lcd_pixel_golden[0], lcd_pixel_golden[1], LCD_PIXEL_READ) != 0;
+
+    for (uint32_t hz = min_hz; hz <= max_hz; hz += step_hz) {
+        QSPI_Set_Clock(qspi, hz);
+        if (!LCD_3IN49_Check_Link() || (pixels && !LCD_3IN49_Check_Pixels()))
+            break;
+        good = hz;
+    }
+
+    if (good == 0) {
+        QSPI_Set_Clock(qspi, prev);
+        QSPI_Command_Write(qspi, 0x51, &level, 1);
+        return 0;
+    }
+    for (int n = pixels ? 1 : 2; n > 0 && good - min_hz >= step_hz; n--)
+        good -= step_hz;
+    QSPI_Set_Clock(qspi, good);
+    QSPI_Command_Write(qspi, 0x51, &level, 1);
+    return QSPI_Get_Clock();
 }
 
 /******************************************************************************
@@ -169,36 +361,24 @@ function :	Clear screen
 parameter:
 ******************************************************************************/
 void LCD_3IN49_Clear(UWORD Color) {
-    // Color data
-    UWORD i;
-	UWORD image[LCD_3IN49.WIDTH];
-	for(i=0;i<LCD_3IN49.WIDTH;i++){
-		image[i] = Color>>8 | (Color&0xff)<<8;
-	}
-	UBYTE *partial_image = (UBYTE *)(image);
-
-    // Send command in one-line mode
-    // QSPI_1Wrie_Mode(&qspi);
-    LCD_3IN49_SetWindows(0,0,LCD_3IN49.WIDTH,LCD_3IN49.HEIGHT);
-    QSPI_Select(qspi);
-    QSPI_Pixel_Write(qspi,0x2c);
-
-    // Four-wire mode sends RGB data
-    // QSPI_4Wrie_Mode(&qspi);
-    channel_config_set_dreq(&c, pio_get_dreq(qspi.pio, qspi.sm, true));
-    for (int i = 0; i <= LCD_3IN49.HEIGHT; i++) {
-        dma_channel_configure(dma_tx, 
-                            &c,
-                            &qspi.pio->txf[qspi.sm],  // Destination pointer (PIO TX FIFO)
-                            partial_image,            // Source pointer (data buffer)
-                            LCD_3IN49.WIDTH*2,     // Data length (unit: number of transmissions)
-                            true);                    // Start transferring immediately
-        
-        // Waiting for DMA transfer to complete
-        while(dma_channel_is_busy(dma_tx));
-    }
+    LCD_3IN49_Fill_Async(0, 0, LCD_3IN49.WIDTH, LCD_3IN49.HEIGHT, Color, NULL, NULL);
+    LCD_3IN49_Flush_Wait();
+}
+
+/******************************************************************************
+function :	Show a prerendered splash
+parameter:
+        Image   ：  sent from flash as is, at most the screen size
+        Bg      :   RGB565 colour around the image
+info     :	The image is centred; two DMA kicks and no framebuffer
+******************************************************************************/
+void LCD_3IN49_Splash(const LCD_3IN49_IMAGE *Image, UWORD Bg) {
+    uint32_t x = (LCD_3IN49.WIDTH - Image->WIDTH) / 2 & ~1u;
+    uint32_t y = (LCD_3IN49.HEIGHT - Image->HEIGHT) / 2 & ~1u;
 
-    QSPI_Deselect(qspi);
+    LCD_3IN49_Fill_Async(0, 0, LCD_3IN49.WIDTH, LCD_3IN49.HEIGHT, Bg, NULL, NULL);
+    LCD_3IN49_Image_Async(x, y, Image, NULL, NULL);
+    LCD_3IN49_Flush_Wait();
 }
 
 /******************************************************************************
@@ -208,25 +388,8 @@ parameter:
 ******************************************************************************/
 void LCD_3IN49_Display(UWORD *Image)
 {
-    // Send command in one-line mode
-    // QSPI_1Wrie_Mode(&qspi);
-    LCD_3IN49_SetWindows(0,0,LCD_3IN49.WIDTH,LCD_3IN49.HEIGHT);
-    QSPI_Select(qspi);
-    QSPI_Pixel_Write(qspi,0x2c);
-
-    // Four-wire mode sends RGB data
-    // QSPI_4Wrie_Mode(&qspi);
-    channel_config_set_dreq(&c, pio_get_dreq(qspi.pio, qspi.sm, true));
-    dma_channel_configure(dma_tx, 
-                        &c,
-                        &qspi.pio->txf[qspi.sm],  // Destination pointer (PIO TX FIFO)
-                        (UBYTE *)Image,           // Source pointer (data buffer)
-                        (LCD_3IN49.WIDTH+1)*(LCD_3IN49.HEIGHT+1)*2,   // Data length (unit: number of transmissions)
-                        true);                    // Start transferring immediately
-    
-    // Waiting for DMA transfer to complete
-    while(dma_channel_is_busy(dma_tx));
-    QSPI_Deselect(qspi);             
+    LCD_3IN49_Flush_Async(0, 0, LCD_3IN49.WIDTH, LCD_3IN49.HEIGHT, Image, NULL, NULL);
+    LCD_3IN49_Flush_Wait();
 }
 
 /******************************************************************************
@@ -237,35 +400,613 @@ parameter:
 		Xend    :   X direction end coordinates
 		Yend    :   Y direction end coordinates
         Image   ：  Image data
+info     :  Xstart and Xend must be even: rows are sent as whole words
 ******************************************************************************/
 void LCD_3IN49_DisplayWindows(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend, UWORD *Image) {
-    // Send command in one-line mode
-    // QSPI_1Wrie_Mode(&qspi);
-    LCD_3IN49_SetWindows(Xstart, Ystart, Xend, Yend);
-    QSPI_Select(qspi);
-    QSPI_Pixel_Write(qspi, 0x2c);
-
-    // Four-wire mode sends RGB data
-    // QSPI_4Wrie_Mode(&qspi);
-    channel_config_set_dreq(&c, pio_get_dreq(qspi.pio, qspi.sm, true));
-
-    int i;
-    uint32_t pixel_offset;
-    UBYTE *partial_image;
-    for (i = Ystart; i < Yend; i++) {
-        pixel_offset = (i * LCD_3IN49.WIDTH + Xstart) * 2;
-        partial_image = (UBYTE *)Image + pixel_offset;
-
-        dma_channel_configure(dma_tx, 
-                            &c,
-                            &qspi.pio->txf[qspi.sm],  // Destination pointer (PIO TX FIFO)
-                            partial_image,            // Source pointer (data buffer)
-                            (Xend-Xstart)*2,          // Data length (unit: number of transmissions)
-                            true);                    // Start transferring immediately
-
-        // Waiting for DMA transfer to complete
-        while(dma_channel_is_busy(dma_tx));
+    LCD_3IN49_Blit_Async(Xstart, Ystart, Xend, Yend,
+                         Image + Ystart * LCD_3IN49.WIDTH + Xstart, LCD_3IN49.WIDTH,
+                         NULL, NULL);
+    LCD_3IN49_Flush_Wait();
+}
+
+/******************************************************************************
+function :	Hardware vertical scroll
+info     :	VSCRDEF splits the panel rows into a fixed top, a scroll area and
+            a fixed bottom, and VSCSAD picks the memory row shown first in
+            the scroll area. The area is a ring: moving the start shifts
+            everything in it without resending a pixel. Writes still address
+            memory, so the flush calls map their window from screen rows
+            onto the ring and send one segment per run of rows that is
+            contiguous there.
+******************************************************************************/
+static uint32_t lcd_scroll_top;
+static uint32_t lcd_scroll_height;  // 0: off, screen rows are memory rows
+static uint32_t lcd_scroll_offset;
+
+static void LCD_3IN49_Send_Scroll_Start(void){
+    uint32_t vsp = lcd_scroll_top + lcd_scroll_offset;
+    uint8_t vscsad[2] = {vsp>>8, vsp&0xff};
+
+    QSPI_Command_Write(qspi, 0x37, vscsad, 2);
+}
+
+/******************************************************************************
+function :	Set the hardware scroll area
+parameter:
+		Top     :   first panel row of the scroll area, even
+		Height  :   rows in the area, even; 0 turns hardware scroll off
+info     :	The offset starts at 0, so what is on the panel stays put.
+            Only available in VERTICAL.
+******************************************************************************/
+void LCD_3IN49_SetScrollArea(uint32_t Top, uint32_t Height){
+    if (LCD_3IN49.SCAN_DIR == HORIZONTAL || Top + Height > LCD_3IN49_HEIGHT)
+        Height = 0;
+    if (Height == 0)
+        Top = 0;
+    uint32_t vsa = Height ? Height : LCD_3IN49_HEIGHT;
+    uint32_t bfa = LCD_3IN49_HEIGHT - Top - vsa;
+    uint8_t vscrdef[6] = {Top>>8, Top&0xff, vsa>>8, vsa&0xff, bfa>>8, bfa&0xff};
+
+    LCD_3IN49_Flush_Wait();
+    lcd_scroll_top = Top;
+    lcd_scroll_height = Height;
+    lcd_scroll_offset = 0;
+    QSPI_Command_Write(qspi, 0x33, vscrdef, 6);
+    LCD_3IN49_Send_Scroll_Start();
+}
+
+/******************************************************************************
+function :	Shift the scroll area
+parameter:
+		Offset  :   rows the content is moved up, even, taken modulo the
+                    area height
+info     :	Waits for the flush in progress, which was mapped with the old
+            offset
+******************************************************************************/
+void LCD_3IN49_SetScrollStart(uint32_t Offset){
+    if (!lcd_scroll_height)
+        return;
+    LCD_3IN49_Flush_Wait();
+    lcd_scroll_offset = Offset % lcd_scroll_height;
+    LCD_3IN49_Send_Scroll_Start();
+}
+
+uint32_t LCD_3IN49_GetScrollStart(void){
+    return lcd_scroll_offset;
+}
+
+// Memory row behind screen row y, and how many rows from y on follow it
+// without a break
+static uint32_t LCD_3IN49_Map_Row(uint32_t y, uint32_t *run){
+    uint32_t top = lcd_scroll_top;
+    uint32_t h = lcd_scroll_height;
+
+    if (h == 0 || y >= top + h) {
+        *run = UINT32_MAX;
+        return y;
+    }
+    if (y < top) {
+        *run = top - y;
+        return y;
     }
+    uint32_t i = y - top;
+    uint32_t j = (i + lcd_scroll_offset) % h;
+    *run = h - (i > j ? i : j);
+    return top + j;
+}
+
+/******************************************************************************
+function :	Chained DMA flush
+info     :	A flush is a list of control blocks that a second DMA channel
+            loads into dma_tx's alias-1 registers (CTRL, READ, WRITE,
+            TRANS_COUNT_TRIG) one at a time. dma_tx chains back to the
+            control channel after each block, and the zero-length block at
+            the end is a null trigger that raises the interrupt, since the
+            data blocks are IRQ_QUIET. The CASET/RASET/RAMWR frames are
+            prebuilt; only the coordinate bytes and the pixel length in the
+            RAMWR header are patched per flush.
+
+            The middle block is the pixel source. A fill reads one colour word
+            without incrementing. A blit of a sub-rectangle sends its first
+            row from that block, then chains to a row channel that writes the
+            next row address from a table into dma_tx's READ_ADDR_TRIG alias,
+            restarting it with the same count; a zero at the end of the table
+            is the null trigger.
+
+            An RLE image has a block per run instead: a run reads its colour
+            word like a fill, a literal stretch reads its words like a copy,
+            straight from the image. Blocks are patched in batches of
+            LCD_RLE_BATCH between the command frames and the null trigger;
+            the interrupt of each batch patches and starts the next one from
+            block 1, so the pixel frame just carries on.
+
+            A window split by the scroll ring goes out as one such chain per
+            segment; the interrupt of each starts the next.
+******************************************************************************/
+typedef struct {
+    uint32_t ctrl;
+    uint32_t read_addr;
+    uint32_t write_addr;
+    uint32_t transfer_count;
+} lcd_dma_block_t;
+
+// Control blocks and the row table are read by DMA as 32-bit words, so
+// addresses are kept as bus addresses rather than pointers
+#define LCD_DMA_ADDR(p) ((uint32_t)(uintptr_t)(p))
+
+#define LCD_CMD_CASET_OFFSET 0
+#define LCD_CMD_RASET_OFFSET QSPI_CMD_BYTES(4)
+#define LCD_CMD_RAMWR_OFFSET (2 * QSPI_CMD_BYTES(4))
+#define LCD_CMD_BYTES (2 * QSPI_CMD_BYTES(4) + QSPI_PIXEL_HEADER_BYTES)
+// Coordinate bytes follow the frame header and the opcode/address
+#define LCD_CMD_PARAM_OFFSET QSPI_CMD_BYTES(0)
+
+static uint lcd_ctrl_dma;
+static uint lcd_row_dma;
+static uint8_t lcd_cmd_bytes[LCD_CMD_BYTES] __attribute__((aligned(4)));
+#define LCD_RLE_BATCH 32
+static lcd_dma_block_t lcd_flush_chain[LCD_RLE_BATCH + 2];
+// The window being sent, in screen rows
+static struct {
+    uint32_t x0, x1;
+    uint32_t y, y1;     // next row to send, end row (exclusive)
+    uint32_t src;       // bus address of row y's pixels; for RLE, of the
+                        // current token's next data word
+    uint32_t pitch;     // source bytes per row; 0 for a fill or RLE
+    uint32_t ctrl;      // pixel block control when rows are contiguous
+    bool strided;       // rows are separate runs through the row table
+    const uint32_t *rle;    // next RLE token, NULL if not RLE
+    uint32_t rle_left;      // words left in the current token
+    bool rle_fill;          // the current token is a run
+    uint32_t words;         // RLE words left in the current segment
+} lcd_flush_win;
+static uint32_t lcd_copy_ctrl;
+static uint32_t lcd_fill_ctrl;
+static uint32_t lcd_blit_ctrl;
+static uint32_t lcd_fill_word;
+static uint32_t lcd_blit_rows[LCD_3IN49_HEIGHT];
+static LCD_3IN49_Flush_Cb lcd_flush_cb;
+static void *lcd_flush_user;
+static volatile bool lcd_flush_busy;
+static volatile bool lcd_flush_gated;
+static bool lcd_te_sync_next;
+static LCD_3IN49_Vsync_Cb lcd_vsync_cb;
+static void *lcd_vsync_user;
+static volatile uint32_t lcd_te_count;
+static volatile uint32_t lcd_te_last_us;
+static volatile uint32_t lcd_te_period_us;
+
+static void LCD_3IN49_Flush_IRQ(void){
+    uint32_t t0 = prof_now();
+    if (!dma_channel_get_irq0_status(dma_tx))
+        return;
+    dma_channel_acknowledge_irq0(dma_tx);
+    if (!lcd_flush_busy)
+        return;
+    if (lcd_flush_win.words) {
+        // Next batch of RLE runs, inside the same pixel frame
+        LCD_3IN49_Rle_Batch();
+        dma_channel_set_read_addr(lcd_ctrl_dma, &lcd_flush_chain[1], true);
+        prof_record(PROF_DMA_IRQ, t0, 0);
+        return;
+    }
+    if (lcd_flush_win.y < lcd_flush_win.y1) {
+        // Next segment of a window split by the scroll ring
+        LCD_3IN49_Flush_Segment();
+        dma_channel_set_read_addr(lcd_ctrl_dma, lcd_flush_chain, true);
+        prof_record(PROF_DMA_IRQ, t0, 0);
+        return;
+    }
+    lcd_flush_busy = false;
+    if (lcd_flush_cb)
+        lcd_flush_cb(lcd_flush_user);
+    prof_record(PROF_DMA_IRQ, t0, 0);
+}
+
+static uint32_t LCD_3IN49_Block_Ctrl(uint chain_to, bool read_increment){
+    dma_channel_config cfg = dma_channel_get_default_config(dma_tx);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_bswap(&cfg, true);
+    channel_config_set_read_increment(&cfg, read_increment);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(qspi.pio, qspi.sm, true));
+    channel_config_set_chain_to(&cfg, chain_to);
+    channel_config_set_irq_quiet(&cfg, true);
+    return channel_config_get_ctrl_value(&cfg);
+}
+
+/******************************************************************************
+function :	Claim the control and row channels and prebuild the flush frames
+parameter:
+******************************************************************************/
+void LCD_3IN49_Flush_Init(void){
+    static const uint8_t zero[4] = {0};
+
+    lcd_ctrl_dma = dma_claim_unused_channel(true);
+    dma_channel_config cc = dma_channel_get_default_config(lcd_ctrl_dma);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, true);
+    channel_config_set_write_increment(&cc, true);
+    // Wrap the writes around dma_tx's four alias-1 registers
+    channel_config_set_ring(&cc, true, 4);
+    dma_channel_configure(lcd_ctrl_dma, &cc, &dma_hw->ch[dma_tx].al1_ctrl,
+                          lcd_flush_chain, 4, false);
+
+    // One row address per trigger; the count of 1 reloads each time
+    lcd_row_dma = dma_claim_unused_channel(true);
+    dma_channel_config rc = dma_channel_get_default_config(lcd_row_dma);
+    channel_config_set_transfer_data_size(&rc, DMA_SIZE_32);
+    channel_config_set_read_increment(&rc, true);
+    channel_config_set_write_increment(&rc, false);
+    dma_channel_configure(lcd_row_dma, &rc, &dma_hw->ch[dma_tx].al3_read_addr_trig,
+                          lcd_blit_rows, 1, false);
 
-    QSPI_Deselect(qspi);
+    lcd_copy_ctrl = LCD_3IN49_Block_Ctrl(lcd_ctrl_dma, true);
+    lcd_fill_ctrl = LCD_3IN49_Block_Ctrl(lcd_ctrl_dma, false);
+    lcd_blit_ctrl = LCD_3IN49_Block_Ctrl(lcd_row_dma, true);
+
+    QSPI_Build_Command(&lcd_cmd_bytes[LCD_CMD_CASET_OFFSET], 0x2a, zero, 4);
+    QSPI_Build_Command(&lcd_cmd_bytes[LCD_CMD_RASET_OFFSET], 0x2b, zero, 4);
+    QSPI_Build_Pixel_Header(&lcd_cmd_bytes[LCD_CMD_RAMWR_OFFSET], 0x2c, 0);
+
+    lcd_dma_block_t *b = lcd_flush_chain;
+    for (int i = 0; i < LCD_RLE_BATCH + 2; i++)
+        b[i].write_addr = LCD_DMA_ADDR(&qspi.pio->txf[qspi.sm]);
+    b[0].ctrl = lcd_copy_ctrl;
+    b[0].read_addr = LCD_DMA_ADDR(lcd_cmd_bytes);
+    b[0].transfer_count = LCD_CMD_BYTES / 4;
+
+    dma_channel_set_irq0_enabled(dma_tx, true);
+    irq_add_shared_handler(DMA_IRQ_0, LCD_3IN49_Flush_IRQ,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+// Zero-length block: the null trigger that ends a chain with the interrupt
+static void LCD_3IN49_End_Chain(lcd_dma_block_t *b){
+    b->ctrl = lcd_copy_ctrl;
+    b->read_addr = 0;
+    b->transfer_count = 0;
+}
+
+/******************************************************************************
+function :	Patch the next segment of lcd_flush_win into the control blocks
+parameter:
+info     :	Sends as many rows as are contiguous in panel memory
+******************************************************************************/
+static void LCD_3IN49_Flush_Segment(void){
+    uint32_t run;
+    uint32_t my = LCD_3IN49_Map_Row(lcd_flush_win.y, &run);
+    uint32_t rows = lcd_flush_win.y1 - lcd_flush_win.y;
+    uint32_t w = lcd_flush_win.x1 - lcd_flush_win.x0;
+    lcd_dma_block_t *b = &lcd_flush_chain[1];
+
+    if (rows > run)
+        rows = run;
+
+    uint8_t *p = &lcd_cmd_bytes[LCD_CMD_CASET_OFFSET + LCD_CMD_PARAM_OFFSET];
+    p[0] = lcd_flush_win.x0>>8;
+    p[1] = lcd_flush_win.x0&0xff;
+    p[2] = (lcd_flush_win.x1-1)>>8;
+    p[3] = (lcd_flush_win.x1-1)&0xff;
+    p = &lcd_cmd_bytes[LCD_CMD_RASET_OFFSET + LCD_CMD_PARAM_OFFSET];
+    p[0] = my>>8;
+    p[1] = my&0xff;
+    p[2] = (my+rows-1)>>8;
+    p[3] = (my+rows-1)&0xff;
+    QSPI_Build_Pixel_Header(&lcd_cmd_bytes[LCD_CMD_RAMWR_OFFSET], 0x2c, w*rows*2);
+
+    if (lcd_flush_win.rle) {
+        lcd_flush_win.words = w*rows*2 / 4;
+        lcd_flush_win.y += rows;
+        LCD_3IN49_Rle_Batch();
+        return;
+    }
+    b->read_addr = lcd_flush_win.src;
+    if (lcd_flush_win.strided && rows > 1) {
+        for (uint32_t r = 1; r < rows; r++)
+            lcd_blit_rows[r - 1] = lcd_flush_win.src + r * lcd_flush_win.pitch;
+        lcd_blit_rows[rows - 1] = 0;
+        dma_channel_set_read_addr(lcd_row_dma, lcd_blit_rows, false);
+        b->ctrl = lcd_blit_ctrl;
+        b->transfer_count = w*2 / 4;
+    } else {
+        b->ctrl = lcd_flush_win.ctrl;
+        b->transfer_count = w*rows*2 / 4;
+    }
+    LCD_3IN49_End_Chain(&b[1]);
+    lcd_flush_win.y += rows;
+    lcd_flush_win.src += rows * lcd_flush_win.pitch;
+
+    // Control blocks are read by DMA; make sure the stores above land first
+    __dmb();
+}
+
+/******************************************************************************
+function :	Patch the next batch of RLE blocks into the control blocks
+parameter:
+info     :	From block 1, one block per run or literal stretch, until the
+            segment's words are covered or LCD_RLE_BATCH blocks are used. A
+            token that crosses the end of the segment is split and carried
+            into the next one.
+******************************************************************************/
+static void LCD_3IN49_Rle_Batch(void){
+    lcd_dma_block_t *b = &lcd_flush_chain[1];
+    int n = 0;
+
+    while (lcd_flush_win.words && n < LCD_RLE_BATCH) {
+        if (!lcd_flush_win.rle_left) {
+            uint32_t t = *lcd_flush_win.rle++;
+            lcd_flush_win.rle_left = t & ~LCD_3IN49_RLE_RUN;
+            lcd_flush_win.rle_fill = t & LCD_3IN49_RLE_RUN;
+            lcd_flush_win.src = LCD_DMA_ADDR(lcd_flush_win.rle);
+            lcd_flush_win.rle += lcd_flush_win.rle_fill ? 1 : lcd_flush_win.rle_left;
+            continue;
+        }
+        uint32_t words = lcd_flush_win.rle_left;
+        if (words > lcd_flush_win.words)
+            words = lcd_flush_win.words;
+        b[n].ctrl = lcd_flush_win.rle_fill ? lcd_fill_ctrl : lcd_copy_ctrl;
+        b[n].read_addr = lcd_flush_win.src;
+        b[n].transfer_count = words;
+        if (!lcd_flush_win.rle_fill)
+            lcd_flush_win.src += words * 4;
+        lcd_flush_win.rle_left -= words;
+        lcd_flush_win.words -= words;
+        n++;
+    }
+    LCD_3IN49_End_Chain(&b[n]);
+    __dmb();
+}
+
+/******************************************************************************
+function :	Start sending a window set up in lcd_flush_win
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates (exclusive)
+		Yend    :   Y direction end coordinates (exclusive)
+        cb      :   called from the DMA interrupt once the chain is done
+        user    :   passed to cb
+info     :	The caller has waited for the previous flush and set the pixel
+            source in lcd_flush_win
+******************************************************************************/
+static void LCD_3IN49_Flush_Start(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend,
+                                  LCD_3IN49_Flush_Cb cb, void *user){
+    lcd_flush_win.x0 = Xstart;
+    lcd_flush_win.x1 = Xend;
+    lcd_flush_win.y = Ystart;
+    lcd_flush_win.y1 = Yend;
+    LCD_3IN49_Flush_Segment();
+
+    lcd_flush_cb = cb;
+    lcd_flush_user = user;
+    lcd_flush_busy = true;
+
+    if (lcd_te_sync_next && LCD_3IN49_TE_Active()) {
+        // The TE interrupt starts the chain
+        lcd_te_sync_next = false;
+        lcd_flush_gated = true;
+        return;
+    }
+    lcd_te_sync_next = false;
+    dma_channel_set_read_addr(lcd_ctrl_dma, lcd_flush_chain, true);
+}
+
+/******************************************************************************
+function :	Send a window of pixels without CPU involvement
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates (exclusive)
+		Yend    :   Y direction end coordinates (exclusive)
+        Image   ：  (Xend-Xstart)*(Yend-Ystart) contiguous RGB565 pixels,
+                    byte-swapped (LV_COLOR_16_SWAP), word aligned, even count
+        cb      :   called from the DMA interrupt once Image may be reused
+        user    :   passed to cb
+******************************************************************************/
+void LCD_3IN49_Flush_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend,
+                           const void *Image, LCD_3IN49_Flush_Cb cb, void *user){
+    LCD_3IN49_Flush_Wait();
+
+    lcd_flush_win.src = LCD_DMA_ADDR(Image);
+    lcd_flush_win.pitch = (Xend-Xstart)*2;
+    lcd_flush_win.ctrl = lcd_copy_ctrl;
+    lcd_flush_win.strided = false;
+    lcd_flush_win.rle = NULL;
+    LCD_3IN49_Flush_Start(Xstart, Ystart, Xend, Yend, cb, user);
+}
+
+/******************************************************************************
+function :	Fill a window with one colour without CPU involvement
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates (exclusive)
+		Yend    :   Y direction end coordinates (exclusive)
+        Color   ：  RGB565 colour; the window must hold an even pixel count
+        cb      :   called from the DMA interrupt once the fill is sent
+        user    :   passed to cb
+******************************************************************************/
+void LCD_3IN49_Fill_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend,
+                          UWORD Color, LCD_3IN49_Flush_Cb cb, void *user){
+    UWORD swapped = Color>>8 | (Color&0xff)<<8;
+
+    LCD_3IN49_Flush_Wait();
+
+    lcd_fill_word = swapped | (uint32_t)swapped << 16;
+    lcd_flush_win.src = LCD_DMA_ADDR(&lcd_fill_word);
+    lcd_flush_win.pitch = 0;
+    lcd_flush_win.ctrl = lcd_fill_ctrl;
+    lcd_flush_win.strided = false;
+    lcd_flush_win.rle = NULL;
+    LCD_3IN49_Flush_Start(Xstart, Ystart, Xend, Yend, cb, user);
+}
+
+/******************************************************************************
+function :	Send a sub-rectangle of a larger framebuffer without CPU
+            involvement
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates (exclusive)
+		Yend    :   Y direction end coordinates (exclusive)
+        Image   ：  first pixel of the source rectangle, word aligned
+        Stride  :   source row pitch in pixels, even
+        cb      :   called from the DMA interrupt once Image may be reused
+        user    :   passed to cb
+info     :	Xstart and Xend must be even: rows are sent as whole words
+******************************************************************************/
+void LCD_3IN49_Blit_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend,
+                          const void *Image, uint32_t Stride,
+                          LCD_3IN49_Flush_Cb cb, void *user){
+    if (Stride == Xend - Xstart || Yend - Ystart <= 1) {
+        LCD_3IN49_Flush_Async(Xstart, Ystart, Xend, Yend, Image, cb, user);
+        return;
+    }
+
+    LCD_3IN49_Flush_Wait();
+
+    lcd_flush_win.src = LCD_DMA_ADDR(Image);
+    lcd_flush_win.pitch = Stride*2;
+    lcd_flush_win.ctrl = lcd_copy_ctrl;
+    lcd_flush_win.strided = true;
+    lcd_flush_win.rle = NULL;
+    LCD_3IN49_Flush_Start(Xstart, Ystart, Xend, Yend, cb, user);
+}
+
+/******************************************************************************
+function :	Send an RLE image to a window without CPU involvement per pixel
+parameter:
+		Xstart 	:   X direction Start coordinates
+		Ystart  :   Y direction Start coordinates
+		Xend    :   X direction end coordinates (exclusive)
+		Yend    :   Y direction end coordinates (exclusive)
+        Rle     ：  tokens covering the window exactly, see LCD_3IN49_IMAGE;
+                    read in place, so it must stay valid until cb
+        cb      :   called from the DMA interrupt once the image is sent
+        user    :   passed to cb
+info     :	The CPU only turns tokens into DMA blocks, LCD_RLE_BATCH at a
+            time from the interrupt; pixels are never copied or decoded
+******************************************************************************/
+void LCD_3IN49_Blit_RLE_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend, uint32_t Yend,
+                              const uint32_t *Rle, LCD_3IN49_Flush_Cb cb, void *user){
+    LCD_3IN49_Flush_Wait();
+
+    lcd_flush_win.pitch = 0;
+    lcd_flush_win.strided = false;
+    lcd_flush_win.rle = Rle;
+    lcd_flush_win.rle_left = 0;
+    LCD_3IN49_Flush_Start(Xstart, Ystart, Xend, Yend, cb, user);
+}
+
+/******************************************************************************
+function :	Send an image, RAW or RLE, with its top left corner at X, Y
+parameter:
+        X       :   even
+        Y       :   even
+        Image   ：  must fit on screen
+        cb      :   called from the DMA interrupt once the image is sent
+        user    :   passed to cb
+******************************************************************************/
+void LCD_3IN49_Image_Async(uint32_t X, uint32_t Y, const LCD_3IN49_IMAGE *Image,
+                           LCD_3IN49_Flush_Cb cb, void *user){
+    if (Image->FORMAT == LCD_3IN49_IMAGE_RLE)
+        LCD_3IN49_Blit_RLE_Async(X, Y, X + Image->WIDTH, Y + Image->HEIGHT,
+                                 Image->DATA, cb, user);
+    else
+        LCD_3IN49_Flush_Async(X, Y, X + Image->WIDTH, Y + Image->HEIGHT,
+                              Image->DATA, cb, user);
+}
+
+bool LCD_3IN49_Flush_Busy(void){
+    return lcd_flush_busy;
+}
+
+void LCD_3IN49_Flush_Wait(void){
+    while (lcd_flush_busy) {
+        LCD_3IN49_TE_Poll();
+        tight_loop_contents();
+    }
+}
+
+/******************************************************************************
+function :	Tear effect
+info     :	With TEON the panel pulses TE at the start of each vertical
+            blank. A flush armed with LCD_3IN49_Flush_Sync_Next is queued as
+            usual but its chain is started from the TE interrupt, so pixels
+            go out behind the scan instead of across it. The interrupt, the
+            flush calls and LCD_3IN49_TE_Poll must share a core.
+******************************************************************************/
+static void LCD_3IN49_Release_Gated(void){
+    uint32_t save = save_and_disable_interrupts();
+    if (lcd_flush_gated) {
+        lcd_flush_gated = false;
+        dma_channel_set_read_addr(lcd_ctrl_dma, lcd_flush_chain, true);
+    }
+    restore_interrupts(save);
+}
+
+#if LCD_3IN49_TE_PIN >= 0
+static void LCD_3IN49_TE_IRQ(void){
+    uint32_t now;
+
+    if (!(gpio_get_irq_event_mask(LCD_3IN49_TE_PIN) & GPIO_IRQ_EDGE_RISE))
+        return;
+    gpio_acknowledge_irq(LCD_3IN49_TE_PIN, GPIO_IRQ_EDGE_RISE);
+
+    now = time_us_32();
+    lcd_te_period_us = now - lcd_te_last_us;
+    lcd_te_last_us = now;
+    lcd_te_count++;
+
+    LCD_3IN49_Release_Gated();
+    if (lcd_vsync_cb)
+        lcd_vsync_cb(lcd_vsync_user);
+}
+
+/******************************************************************************
+function :	Take the TE input; TEON itself is in the init sequence
+parameter:
+******************************************************************************/
+static void LCD_3IN49_TE_Init(void){
+    DEV_GPIO_Mode(LCD_3IN49_TE_PIN, GPIO_IN);
+    DEV_IRQ_ADD_RAW(LCD_3IN49_TE_PIN, GPIO_IRQ_EDGE_RISE, LCD_3IN49_TE_IRQ);
+}
+#endif
+
+void LCD_3IN49_Set_Vsync_Cb(LCD_3IN49_Vsync_Cb cb, void *user){
+    uint32_t save = save_and_disable_interrupts();
+    lcd_vsync_cb = cb;
+    lcd_vsync_user = user;
+    restore_interrupts(save);
+}
+
+/******************************************************************************
+function :	Hold the next flush until the next TE pulse
+parameter:
+info     :	Ignored while TE is not active, so a missing or dead TE line
+            never stalls the display
+******************************************************************************/
+void LCD_3IN49_Flush_Sync_Next(void){
+    lcd_te_sync_next = true;
+}
+
+bool LCD_3IN49_TE_Active(void){
+    return lcd_te_count != 0 &&
+           time_us_32() - lcd_te_last_us < LCD_3IN49_TE_TIMEOUT_US;
+}
+
+uint32_t LCD_3IN49_TE_Period_Us(void){
+    return LCD_3IN49_TE_Active() ? lcd_te_period_us : 0;
+}
+
+/******************************************************************************
+function :	Start a held flush if TE has stopped
+parameter:
+info     :	For loops that wait on a flush, such as LVGL's wait_cb
+******************************************************************************/
+void LCD_3IN49_TE_Poll(void){
+    if (lcd_flush_gated && !LCD_3IN49_TE_Active())
+        LCD_3IN49_Release_Gated();
 }
@@ -42,9 +42,42 @@
 #define LCD_3IN49_WIDTH 172
 #define LCD_3IN49_HEIGHT 640
 
+// GPIO wired to the panel's tear-effect output. Define it (for example with
+// target_compile_definitions) to turn TE on and pace flushes to the panel
+// scan; left at -1, flushes start as soon as they are queued.
+#ifndef LCD_3IN49_TE_PIN
+#define LCD_3IN49_TE_PIN -1
+#endif
+// TE counts as lost when no pulse arrives for this long
+#define LCD_3IN49_TE_TIMEOUT_US 100000
+
 #define HORIZONTAL 0
 #define VERTICAL 1
 
+// Orientation set up by LCD_3IN49_Init. HORIZONTAL runs the panel as
+// 640x172 by switching the controller's address mode (MADCTL), so frames
+// are written already rotated and nothing is rotated on the CPU.
+#ifndef LCD_3IN49_SCAN_DIR
+#define LCD_3IN49_SCAN_DIR VERTICAL
+#endif
+// MADCTL per orientation: MV exchanges columns and rows, MX reverses the
+// column order so the landscape image reads with the panel turned clockwise
+#define LCD_3IN49_MADCTL_VERTICAL 0x00
+#define LCD_3IN49_MADCTL_HORIZONTAL 0x60
+
+// Reset timing. The vendor sequence holds each step for 200 ms; FAST_BOOT
+// uses the controller's minimums with margin: supply settled, a RESX low
+// pulse of at least 10 us, and 5 ms before the first command in sleep-in.
+#if FAST_BOOT
+#define LCD_3IN49_RESET_SETTLE_US 10000
+#define LCD_3IN49_RESET_LOW_US 100
+#define LCD_3IN49_RESET_WAIT_US 10000
+#else
+#define LCD_3IN49_RESET_SETTLE_US 200000
+#define LCD_3IN49_RESET_LOW_US 200000
+#define LCD_3IN49_RESET_WAIT_US 200000
+#endif
+
 #define WHITE 0xFFFF
 #define BLACK 0x0000
 #define BLUE 0x001F
@@ -75,6 +108,7 @@ typedef struct {
 extern LCD_3IN49_ATTRIBUTES LCD_3IN49;
 
 void LCD_3IN49_Init();
+void LCD_3IN49_SetAttributes(UBYTE Scan_dir);
 void LCD_3IN49_SetWindows(uint32_t Xstart, uint32_t Ystart, uint32_t Xend,
                           uint32_t Yend);
 void LCD_3IN49_Display(UWORD *Image);
@@ -82,4 +116,68 @@ void LCD_3IN49_DisplayWindows(uint32_t Xstart, uint32_t Ystart, uint32_t Xend,
                               uint32_t Yend, UWORD *Image);
 void LCD_3IN49_Clear(UWORD Color);
 
+// An image as the panel takes it, normally a const that the DMA streams
+// from XIP flash or PSRAM in place. RAW is RGB565 with the bytes swapped,
+// rows contiguous. RLE is a list of 32-bit tokens over the pixels in raster
+// order, counted in pixel pairs: a token with LCD_3IN49_RLE_RUN set repeats
+// the word after it that many times, otherwise that many words of RAW pixels
+// follow. WIDTH and HEIGHT are even. tools/splash/mksplash.py writes both.
+#define LCD_3IN49_IMAGE_RAW 0
+#define LCD_3IN49_IMAGE_RLE 1
+#define LCD_3IN49_RLE_RUN 0x80000000u
+typedef struct {
+  UWORD WIDTH;
+  UWORD HEIGHT;
+  UBYTE FORMAT;
+  const void *DATA;
+} LCD_3IN49_IMAGE;
+
+void LCD_3IN49_Splash(const LCD_3IN49_IMAGE *Image, UWORD Bg);
+
+// Hardware vertical scroll (VSCRDEF/VSCSAD) over panel rows [Top,
+// Top+Height), portrait only; Height 0 turns it off. Flushes keep using
+// screen coordinates and are remapped into panel memory. Top, Height and
+// offsets must be even, like windows.
+void LCD_3IN49_SetScrollArea(uint32_t Top, uint32_t Height);
+void LCD_3IN49_SetScrollStart(uint32_t Offset);
+uint32_t LCD_3IN49_GetScrollStart(void);
+
+// QSPI clock calibration: step from MIN towards MAX while register writes
+// and a pixel window still read back
+#define LCD_3IN49_SCLK_MIN_HZ 20000000
+#define LCD_3IN49_SCLK_MAX_HZ 75000000
+#define LCD_3IN49_SCLK_STEP_HZ 2500000
+uint32_t LCD_3IN49_Calibrate_Clock(uint32_t min_hz, uint32_t max_hz,
+                                   uint32_t step_hz);
+
+// Chained-DMA flush: window commands and pixels go out as one DMA kick
+typedef void (*LCD_3IN49_Flush_Cb)(void *user);
+void LCD_3IN49_Flush_Init(void);
+void LCD_3IN49_Flush_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend,
+                           uint32_t Yend, const void *Image,
+                           LCD_3IN49_Flush_Cb cb, void *user);
+void LCD_3IN49_Fill_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend,
+                          uint32_t Yend, UWORD Color, LCD_3IN49_Flush_Cb cb,
+                          void *user);
+void LCD_3IN49_Blit_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend,
+                          uint32_t Yend, const void *Image, uint32_t Stride,
+                          LCD_3IN49_Flush_Cb cb, void *user);
+void LCD_3IN49_Blit_RLE_Async(uint32_t Xstart, uint32_t Ystart, uint32_t Xend,
+                              uint32_t Yend, const uint32_t *Rle,
+                              LCD_3IN49_Flush_Cb cb, void *user);
+void LCD_3IN49_Image_Async(uint32_t X, uint32_t Y,
+                           const LCD_3IN49_IMAGE *Image,
+                           LCD_3IN49_Flush_Cb cb, void *user);
+bool LCD_3IN49_Flush_Busy(void);
+void LCD_3IN49_Flush_Wait(void);
+
+// Tear effect: the next flush can be held until the panel's vsync, and a
+// callback runs from the TE interrupt on every vsync
+typedef void (*LCD_3IN49_Vsync_Cb)(void *user);
+void LCD_3IN49_Set_Vsync_Cb(LCD_3IN49_Vsync_Cb cb, void *user);
+void LCD_3IN49_Flush_Sync_Next(void);
+bool LCD_3IN49_TE_Active(void);
+uint32_t LCD_3IN49_TE_Period_Us(void);
+void LCD_3IN49_TE_Poll(void);
+
 #endif // !_LCD_3IN49_H_
@@ -0,0 +1,24 @@
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+#include <stdint.h>
+
+// Integer square root, result fits 16 bits for a 32-bit input
+static inline uint32_t isqrt32(uint32_t x) {
+  uint32_t res = 0;
+  uint32_t bit = 1u << 30;
+  while (bit > x)
+    bit >>= 2;
+  while (bit) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return res;
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include "imu_fusion.h"
+#include "fixmath.h"
+#include "seqlock.h"
+#include <math.h>
+#include <string.h>
+
+#if LIB_PICO_PLATFORM
+#include "pico.h"
+#define FUSION_FUNC(name) __not_in_flash_func(name)
+#else
+#define FUSION_FUNC(name) name
+#endif
+
+// Boost Kp for the first half second so the attitude snaps to gravity
+// instead of slewing in from identity.
+#define WARMUP_MS 500
+#define WARMUP_GAIN 10
+
+// Accelerometer samples outside 0.5g..1.5g are dominated by linear
+// acceleration and are not used for correction.
+#define ACC_GATE_MIN_G2_Q8 64  // 0.25 g^2
+#define ACC_GATE_MAX_G2_Q8 576 // 2.25 g^2
+
+static inline int32_t qmul(int32_t a, int32_t b) {
+  return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+void imu_fusion_init(imu_fusion_t *f, const imu_fusion_config_t *cfg) {
+  const double dt = 1.0 / (double)cfg->odr_hz;
+  const double deg2rad = 3.14159265358979323846 / 180.0;
+
+  memset(f, 0, sizeof(*f));
+  f->q[0] = IMU_FUSION_ONE;
+  f->gyro_k = (int32_t)llround(deg2rad / cfg->gyro_lsb * dt * 0.5 *
+                               (double)(1ll << 40));
+  f->kp_h = (int32_t)llround(cfg->kp * dt * 0.5 * (double)(1ll << 30));
+  f->ki_h = (int32_t)llround(cfg->ki * dt * dt * 0.5 * (double)(1ll << 40));
+
+  uint32_t lsb2 = (uint32_t)cfg->acc_lsb * cfg->acc_lsb;
+  f->acc_min2 = (uint32_t)(((uint64_t)lsb2 * ACC_GATE_MIN_G2_Q8) >> 8);
+  f->acc_max2 = (uint32_t)(((uint64_t)lsb2 * ACC_GATE_MAX_G2_Q8) >> 8);
+  f->warmup = cfg->odr_hz * WARMUP_MS / 1000;
+}
+
+void imu_fusion_gravity(const imu_fusion_t *f, int32_t gravity[3]) {
+  const int32_t *q = f->q;
+  // Third row of the rotation matrix: world Z expressed in the sensor frame
+  gravity[0] = 2 * (int32_t)(((int64_t)q[1] * q[3] - (int64_t)q[0] * q[2]) >> 30);
+  gravity[1] = 2 * (int32_t)(((int64_t)q[0] * q[1] + (int64_t)q[2] * q[3]) >> 30);
+  gravity[2] = (int32_t)(((int64_t)q[0] * q[0] - (int64_t)q[1] * q[1] -
+                          (int64_t)q[2] * q[2] + (int64_t)q[3] * q[3]) >> 30);
+}
+
+void FUSION_FUNC(imu_fusion_update)(imu_fusion_t *f, const int16_t acc[3],
+                                    const int16_t gyro[3]) {
+  int32_t *q = f->q;
+  int32_t h[3];
+
+  // Gyro counts -> half rotation angle over one sample period (Q30)
+  for (int i = 0; i < 3; i++)
+    h[i] = (int32_t)(((int64_t)gyro[i] * f->gyro_k) >> 10);
+
+  uint32_t n2 = (uint32_t)((int32_t)acc[0] * acc[0]) +
+                (uint32_t)((int32_t)acc[1] * acc[1]) +
+                (uint32_t)((int32_t)acc[2] * acc[2]);
+  if (n2 >= f->acc_min2 && n2 <= f->acc_max2) {
+    // Unit accelerometer vector (Q30)
+    int64_t inv = (int64_t)((1ull << 46) / isqrt32(n2));
+    int32_t a[3];
+    for (int i = 0; i < 3; i++)
+      a[i] = (int32_t)((acc[i] * inv) >> 16);
+
+    int32_t v[3];
+    imu_fusion_gravity(f, v);
+
+    // Error is the cross product between measured and estimated gravity
+    int32_t e[3];
+    e[0] = (int32_t)(((int64_t)a[1] * v[2] - (int64_t)a[2] * v[1]) >> 30);
+    e[1] = (int32_t)(((int64_t)a[2] * v[0] - (int64_t)a[0] * v[2]) >> 30);
+    e[2] = (int32_t)(((int64_t)a[0] * v[1] - (int64_t)a[1] * v[0]) >> 30);
+
+    int32_t kp = f->kp_h;
+    if (f->warmup) {
+      kp *= WARMUP_GAIN;
+      f->warmup--;
+    } else if (f->ki_h) {
+      for (int i = 0; i < 3; i++)
+        f->ei[i] += ((int64_t)e[i] * f->ki_h) >> 8;
+    }
+
+    for (int i = 0; i < 3; i++)
+      h[i] += qmul(kp, e[i]) + (int32_t)(f->ei[i] >> 32);
+  }
+
+  // q += q (x) (0, h)
+  int64_t w = ((int64_t)q[0] << 30) - (int64_t)q[1] * h[0] -
+              (int64_t)q[2] * h[1] - (int64_t)q[3] * h[2];
+  int64_t x = ((int64_t)q[1] << 30) + (int64_t)q[0] * h[0] +
+              (int64_t)q[2] * h[2] - (int64_t)q[3] * h[1];
+  int64_t y = ((int64_t)q[2] << 30) + (int64_t)q[0] * h[1] -
+              (int64_t)q[1] * h[2] + (int64_t)q[3] * h[0];
+  int64_t z = ((int64_t)q[3] << 30) + (int64_t)q[0] * h[2] +
+              (int64_t)q[1] * h[1] - (int64_t)q[2] * h[0];
+  q[0] = (int32_t)(w >> 30);
+  q[1] = (int32_t)(x >> 30);
+  q[2] = (int32_t)(y >> 30);
+  q[3] = (int32_t)(z >> 30);
+
+  // The norm only drifts by a few LSB per step, so one Newton iteration
+  // of 1/sqrt around 1.0 is enough: inv = (3 - |q|^2) / 2
+  int64_t qn2 = (int64_t)q[0] * q[0] + (int64_t)q[1] * q[1] +
+                (int64_t)q[2] * q[2] + (int64_t)q[3] * q[3];
+  int32_t qinv = (int32_t)(((3ll << 30) - (qn2 >> 30)) >> 1);
+  for (int i = 0; i < 4; i++)
+    q[i] = qmul(q[i], qinv);
+
+  f->samples++;
+}
+
+void imu_fusion_update_batch(imu_fusion_t *f, const int16_t acc[][3],
+                             const int16_t gyro[][3], uint32_t count) {
+  for (uint32_t i = 0; i < count; i++)
+    imu_fusion_update(f, acc[i], gyro[i]);
+}
+
+//--------------------------------------------------------------------+
+// Snapshot
+//--------------------------------------------------------------------+
+static seqlock_t m_snapshot_seq;
+static imu_fusion_snapshot_t m_snapshot;
+static bool m_snapshot_valid;
+
+void imu_fusion_publish(const imu_fusion_t *f, uint32_t timestamp_us) {
+  seqlock_write_begin(&m_snapshot_seq);
+  memcpy(m_snapshot.q, f->q, sizeof(m_snapshot.q));
+  imu_fusion_gravity(f, m_snapshot.gravity);
+  m_snapshot.timestamp_us = timestamp_us;
+  m_snapshot.samples = f->samples;
+  m_snapshot_valid = true;
+  seqlock_write_end(&m_snapshot_seq);
+}
+
+bool imu_fusion_get_snapshot(imu_fusion_snapshot_t *out) {
+  uint32_t seq;
+  bool valid;
+  do {
+    seq = seqlock_read_begin(&m_snapshot_seq);
+    *out = m_snapshot;
+    valid = m_snapshot_valid;
+  } while (seqlock_read_retry(&m_snapshot_seq, seq));
+  return valid;
+}
+
+//--------------------------------------------------------------------+
+// Float reference
+//--------------------------------------------------------------------+
+void imu_fusion_ref_init(imu_fusion_ref_t *f, const imu_fusion_config_t *cfg) {
+  memset(f, 0, sizeof(*f));
+  f->q[0] = 1.0f;
+  f->kp = cfg->kp;
+  f->ki = cfg->ki;
+  f->dt = 1.0f / (float)cfg->odr_hz;
+  f->acc_scale = 1.0f / (float)cfg->acc_lsb;
+  f->gyro_scale = (3.14159265f / 180.0f) / (float)cfg->gyro_lsb;
+  f->warmup = cfg->odr_hz * WARMUP_MS / 1000;
+}
+
+void imu_fusion_ref_update(imu_fusion_ref_t *f, const int16_t acc[3],
+                           const int16_t gyro[3]) {
+  float *q = f->q;
+  float g[3], a[3];
+  for (int i = 0; i < 3; i++) {
+    g[i] = gyro[i] * f->gyro_scale;
+    a[i] = acc[i] * f->acc_scale;
+  }
+
+  float n2 = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+  if (n2 >= 0.25f && n2 <= 2.25f) {
+    float inv = 1.0f / sqrtf(n2);
+    for (int i = 0; i < 3; i++)
+      a[i] *= inv;
+
+    float v[3] = {2.0f * (q[1] * q[3] - q[0] * q[2]),
+                  2.0f * (q[0] * q[1] + q[2] * q[3]),
+                  q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]};
+    float e[3] = {a[1] * v[2] - a[2] * v[1], a[2] * v[0] - a[0] * v[2],
+                  a[0] * v[1] - a[1] * v[0]};
+
+    float kp = f->kp;
+    if (f->warmup) {
+      kp *= WARMUP_GAIN;
+      f->warmup--;
+    } else {
+      for (int i = 0; i < 3; i++)
+        f->ei[i] += f->ki * e[i] * f->dt;
+    }
+    for (int i = 0; i < 3; i++)
+      g[i] += kp * e[i] + f->ei[i];
+  }
+
+  float hx = g[0] * 0.5f * f->dt, hy = g[1] * 0.5f * f->dt,
+        hz = g[2] * 0.5f * f->dt;
+  float w = q[0] - q[1] * hx - q[2] * hy - q[3] * hz;
+  float x = q[1] + q[0] * hx + q[2] * hz - q[3] * hy;
+  float y = q[2] + q[0] * hy - q[1] * hz + q[3] * hx;
+  float z = q[3] + q[0] * hz + q[1] * hy - q[2] * hx;
+  float inv = 1.0f / sqrtf(w * w + x * x + y * y + z * z);
+  q[0] = w * inv;
+  q[1] = x * inv;
+  q[2] = y * inv;
+  q[3] = z * inv;
+}
@@ -0,0 +1,72 @@
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed-point Mahony attitude filter for the QMI8658 6-axis stream.
+//
+// All state is Q2.30 (1.0 == 1 << 30). Inputs are raw sensor counts straight
+// from the FIFO so no float conversion happens per sample; the only per-sample
+// division is the accelerometer normalisation. The inner products are written
+// as 32x32->64 multiply-accumulates so the Cortex-M33 build maps them onto
+// SMULL/SMLAL.
+//
+// The filter is hardware independent: it builds unchanged on the host, where
+// imu_fusion_ref_*() provides a float implementation of the same filter to
+// compare against recorded traces.
+
+#define IMU_FUSION_ONE (1 << 30)
+
+typedef struct {
+  float kp;         // proportional gain (1/s)
+  float ki;         // integral gain (1/s^2), 0 disables bias estimation
+  uint32_t odr_hz;  // sample rate of the FIFO stream
+  uint16_t acc_lsb; // accelerometer counts per g
+  uint16_t gyro_lsb; // gyroscope counts per dps
+} imu_fusion_config_t;
+
+typedef struct {
+  int32_t q[4];       // attitude quaternion w, x, y, z (Q30)
+  int32_t gravity[3]; // gravity direction in the sensor frame (Q30, unit)
+  uint32_t timestamp_us;
+  uint32_t samples;   // samples fused since init
+} imu_fusion_snapshot_t;
+
+typedef struct {
+  int32_t q[4];
+  int64_t ei[3];      // integral feedback, Q62 half-angle per sample
+  int32_t gyro_k;     // raw gyro count -> half-angle per sample, Q40
+  int32_t kp_h;       // Kp * dt / 2, Q30
+  int32_t ki_h;       // Ki * dt * dt / 2, Q40
+  uint32_t acc_min2;  // accepted |a|^2 window in raw counts^2
+  uint32_t acc_max2;
+  uint32_t warmup;    // samples left with boosted Kp for initial alignment
+  uint32_t samples;
+} imu_fusion_t;
+
+void imu_fusion_init(imu_fusion_t *f, const imu_fusion_config_t *cfg);
+void imu_fusion_update(imu_fusion_t *f, const int16_t acc[3],
+                       const int16_t gyro[3]);
+void imu_fusion_update_batch(imu_fusion_t *f, const int16_t acc[][3],
+                             const int16_t gyro[][3], uint32_t count);
+void imu_fusion_gravity(const imu_fusion_t *f, int32_t gravity[3]);
+
+// Lock-free publication for the UI and HID paths (see seqlock.h)
+void imu_fusion_publish(const imu_fusion_t *f, uint32_t timestamp_us);
+bool imu_fusion_get_snapshot(imu_fusion_snapshot_t *out);
+
+// Float reference implementation with identical gains and input scaling
+typedef struct {
+  float q[4];
+  float ei[3];
+  float kp, ki, dt;
+  float acc_scale, gyro_scale; // counts -> g, counts -> rad/s
+  uint32_t warmup;
+} imu_fusion_ref_t;
+
+void imu_fusion_ref_init(imu_fusion_ref_t *f, const imu_fusion_config_t *cfg);
+void imu_fusion_ref_update(imu_fusion_ref_t *f, const int16_t acc[3],
+                           const int16_t gyro[3]);
+
+#endif
@@ -0,0 +1,160 @@
+#include "motion.h"
+#include "DEV_Config.h"
+#include "QMI8658.h"
+#include "idle.h"
+#include "pico/stdlib.h"
+
+// Poll slightly faster than the FIFO fills to the watermark
+#define MOTION_WATERMARK 16
+#define MOTION_BATCH_MAX 64
+
+static imu_fusion_t m_fusion;
+static motion_gesture_state_t m_gesture;
+static motion_action_t m_actions[MOTION_GESTURE_COUNT];
+static motion_stats_t m_stats;
+static bool m_ready = false;
+static uint32_t m_poll_interval_us;
+static uint32_t m_last_poll_us;
+static uint16_t m_acc_lsb;
+static uint16_t m_gyro_lsb;
+
+// Wake-on-motion: set while the IMU is parked, cleared from the INT1 IRQ
+static bool m_sleeping = false;
+static volatile bool m_wake_pending = false;
+
+static void motion_int1_irq(void) {
+  if (gpio_get_irq_event_mask(DOF_INT1)) {
+    gpio_acknowledge_irq(DOF_INT1, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+    m_wake_pending = true;
+  }
+}
+
+// Back to FIFO streaming; also restarts the still timer
+static void motion_resume(void) {
+  QMI8658_resume();
+  QMI8658_enableFifo(QMI8658_FIFO_SIZE_128, MOTION_WATERMARK);
+  motion_gesture_init(&m_gesture, m_gesture.frame_ms);
+  m_sleeping = false;
+  m_last_poll_us = time_us_32();
+}
+
+static void motion_sleep(void) {
+  m_wake_pending = false;
+  m_sleeping = true;
+  // Without the WoM ack INT1 may never fire, so stay awake instead
+  if (!QMI8658_enableWakeOnMotion())
+    motion_resume();
+}
+
+static void motion_wake(void) {
+  motion_resume();
+  m_stats.wakeups++;
+}
+
+bool motion_init(void) {
+  imu_fusion_config_t cfg = {
+      .kp = 2.0f,
+      .ki = 0.05f,
+      .odr_hz = QMI8658_get_odr_hz(),
+      .acc_lsb = QMI8658_get_acc_lsb_div(),
+      .gyro_lsb = QMI8658_get_gyro_lsb_div(),
+  };
+  if (cfg.odr_hz == 0 || cfg.acc_lsb == 0 || cfg.gyro_lsb == 0)
+    return false;
+
+  imu_fusion_init(&m_fusion, &cfg);
+  motion_gesture_init(&m_gesture, (MOTION_WATERMARK * 1000u) / cfg.odr_hz);
+  m_acc_lsb = cfg.acc_lsb;
+  m_gyro_lsb = cfg.gyro_lsb;
+  QMI8658_enableFifo(QMI8658_FIFO_SIZE_128, MOTION_WATERMARK);
+
+  DEV_GPIO_Mode(DOF_INT1, GPIO_IN);
+  DEV_IRQ_ADD_RAW(DOF_INT1, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                  motion_int1_irq);
+
+  m_poll_interval_us = (MOTION_WATERMARK * 1000000u) / cfg.odr_hz;
+  m_last_poll_us = time_us_32();
+  m_ready = true;
+  return true;
+}
+
+void motion_set_gesture_action(motion_gesture_t gesture,
+                               motion_action_t action) {
+  if (gesture > MOTION_GESTURE_NONE && gesture < MOTION_GESTURE_COUNT)
+    m_actions[gesture] = action;
+}
+
+bool motion_is_sleeping(void) { return m_sleeping; }
+
+// FIFO batch filled by the async read; m_batch_len is written from the I2C
+// interrupt once the samples are in place
+static int16_t m_acc[MOTION_BATCH_MAX][3];
+static int16_t m_gyro[MOTION_BATCH_MAX][3];
+static volatile bool m_batch_busy = false;
+static volatile int32_t m_batch_len = -1;
+
+static void motion_fifo_done(unsigned short count) { m_batch_len = count; }
+
+void motion_task(void) {
+  int16_t(*acc)[3] = m_acc;
+  int16_t(*gyro)[3] = m_gyro;
+
+  if (!m_ready)
+    return;
+
+  if (m_sleeping) {
+    if (!m_wake_pending)
+      return;
+    motion_wake();
+  }
+
+  uint32_t now = time_us_32();
+  if (!m_batch_busy) {
+    if (now - m_last_poll_us < m_poll_interval_us) {
+      idle_wake_at(m_last_poll_us + m_poll_interval_us);
+      return;
+    }
+    m_last_poll_us = now;
+    m_batch_len = -1;
+    m_batch_busy = QMI8658_read_fifo_async(acc, gyro, MOTION_BATCH_MAX,
+                                           motion_fifo_done);
+    return;
+  }
+  if (m_batch_len < 0)
+    return;
+
+  uint16_t n = (uint16_t)m_batch_len;
+  m_batch_busy = false;
+  // A batch in flight wakes the loop with its DMA interrupt; the next poll
+  // needs a deadline
+  idle_wake_at(m_last_poll_us + m_poll_interval_us);
+  if (n == 0)
+    return;
+
+  uint32_t fuse_start = time_us_32();
+  imu_fusion_update_batch(&m_fusion, acc, gyro, n);
+  imu_fusion_publish(&m_fusion, fuse_start);
+
+  int32_t gravity[3];
+  motion_frame_t frame;
+  imu_fusion_gravity(&m_fusion, gravity);
+  motion_gesture_frame(&frame, acc, gyro, n, m_acc_lsb, m_gyro_lsb, gravity);
+  motion_gesture_t g = motion_gesture_push(&m_gesture, &frame);
+  uint32_t end = time_us_32();
+
+  m_stats.batches++;
+  m_stats.samples += n;
+  m_stats.fuse_us += end - fuse_start;
+  m_stats.busy_us += end - now;
+
+  if (g != MOTION_GESTURE_NONE) {
+    m_stats.gestures[g]++;
+    if (m_actions[g])
+      m_actions[g]();
+  }
+
+  if (motion_gesture_still_ms(&m_gesture) >= MOTION_SLEEP_MS)
+    motion_sleep();
+}
+
+void motion_get_stats(motion_stats_t *stats) { *stats = m_stats; }
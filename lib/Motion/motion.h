@@ -0,0 +1,36 @@
+#ifndef MOTION_H
+#define MOTION_H
+
+#include "imu_fusion.h"
+#include "motion_gesture.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// QMI8658 FIFO -> fusion pipeline. motion_task() queues an asynchronous FIFO
+// drain once per watermark batch and, once it has landed, fuses every sample
+// and publishes the result through imu_fusion_get_snapshot(). Each batch also
+// feeds the gesture classifier; after MOTION_SLEEP_MS without movement the
+// IMU is parked in wake-on-motion and polling stops until INT1 fires.
+
+#define MOTION_SLEEP_MS 10000
+
+typedef void (*motion_action_t)(void);
+
+typedef struct {
+  uint32_t batches;
+  uint32_t samples;
+  uint32_t busy_us; // CPU time in motion_task(); the FIFO read itself is DMA
+  uint32_t fuse_us; // time spent in the fusion math only
+  uint32_t gestures[MOTION_GESTURE_COUNT];
+  uint32_t wakeups;  // exits from wake-on-motion
+} motion_stats_t;
+
+bool motion_init(void);
+void motion_task(void);
+void motion_get_stats(motion_stats_t *stats);
+bool motion_is_sleeping(void);
+
+// Action run from motion_task() when a gesture is recognised (NULL clears)
+void motion_set_gesture_action(motion_gesture_t gesture, motion_action_t action);
+
+#endif
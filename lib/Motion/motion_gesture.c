@@ -0,0 +1,184 @@
+#include "motion_gesture.h"
+#include "fixmath.h"
+#include <string.h>
+
+// Thresholds are in mg / dps / ms and were picked from hand-held traces
+#define STILL_DYN_MG 40
+#define STILL_GYRO_DPS 4
+
+#define SHAKE_WINDOW_MS 800
+#define SHAKE_ACTIVE_MG 500   // frame counts as active above this RMS
+#define SHAKE_SWING_MG 300    // swing must exceed this to count a reversal
+#define SHAKE_MIN_REVERSALS 4
+
+#define POSE_CALM_MG 200      // pose gestures require a calm device
+#define FLIP_Z_MG (-850)
+#define FLIP_HOLD_MS 500
+#define FLIP_REARM_Z_MG 500
+#define TILT_X_MG 600
+#define TILT_HOLD_MS 300
+#define TILT_REARM_X_MG 300
+
+#define REFRACTORY_MS 1000
+
+void motion_gesture_init(motion_gesture_state_t *s, uint16_t frame_ms) {
+  memset(s, 0, sizeof(*s));
+  s->frame_ms = frame_ms ? frame_ms : 1;
+  s->flip_armed = true;
+  s->tilt_armed = true;
+}
+
+uint32_t motion_gesture_still_ms(const motion_gesture_state_t *s) {
+  return s->still_ms;
+}
+
+// n-th most recent frame, 0 == newest
+static const motion_frame_t *frame_at(const motion_gesture_state_t *s,
+                                      uint8_t n) {
+  return &s->ring[(uint8_t)(s->head - 1 - n) % MOTION_GESTURE_RING];
+}
+
+static uint8_t frames_for(const motion_gesture_state_t *s, uint32_t ms) {
+  uint32_t n = (ms + s->frame_ms - 1) / s->frame_ms;
+  if (n > MOTION_GESTURE_RING)
+    n = MOTION_GESTURE_RING;
+  return n ? (uint8_t)n : 1;
+}
+
+static bool is_shake(const motion_gesture_state_t *s) {
+  uint8_t n = frames_for(s, SHAKE_WINDOW_MS);
+  if (s->count < n)
+    return false;
+
+  // Pick the axis carrying most of the linear acceleration
+  int32_t sum[2] = {0, 0};
+  uint8_t active = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    const motion_frame_t *f = frame_at(s, i);
+    sum[0] += f->dyn[0] < 0 ? -f->dyn[0] : f->dyn[0];
+    sum[1] += f->dyn[1] < 0 ? -f->dyn[1] : f->dyn[1];
+    if (f->dyn_rms > SHAKE_ACTIVE_MG)
+      active++;
+  }
+  if (active * 10 < n * 3)
+    return false;
+
+  int axis = sum[1] > sum[0];
+  int last_sign = 0;
+  uint8_t reversals = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    int16_t d = frame_at(s, i)->dyn[axis];
+    int sign = d > SHAKE_SWING_MG ? 1 : (d < -SHAKE_SWING_MG ? -1 : 0);
+    if (sign && last_sign && sign != last_sign)
+      reversals++;
+    if (sign)
+      last_sign = sign;
+  }
+  return reversals >= SHAKE_MIN_REVERSALS;
+}
+
+// True if the last hold_ms of frames are calm and satisfy the pose test
+static bool pose_held(const motion_gesture_state_t *s, uint32_t hold_ms,
+                      int axis, int16_t threshold, bool below) {
+  uint8_t n = frames_for(s, hold_ms);
+  if (s->count < n)
+    return false;
+  for (uint8_t i = 0; i < n; i++) {
+    const motion_frame_t *f = frame_at(s, i);
+    if (f->dyn_rms > POSE_CALM_MG)
+      return false;
+    int16_t g = f->gravity[axis];
+    if (below ? g > threshold : g < threshold)
+      return false;
+  }
+  return true;
+}
+
+motion_gesture_t motion_gesture_push(motion_gesture_state_t *s,
+                                     const motion_frame_t *frame) {
+  s->ring[s->head % MOTION_GESTURE_RING] = *frame;
+  s->head = (uint8_t)((s->head + 1) % MOTION_GESTURE_RING);
+  if (s->count < MOTION_GESTURE_RING)
+    s->count++;
+
+  if (frame->dyn_rms < STILL_DYN_MG && frame->gyro_peak < STILL_GYRO_DPS)
+    s->still_ms += s->frame_ms;
+  else
+    s->still_ms = 0;
+
+  // Re-arm pose gestures once the device has left the pose
+  if (frame->gravity[2] > FLIP_REARM_Z_MG)
+    s->flip_armed = true;
+  if (frame->gravity[0] < TILT_REARM_X_MG &&
+      frame->gravity[0] > -TILT_REARM_X_MG)
+    s->tilt_armed = true;
+
+  if (s->refractory) {
+    s->refractory--;
+    s->count = 0;
+    return MOTION_GESTURE_NONE;
+  }
+
+  motion_gesture_t g = MOTION_GESTURE_NONE;
+  if (is_shake(s)) {
+    g = MOTION_GESTURE_SHAKE;
+  } else if (s->flip_armed && pose_held(s, FLIP_HOLD_MS, 2, FLIP_Z_MG, true)) {
+    s->flip_armed = false;
+    g = MOTION_GESTURE_FLIP;
+  } else if (s->tilt_armed && frame->gravity[2] > 0) {
+    if (pose_held(s, TILT_HOLD_MS, 0, TILT_X_MG, false)) {
+      s->tilt_armed = false;
+      g = MOTION_GESTURE_TILT_LEFT;
+    } else if (pose_held(s, TILT_HOLD_MS, 0, -TILT_X_MG, true)) {
+      s->tilt_armed = false;
+      g = MOTION_GESTURE_TILT_RIGHT;
+    }
+  }
+
+  if (g != MOTION_GESTURE_NONE) {
+    // Frames pushed during the refractory period are not counted, so the
+    // next decision starts from a fresh window
+    s->refractory = frames_for(s, REFRACTORY_MS);
+  }
+  return g;
+}
+
+void motion_gesture_frame(motion_frame_t *frame, const int16_t acc[][3],
+                          const int16_t gyro[][3], uint32_t count,
+                          uint16_t acc_lsb, uint16_t gyro_lsb,
+                          const int32_t gravity_q30[3]) {
+  int32_t g_mg[3];
+  for (int i = 0; i < 3; i++) {
+    g_mg[i] = (int32_t)(((int64_t)gravity_q30[i] * 1000) >> 30);
+    frame->gravity[i] = (int16_t)g_mg[i];
+  }
+
+  int32_t dyn_sum[2] = {0, 0};
+  // On the 8 g range one sample's dev^2 reaches ~1.65e8, so a batch of
+  // them overflows 32 bits; the mean fits again
+  uint64_t dev_sq = 0;
+  uint32_t gyro_peak2 = 0;
+  for (uint32_t n = 0; n < count; n++) {
+    int32_t a[3];
+    uint32_t a2 = 0, w2 = 0;
+    for (int i = 0; i < 3; i++) {
+      a[i] = (int32_t)acc[n][i] * 1000 / acc_lsb;
+      a2 += (uint32_t)(a[i] * a[i]);
+      int32_t w = (int32_t)gyro[n][i] / gyro_lsb;
+      w2 += (uint32_t)(w * w);
+    }
+    int32_t dev = (int32_t)isqrt32(a2) - 1000;
+    dev_sq += (uint64_t)((int64_t)dev * dev);
+    if (w2 > gyro_peak2)
+      gyro_peak2 = w2;
+    dyn_sum[0] += a[0] - g_mg[0];
+    dyn_sum[1] += a[1] - g_mg[1];
+  }
+
+  if (count == 0)
+    count = 1;
+  frame->dyn[0] = (int16_t)(dyn_sum[0] / (int32_t)count);
+  frame->dyn[1] = (int16_t)(dyn_sum[1] / (int32_t)count);
+  frame->dyn_rms = (uint16_t)isqrt32((uint32_t)(dev_sq / count));
+  frame->gyro_peak = (uint16_t)isqrt32(gyro_peak2);
+}
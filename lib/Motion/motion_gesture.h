@@ -0,0 +1,53 @@
+#ifndef MOTION_GESTURE_H
+#define MOTION_GESTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Motion gesture classifier. Each FIFO batch is reduced to one feature frame
+// which is pushed into a ring; a small decision tree over the ring detects
+// shake, flip (face down) and left/right tilt. Hardware independent so the
+// same code can be replayed against recorded traces on the host.
+
+#define MOTION_GESTURE_RING 64
+
+typedef enum {
+  MOTION_GESTURE_NONE = 0,
+  MOTION_GESTURE_SHAKE,
+  MOTION_GESTURE_FLIP,
+  MOTION_GESTURE_TILT_LEFT,
+  MOTION_GESTURE_TILT_RIGHT,
+  MOTION_GESTURE_COUNT
+} motion_gesture_t;
+
+typedef struct {
+  int16_t gravity[3]; // estimated gravity direction, mg
+  int16_t dyn[2];     // mean linear acceleration on x/y, mg
+  uint16_t dyn_rms;   // RMS of |a| - 1g over the batch, mg
+  uint16_t gyro_peak; // largest gyro magnitude in the batch, dps
+} motion_frame_t;
+
+typedef struct {
+  motion_frame_t ring[MOTION_GESTURE_RING];
+  uint8_t head;
+  uint8_t count;
+  uint16_t frame_ms;   // time covered by one frame
+  uint16_t refractory; // frames until the next gesture may fire
+  uint32_t still_ms;   // how long the device has been motionless
+  bool flip_armed;
+  bool tilt_armed;
+} motion_gesture_state_t;
+
+void motion_gesture_init(motion_gesture_state_t *s, uint16_t frame_ms);
+motion_gesture_t motion_gesture_push(motion_gesture_state_t *s,
+                                     const motion_frame_t *frame);
+uint32_t motion_gesture_still_ms(const motion_gesture_state_t *s);
+
+// Builds a feature frame from a batch of raw samples and the fused gravity
+// vector (Q30 unit vector, see imu_fusion_gravity()).
+void motion_gesture_frame(motion_frame_t *frame, const int16_t acc[][3],
+                          const int16_t gyro[][3], uint32_t count,
+                          uint16_t acc_lsb, uint16_t gyro_lsb,
+                          const int32_t gravity_q30[3]);
+
+#endif
@@ -52,10 +52,8 @@ void PCF85063A_Set_All(datetime_t time)
 	DEV_I2C_Write_nByte(PCF85063A_ADDRESS, buf, 8);
 }
 
-void PCF85063A_Read_now(datetime_t *time)
+static void PCF85063A_Decode_Time(const uint8_t *bufss, datetime_t *time)
 {
-	uint8_t bufss[7] = {0};
-	DEV_I2C_Read_nByte(PCF85063A_ADDRESS, RTC_SECOND_ADDR, bufss, 7);
 	time->sec = bcdToDec(bufss[0] & 0x7F);
 	time->min = bcdToDec(bufss[1] & 0x7F);
 	time->hour = bcdToDec(bufss[2] & 0x3F);
@@ -65,6 +63,49 @@ void PCF85063A_Read_now(datetime_t *time)
 	time->year = bcdToDec(bufss[6])+YEAR_OFFSET;
 }
 
+void PCF85063A_Read_now(datetime_t *time)
+{
+	uint8_t bufss[7] = {0};
+	DEV_I2C_Read_nByte(PCF85063A_ADDRESS, RTC_SECOND_ADDR, bufss, 7);
+	PCF85063A_Decode_Time(bufss, time);
+}
+
+static struct
+{
+	i2c_txn_t txn;
+	uint8_t reg;
+	uint8_t buf[7];
+	datetime_t *time;
+	void (*done)(bool ok);
+} rtc_rd;
+
+static void PCF85063A_Read_Done(i2c_txn_t *txn)
+{
+	bool ok = txn->status == I2C_TXN_DONE;
+	if (ok)
+		PCF85063A_Decode_Time(rtc_rd.buf, rtc_rd.time);
+	if (rtc_rd.done)
+		rtc_rd.done(ok);
+}
+
+// Queue a time read on the DMA I2C engine; done() runs from the I2C interrupt
+// once *time is filled in. Returns false while a previous read is pending.
+bool PCF85063A_Read_now_Async(datetime_t *time, void (*done)(bool ok))
+{
+	if (i2c_txn_pending(&rtc_rd.txn))
+		return false;
+	rtc_rd.reg = RTC_SECOND_ADDR;
+	rtc_rd.time = time;
+	rtc_rd.done = done;
+	rtc_rd.txn.addr = PCF85063A_ADDRESS;
+	rtc_rd.txn.wr = &rtc_rd.reg;
+	rtc_rd.txn.wr_len = 1;
+	rtc_rd.txn.rd = rtc_rd.buf;
+	rtc_rd.txn.rd_len = sizeof(rtc_rd.buf);
+	rtc_rd.txn.cb = PCF85063A_Read_Done;
+	return i2c_dma_submit(I2C_PORT, &rtc_rd.txn);
+}
+
 //Enable Alarm and Clear Alarm flag
 void PCF85063A_Enable_Alarm()
 {
@@ -107,8 +148,8 @@ void PCF85063A_Set_Alarm(datetime_t time)
 
 void PCF85063A_Read_Alarm(datetime_t *time)
 {
-	uint8_t bufss[6] = {0};
-	DEV_I2C_Read_nByte(PCF85063A_ADDRESS, RTC_SECOND_ALARM, bufss, 7);
+	uint8_t bufss[5] = {0};
+	DEV_I2C_Read_nByte(PCF85063A_ADDRESS, RTC_SECOND_ALARM, bufss, 5);
 	time->sec = bcdToDec(bufss[0] & 0x7F);
 	time->min = bcdToDec(bufss[1] & 0x7F);
 	time->hour = bcdToDec(bufss[2] & 0x3F);
@@ -87,6 +87,7 @@ void PCF85063A_Set_Time(datetime_t time);
 void PCF85063A_Set_Date(datetime_t time);
 void PCF85063A_Set_All(datetime_t time);
 void PCF85063A_Read_now(datetime_t *time);
+bool PCF85063A_Read_now_Async(datetime_t *time, void (*done)(bool ok));
 void PCF85063A_Enable_Alarm(void);
 uint8_t PCF85063A_Get_Alarm_Flag(void);
 void PCF85063A_Clean_Alarm_Flag(void);
@@ -10,6 +10,7 @@
 #include "hardware/sync.h"
 #include "pico/binary_info.h"
 #include "pico/flash.h"
+#include "pico/sync.h"
 #include "pico/stdlib.h"
 #include <math.h>
 #include <stdio.h>
@@ -20,26 +21,31 @@
 
 #include "rp_pico_alloc.h"
 
-static tlsf_t _mem_heap = NULL;
-static pool_t _mem_sram_pool = NULL;
-static pool_t _mem_psram_pool = NULL;
+// One TLSF instance per region, so a hint decides where a block lands
+typedef struct
+{
+    tlsf_t heap;
+    pool_t pool;
+    uintptr_t start;
+    uintptr_t end;
+    rp_mem_stats_t stats;
+} rp_mem_heap_t;
+
+static rp_mem_heap_t _mem_heaps[RP_MEM_REGION_COUNT];
+static critical_section_t _mem_lock;
 
 static size_t _psram_size = 0;
 
 static bool _bInitalized = false;
 
-#if defined(RP_PICO_ALLOC_WRAP)
-static bool _bUseHeapPool = true;
-#else
-static bool _bUseHeapPool = false;
+#if !defined(RP_PICO_ALLOC_WRAP)
+// malloc keeps the SRAM heap; the hinted one is a fixed reserve
+static uint8_t _mem_sram_pool[RP_MEM_SRAM_POOL_SIZE] __attribute__((aligned(8)));
 #endif
 
-static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
+// QMI window 1 timing for the current clk_sys
+static uint32_t psram_timing(void)
 {
-    gpio_set_function(psram_cs_pin, GPIO_FUNC_XIP_CS1);
-
-    size_t psram_size = 0;
-
     const int max_psram_freq = 133000000;
     const int clock_hz = clock_get_hz(clk_sys);
     int clockDivider = (clock_hz + max_psram_freq - 1) / max_psram_freq;
@@ -57,7 +63,24 @@ static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
     const int maxSelect = (125 * 1000000) / clock_period_fs;  // 125 = 8000ns / 64
     const int minDeselect = (18 * 1000000 + (clock_period_fs - 1)) / clock_period_fs - (clockDivider + 1) / 2;
 
-    stdio_printf("Max Select: %d, Min Deselect: %d, clock divider: %d\n", maxSelect, minDeselect, clockDivider);
+    return (QMI_M1_TIMING_PAGEBREAK_VALUE_1024 << QMI_M1_TIMING_PAGEBREAK_LSB) | // Break between pages.
+           (1 << QMI_M1_TIMING_COOLDOWN_LSB) | (rxdelay << QMI_M1_TIMING_RXDELAY_LSB) |
+           (maxSelect << QMI_M1_TIMING_MAX_SELECT_LSB) |  // In units of 64 system clock cycles. PSRAM says 8us max. 8 / 0.00752 /64
+                                                 // = 16.62
+           (minDeselect << QMI_M1_TIMING_MIN_DESELECT_LSB) | // In units of system clock cycles. PSRAM says 50ns.50 / 7.52 = 6.64
+           (clockDivider << QMI_M1_TIMING_CLKDIV_LSB);
+}
+
+static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
+{
+    gpio_set_function(psram_cs_pin, GPIO_FUNC_XIP_CS1);
+
+    size_t psram_size = 0;
+
+    // Worked out here, while flash is still mapped
+    const uint32_t timing = psram_timing();
+
+    stdio_printf("PSRAM timing: 0x%08lx at %lu Hz\n", timing, clock_get_hz(clk_sys));
 
     uint32_t intr_stash = save_and_disable_interrupts();
 
@@ -165,13 +188,7 @@ static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
     // Disable direct csr.
     qmi_hw->direct_csr &= ~(QMI_DIRECT_CSR_ASSERT_CS1N_BITS | QMI_DIRECT_CSR_EN_BITS);
 
-    qmi_hw->m[1].timing =
-        (QMI_M1_TIMING_PAGEBREAK_VALUE_1024 << QMI_M1_TIMING_PAGEBREAK_LSB) | // Break between pages.
-        (1 << QMI_M1_TIMING_COOLDOWN_LSB) | (rxdelay << QMI_M1_TIMING_RXDELAY_LSB) |
-        (maxSelect << QMI_M1_TIMING_MAX_SELECT_LSB) |  // In units of 64 system clock cycles. PSRAM says 8us max. 8 / 0.00752 /64
-                                              // = 16.62
-        (minDeselect << QMI_M1_TIMING_MIN_DESELECT_LSB) | // In units of system clock cycles. PSRAM says 50ns.50 / 7.52 = 6.64
-        (clockDivider << QMI_M1_TIMING_CLKDIV_LSB);
+    qmi_hw->m[1].timing = timing;
     
     qmi_hw->m[1].rfmt = (QMI_M1_RFMT_PREFIX_WIDTH_VALUE_Q << QMI_M1_RFMT_PREFIX_WIDTH_LSB) |
                          (QMI_M1_RFMT_ADDR_WIDTH_VALUE_Q << QMI_M1_RFMT_ADDR_WIDTH_LSB) |
@@ -221,15 +238,25 @@ static size_t __no_inline_not_in_flash_func(setup_psram)(uint psram_cs_pin)
 // Location /address where PSRAM starts
 #define PSRAM_LOCATION _u(0x11000000)
 
+static void rp_mem_heap_init(rp_mem_region_t region, void *mem, size_t size)
+{
+    rp_mem_heap_t *h = &_mem_heaps[region];
+
+    h->heap = tlsf_create_with_pool(mem, size, size);
+    h->pool = tlsf_get_pool(h->heap);
+    h->start = (uintptr_t)mem;
+    h->end = (uintptr_t)mem + size;
+    h->stats.size = size;
+}
+
 // Internal function that init's the allocator
 static bool rp_pico_alloc_init()
 {
    if (_bInitalized)
         return true;
 
-    _mem_heap = NULL;
-    _mem_sram_pool = NULL;
-    _mem_psram_pool = NULL;
+    memset(_mem_heaps, 0, sizeof(_mem_heaps));
+    critical_section_init(&_mem_lock);
 
 #ifndef RP2350_XIP_CSI_PIN
     printf("PSRAM CS pin not defined - check board file or specify board on build. unable to use PSRAM\n");
@@ -240,70 +267,166 @@ static bool rp_pico_alloc_init()
     // qmi_hw->m[1].timing= 0x60460201;
 #endif
     printf("PSRAM size: %u\n", _psram_size);
-    if (!_bUseHeapPool)
-    {
-        printf("Got here A!\n");
+    if (_psram_size > 0)
+        rp_mem_heap_init(RP_MEM_PSRAM, (void *)PSRAM_LOCATION, _psram_size);
 
-        if (_psram_size > 0)
-        {
-            _mem_heap = tlsf_create_with_pool((void *)PSRAM_LOCATION, _psram_size, 64 * 1024 * 1024);
-            _mem_psram_pool = tlsf_get_pool(_mem_heap);
-        }
-    }
-    else
-    {
+#if !defined(RP_PICO_ALLOC_WRAP)
+    rp_mem_heap_init(RP_MEM_SRAM, _mem_sram_pool, sizeof(_mem_sram_pool));
+#else
+    // The whole SRAM heap. External heap symbols from rpi pico-sdk
+    extern uint32_t __heap_start;
+    extern uint32_t __heap_end;
+    // size
+    size_t sram_size = (size_t)(&__heap_end - &__heap_start) * sizeof(uint32_t);
+    rp_mem_heap_init(RP_MEM_SRAM, (void *)&__heap_start, sram_size);
+#endif
+    printf("rp_mem SRAM pool: %u\n", _mem_heaps[RP_MEM_SRAM].stats.size);
+    _bInitalized = true;
+    return true;
+}
+
+bool rp_mem_init(void)
+{
+    return rp_pico_alloc_init();
+}
 
-        printf("Got here B!\n");
+void rp_mem_update_timing(void)
+{
+    if (_psram_size > 0)
+        qmi_hw->m[1].timing = psram_timing();
+}
 
-        // First, sram pool. External heap symbols from rpi pico-sdk
-        extern uint32_t __heap_start;
-        extern uint32_t __heap_end;
-        // size
-        size_t sram_size = (size_t)(&__heap_end - &__heap_start) * sizeof(uint32_t);
-        // printf("point 2 start: %x, end %x, size %X %u\n", &__heap_start, &__heap_end, sram_size, sram_size);
+rp_mem_region_t rp_mem_region_of(const void *ptr)
+{
+    return (uintptr_t)ptr >= PSRAM_LOCATION && (uintptr_t)ptr < PSRAM_LOCATION + _psram_size
+               ? RP_MEM_PSRAM
+               : RP_MEM_SRAM;
+}
 
-        _mem_heap = tlsf_create_with_pool((void *)&__heap_start, sram_size, 64 * 1024 * 1024);
-        _mem_sram_pool = tlsf_get_pool(_mem_heap);
+// The heap a block came from; NULL for anything else, e.g. plain malloc
+static rp_mem_heap_t *rp_mem_heap_of(const void *ptr)
+{
+    rp_mem_heap_t *h = &_mem_heaps[rp_mem_region_of(ptr)];
+    return h->heap && (uintptr_t)ptr >= h->start && (uintptr_t)ptr < h->end ? h : NULL;
+}
 
-        if (_psram_size > 0)
-            _mem_psram_pool = tlsf_add_pool(_mem_heap, (void *)PSRAM_LOCATION, _psram_size);
+// Called with the lock held
+static void *rp_mem_heap_alloc(rp_mem_region_t region, size_t size, bool spill)
+{
+    rp_mem_heap_t *h = &_mem_heaps[region];
+    void *ptr = h->heap ? tlsf_malloc(h->heap, size) : NULL;
+
+    if (!ptr)
+    {
+        if (h->heap)
+            h->stats.failed++;
+        return NULL;
     }
-    _bInitalized = true;
-    return true;
+    h->stats.allocs++;
+    h->stats.spills += spill;
+    h->stats.used += tlsf_block_size(ptr);
+    if (h->stats.used > h->stats.peak)
+        h->stats.peak = h->stats.used;
+    return ptr;
 }
 
 // Our allocator interface -- same signature as the stdlib malloc/free/realloc/calloc
 
-void *rp_mem_malloc(size_t size)
+void *rp_mem_malloc_hint(size_t size, rp_mem_hint_t hint)
 {
-    if (!rp_pico_alloc_init()){
+    if (!rp_pico_alloc_init())
         return NULL;
+
+    void *ptr = NULL;
+    critical_section_enter_blocking(&_mem_lock);
+    switch (hint)
+    {
+    case RP_MEM_FAST:
+    case RP_MEM_DMA:
+        // Never behind the XIP cache
+        ptr = rp_mem_heap_alloc(RP_MEM_SRAM, size, false);
+        break;
+    case RP_MEM_BULK:
+        ptr = rp_mem_heap_alloc(RP_MEM_PSRAM, size, false);
+        if (!ptr)
+            ptr = rp_mem_heap_alloc(RP_MEM_SRAM, size, true);
+        break;
+    case RP_MEM_ANY:
+    default:
+        ptr = rp_mem_heap_alloc(RP_MEM_SRAM, size, false);
+        if (!ptr)
+            ptr = rp_mem_heap_alloc(RP_MEM_PSRAM, size, true);
+        break;
     }
-    return tlsf_malloc(_mem_heap, size);
+    critical_section_exit(&_mem_lock);
+    return ptr;
+}
+
+void *rp_mem_calloc_hint(size_t num, size_t size, rp_mem_hint_t hint)
+{
+    void *ptr = rp_mem_malloc_hint(num * size, hint);
+    if (ptr)
+        memset(ptr, 0, num * size);
+    return ptr;
+}
+
+void *rp_mem_malloc(size_t size)
+{
+    return rp_mem_malloc_hint(size, RP_MEM_BULK);
 }
 
 void rp_mem_free(void *ptr)
 {
-    if (!rp_pico_alloc_init())
+    if (!ptr || !rp_pico_alloc_init())
+        return;
+    rp_mem_heap_t *h = rp_mem_heap_of(ptr);
+    if (!h)
         return;
-    tlsf_free(_mem_heap, ptr);
+
+    critical_section_enter_blocking(&_mem_lock);
+    h->stats.used -= tlsf_block_size(ptr);
+    h->stats.frees++;
+    tlsf_free(h->heap, ptr);
+    critical_section_exit(&_mem_lock);
 }
 
+// Stays in the region the block is in
 void *rp_mem_realloc(void *ptr, size_t size)
 {
+    if (!ptr)
+        return rp_mem_malloc(size);
     if (!rp_pico_alloc_init())
         return NULL;
-    return tlsf_realloc(_mem_heap, ptr, size);
+    rp_mem_heap_t *h = rp_mem_heap_of(ptr);
+    if (!h)
+        return NULL;
+
+    critical_section_enter_blocking(&_mem_lock);
+    size_t old = tlsf_block_size(ptr);
+    void *p = tlsf_realloc(h->heap, ptr, size);
+    if (p)
+    {
+        h->stats.used += tlsf_block_size(p) - old;
+        if (h->stats.used > h->stats.peak)
+            h->stats.peak = h->stats.used;
+    }
+    else if (size)
+    {
+        h->stats.failed++;
+    }
+    else
+    {
+        // tlsf_realloc to 0 frees
+        h->stats.used -= old;
+        h->stats.frees++;
+    }
+    critical_section_exit(&_mem_lock);
+    return p;
 }
 
 void *rp_mem_calloc(size_t num, size_t size)
 {
-    if (!rp_pico_alloc_init())
-        return NULL;
-    void *ptr = tlsf_malloc(_mem_heap, num * size);
-    if (ptr)
-        memset(ptr, 0, num * size);
-    return ptr;
+    return rp_mem_calloc_hint(num, size, RP_MEM_BULK);
 }
 
 static bool max_free_walker(void *ptr, size_t size, int used, void *user)
@@ -315,15 +438,32 @@ static bool max_free_walker(void *ptr, size_t size, int used, void *user)
     }
     return true;
 }
+
+void rp_mem_get_stats(rp_mem_region_t region, rp_mem_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (region >= RP_MEM_REGION_COUNT || !rp_pico_alloc_init())
+        return;
+    rp_mem_heap_t *h = &_mem_heaps[region];
+
+    critical_section_enter_blocking(&_mem_lock);
+    *stats = h->stats;
+    if (h->pool)
+        tlsf_walk_pool(h->pool, max_free_walker, &stats->max_free);
+    critical_section_exit(&_mem_lock);
+}
+
 size_t rp_mem_max_free_size(void)
 {
-    if (!rp_pico_alloc_init())
-        return 0;
+    rp_mem_stats_t stats;
     size_t max_free = 0;
-    tlsf_walk_pool(_mem_sram_pool, max_free_walker, &max_free);
-    if (_mem_psram_pool)
-        tlsf_walk_pool(_mem_psram_pool, max_free_walker, &max_free);
 
+    for (int i = 0; i < RP_MEM_REGION_COUNT; i++)
+    {
+        rp_mem_get_stats((rp_mem_region_t)i, &stats);
+        if (stats.max_free > max_free)
+            max_free = stats.max_free;
+    }
     return max_free;
 }
 
@@ -332,7 +472,7 @@ size_t rp_mem_max_free_size(void)
 #if defined(RP_PICO_ALLOC_WRAP)
 void *__wrap_malloc(size_t size)
 {
-    return rp_mem_malloc(size);
+    return rp_mem_malloc_hint(size, RP_MEM_ANY);
 }
 void __wrap_free(void *ptr)
 {
@@ -340,10 +480,12 @@ void __wrap_free(void *ptr)
 }
 void *__wrap_realloc(void *ptr, size_t size)
 {
+    if (!ptr)
+        return rp_mem_malloc_hint(size, RP_MEM_ANY);
     return rp_mem_realloc(ptr, size);
 }
 void *__wrap_calloc(size_t num, size_t size)
 {
-    return rp_mem_calloc(num, size);
+    return rp_mem_calloc_hint(num, size, RP_MEM_ANY);
 }
 #endif
\ No newline at end of file
@@ -4,6 +4,8 @@
 #define _RP_PICO_ALLOC_H_
 
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #define RP2350_XIP_CSI_PIN  47
 #define PSRAM_CMD_QUAD_END 0xF5
@@ -27,15 +29,67 @@
 // from psram datasheet - max Freq at 3.3v
 #define PSRAM_MAX_SCK_HZ 109000000.f
 
+// SRAM heap behind the FAST and DMA hints: a static reserve of this size,
+// or the whole malloc heap when malloc is wrapped
+#ifndef RP_MEM_SRAM_POOL_SIZE
+#define RP_MEM_SRAM_POOL_SIZE (128 * 1024)
+#endif
+
+// Where an allocation should live. SRAM and PSRAM are separate heaps:
+//  FAST - SRAM only; hot data the CPU touches every frame
+//  DMA  - SRAM only; DMA sources and targets, which would otherwise go
+//         through the XIP cache and QMI
+//  BULK - PSRAM, spilling to SRAM; big, cold data (assets, caches)
+//  ANY  - SRAM, spilling to PSRAM
+// FAST and DMA fail rather than spill; the caller decides what to give up.
+typedef enum
+{
+    RP_MEM_FAST = 0,
+    RP_MEM_DMA,
+    RP_MEM_BULK,
+    RP_MEM_ANY,
+} rp_mem_hint_t;
+
+typedef enum
+{
+    RP_MEM_SRAM = 0,
+    RP_MEM_PSRAM,
+    RP_MEM_REGION_COUNT
+} rp_mem_region_t;
+
+typedef struct
+{
+    size_t size;     // pool bytes, 0 if the region is absent
+    size_t used;     // in blocks handed out, TLSF rounding included
+    size_t peak;
+    size_t max_free; // largest free block
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failed; // requests the region could not satisfy
+    uint32_t spills; // blocks placed here when the hint preferred the other
+} rp_mem_stats_t;
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
+    // Without a hint: BULK
     void *rp_mem_malloc(size_t size);
     void rp_mem_free(void *ptr);
+    // A block stays in its region
     void *rp_mem_realloc(void *ptr, size_t size);
     void *rp_mem_calloc(size_t num, size_t size);
     size_t rp_mem_max_free_size(void);
+    void *rp_mem_malloc_hint(size_t size, rp_mem_hint_t hint);
+    void *rp_mem_calloc_hint(size_t num, size_t size, rp_mem_hint_t hint);
+    rp_mem_region_t rp_mem_region_of(const void *ptr);
+    void rp_mem_get_stats(rp_mem_region_t region, rp_mem_stats_t *stats);
+    // Sets up PSRAM and the heap now rather than on first use; call it
+    // before starting the other core if that core may allocate first
+    bool rp_mem_init(void);
+    // Recomputes the PSRAM timing after a clk_sys change. Nothing may be
+    // accessing PSRAM meanwhile: no DMA from it, the other core parked
+    void rp_mem_update_timing(void);
     static bool rp_pico_alloc_init();
     // wrappers
 #if defined(RP_PICO_ALLOC_WRAP)
@@ -36,9 +36,12 @@ unsigned char QMI8658_write_reg(unsigned char reg, unsigned char value)
 	unsigned char ret = 0;
 	unsigned int retry = 0;
 
+	unsigned char data[2] = {reg, value};
+
+	// Retry only on NAK; a successful write is not repeated
 	while ((!ret) && (retry++ < 5))
 	{
-		DEV_I2C_Write_Byte(QMI8658_slave_addr, reg, value);
+		ret = i2c_dma_transfer_blocking(I2C_PORT, QMI8658_slave_addr, data, 2, NULL, 0);
 	}
 	return ret;
 }
@@ -57,11 +60,7 @@ unsigned char QMI8658_write_regs(unsigned char reg, unsigned char *value, unsign
 
 unsigned char QMI8658_read_reg(unsigned char reg, unsigned char *buf, unsigned short len)
 {
-	unsigned char ret = 0;
-	unsigned int retry = 0;
-	DEV_I2C_Read_nByte(QMI8658_slave_addr, reg, buf, len);
-
-	return ret;
+	return i2c_dma_transfer_blocking(I2C_PORT, QMI8658_slave_addr, &reg, 1, buf, len);
 }
 
 #if 0
@@ -460,24 +459,35 @@ void QMI8658_read_ae(float quat[4], float velocity[3])
 	velocity[2] = (float)(raw_v_xyz[2] * 1.0f) / ae_v_lsb_div;
 }
 
-void QMI8658_doCtrl9Command(enum QMI8658_Ctrl9Command cmd)
+static unsigned char QMI8658_waitCtrl9Done(void)
 {
-	uint8_t val;
+	unsigned char status = 0;
+	int retry = 0;
 
-	QMI8658_write_reg(QMI8658Register_Ctrl9, cmd);
-	DEV_KEY_Config(DOF_INT1);
-	
-	while (1)
+	// Bounded poll: a Ctrl9 command normally completes within a few hundred us
+	while (retry++ < 100)
 	{
-		val = QMI8658_readStatus1();
-		printf("3 :%d \r\n",val);
-		printf("1 :%d \r\n",DEV_Digital_Read(DOF_INT1));
-		if (val & 0x04)
-			break;
-		DEV_Delay_ms(10);
+		QMI8658_read_reg(QMI8658Register_StatusInt, &status, 1);
+		if (status & QMI8658_STATUSINT_CMD_DONE)
+			return 1;
+		DEV_Delay_us(50);
 	}
+	return 0;
+}
+
+unsigned char QMI8658_doCtrl9Command(enum QMI8658_Ctrl9Command cmd)
+{
+	unsigned char done;
+
+	// Bounded, so a missing ack can't hold up the caller's loop; the
+	// NOP acknowledges the command either way
+	QMI8658_write_reg(QMI8658Register_Ctrl9, cmd);
+	done = QMI8658_waitCtrl9Done();
+	QMI8658_write_reg(QMI8658Register_Ctrl9, QMI8658_Ctrl9_Cmd_NOP);
+	return done;
 }
-void QMI8658_enableWakeOnMotion(void)
+
+unsigned char QMI8658_enableWakeOnMotion(void)
 {
 	unsigned char womCmd[3];
 	enum QMI8658_Interrupt interrupt = QMI8658_Int1;
@@ -497,9 +507,10 @@ void QMI8658_enableWakeOnMotion(void)
 
 	
 
-	QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_WoM_Setting);
+	if (!QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_WoM_Setting))
+		return 0;
 	QMI8658_enableSensors(QMI8658_CTRL7_ACC_ENABLE);
-
+	return 1;
 }
 
 void QMI8658_disableWakeOnMotion(void)
@@ -509,6 +520,237 @@ void QMI8658_disableWakeOnMotion(void)
 	// QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_WoM_Setting);
 }
 
+void QMI8658_resume(void)
+{
+	// Leave wake-on-motion and restore the configuration from QMI8658_init()
+	QMI8658_disableWakeOnMotion();
+	QMI8658_Config_apply(&QMI8658_config);
+}
+
+static unsigned char fifo_ctrl_cfg = QMI8658_FIFO_MODE_BYPASS;
+
+void QMI8658_enableFifo(unsigned char size, unsigned char watermark)
+{
+	// Stream mode keeps the newest samples if the host falls behind
+	fifo_ctrl_cfg = size | QMI8658_FIFO_MODE_STREAM;
+	QMI8658_write_reg(QMI8658Register_FifoWtmTh, watermark);
+	QMI8658_write_reg(QMI8658Register_FifoCtrl, fifo_ctrl_cfg);
+}
+
+static void QMI8658_unpack_fifo(const unsigned char *buf, unsigned short count, short raw_acc_xyz[][3], short raw_gyro_xyz[][3])
+{
+	for (unsigned short i = 0; i < count; i++)
+	{
+		const unsigned char *p = &buf[i * 12];
+		raw_acc_xyz[i][0] = (short)((unsigned short)(p[1] << 8) | (p[0]));
+		raw_acc_xyz[i][1] = (short)((unsigned short)(p[3] << 8) | (p[2]));
+		raw_acc_xyz[i][2] = (short)((unsigned short)(p[5] << 8) | (p[4]));
+		raw_gyro_xyz[i][0] = (short)((unsigned short)(p[7] << 8) | (p[6]));
+		raw_gyro_xyz[i][1] = (short)((unsigned short)(p[9] << 8) | (p[8]));
+		raw_gyro_xyz[i][2] = (short)((unsigned short)(p[11] << 8) | (p[10]));
+	}
+}
+
+unsigned short QMI8658_read_fifo_raw(short raw_acc_xyz[][3], short raw_gyro_xyz[][3], unsigned short max_samples)
+{
+	unsigned char buf_reg[2];
+	unsigned char fifo_buf[16 * 12];
+	unsigned short bytes;
+	unsigned short samples;
+	unsigned short done = 0;
+
+	QMI8658_read_reg(QMI8658Register_FifoSmplCnt, buf_reg, 2);
+	bytes = (unsigned short)((((unsigned short)buf_reg[1] & 0x03) << 8) | buf_reg[0]) * 2;
+	samples = bytes / 12; // acc + gyro, 6 bytes each
+	if (samples > max_samples)
+		samples = max_samples;
+	if (samples == 0)
+		return 0;
+
+	QMI8658_write_reg(QMI8658Register_Ctrl9, QMI8658_Ctrl9_Cmd_Req_Fifo);
+	if (!QMI8658_waitCtrl9Done())
+		return 0;
+
+	while (done < samples)
+	{
+		unsigned short chunk = samples - done;
+		if (chunk > 16)
+			chunk = 16;
+		QMI8658_read_reg(QMI8658Register_FifoData, fifo_buf, chunk * 12);
+		QMI8658_unpack_fifo(fifo_buf, chunk, &raw_acc_xyz[done], &raw_gyro_xyz[done]);
+		done += chunk;
+	}
+
+	// Leave FIFO read mode and acknowledge the Ctrl9 command
+	unsigned char ctrl = 0;
+	QMI8658_read_reg(QMI8658Register_FifoCtrl, &ctrl, 1);
+	QMI8658_write_reg(QMI8658Register_FifoCtrl, ctrl & ~QMI8658_FIFO_CTRL_RD_MODE);
+	QMI8658_write_reg(QMI8658Register_Ctrl9, QMI8658_Ctrl9_Cmd_NOP);
+
+	return done;
+}
+
+/*
+ * Non-blocking FIFO drain. Same sequence as QMI8658_read_fifo_raw(), but each
+ * bus step is a queued DMA transaction whose completion (I2C interrupt)
+ * submits the next one, so the caller never waits on the bus.
+ */
+enum
+{
+	FIFO_RD_IDLE = 0,
+	FIFO_RD_COUNT,
+	FIFO_RD_REQ,
+	FIFO_RD_WAIT,
+	FIFO_RD_DATA,
+	FIFO_RD_EXIT,
+	FIFO_RD_ACK,
+};
+
+static struct
+{
+	i2c_txn_t txn;
+	volatile unsigned char state;
+	unsigned char wr[2];
+	unsigned char buf[16 * 12];
+	short (*acc)[3];
+	short (*gyro)[3];
+	unsigned short max;
+	unsigned short samples;
+	unsigned short done;
+	unsigned char retry;
+	void (*cb)(unsigned short count);
+} fifo_rd;
+
+static void QMI8658_fifo_step(i2c_txn_t *txn);
+
+static void QMI8658_fifo_finish(unsigned short count)
+{
+	fifo_rd.state = FIFO_RD_IDLE;
+	if (fifo_rd.cb)
+		fifo_rd.cb(count);
+}
+
+static void QMI8658_fifo_submit(unsigned char state, unsigned char reg, unsigned char value, unsigned short rd_len)
+{
+	fifo_rd.state = state;
+	fifo_rd.wr[0] = reg;
+	fifo_rd.wr[1] = value;
+	fifo_rd.txn.addr = QMI8658_slave_addr;
+	fifo_rd.txn.wr = fifo_rd.wr;
+	fifo_rd.txn.wr_len = rd_len ? 1 : 2;
+	fifo_rd.txn.rd = fifo_rd.buf;
+	fifo_rd.txn.rd_len = rd_len;
+	fifo_rd.txn.cb = QMI8658_fifo_step;
+	if (!i2c_dma_submit(I2C_PORT, &fifo_rd.txn))
+		QMI8658_fifo_finish(0);
+}
+
+static void QMI8658_fifo_next_chunk(void)
+{
+	unsigned short chunk = fifo_rd.samples - fifo_rd.done;
+	if (chunk > 16)
+		chunk = 16;
+	QMI8658_fifo_submit(FIFO_RD_DATA, QMI8658Register_FifoData, 0, chunk * 12);
+}
+
+static void QMI8658_fifo_step(i2c_txn_t *txn)
+{
+	if (txn->status != I2C_TXN_DONE)
+	{
+		// Once the Ctrl9 request went out the chip must be taken back out
+		// of FIFO read mode, otherwise just give up on this batch
+		if (fifo_rd.state >= FIFO_RD_WAIT && fifo_rd.state < FIFO_RD_EXIT)
+			QMI8658_fifo_submit(FIFO_RD_EXIT, QMI8658Register_FifoCtrl, fifo_ctrl_cfg, 0);
+		else
+			QMI8658_fifo_finish(0);
+		return;
+	}
+
+	switch (fifo_rd.state)
+	{
+	case FIFO_RD_COUNT:
+		fifo_rd.samples = (unsigned short)((((unsigned short)fifo_rd.buf[1] & 0x03) << 8) | fifo_rd.buf[0]) * 2 / 12;
+		if (fifo_rd.samples > fifo_rd.max)
+			fifo_rd.samples = fifo_rd.max;
+		if (fifo_rd.samples == 0)
+			QMI8658_fifo_finish(0);
+		else
+			QMI8658_fifo_submit(FIFO_RD_REQ, QMI8658Register_Ctrl9, QMI8658_Ctrl9_Cmd_Req_Fifo, 0);
+		break;
+	case FIFO_RD_REQ:
+		fifo_rd.retry = 0;
+		QMI8658_fifo_submit(FIFO_RD_WAIT, QMI8658Register_StatusInt, 0, 1);
+		break;
+	case FIFO_RD_WAIT:
+		if (fifo_rd.buf[0] & QMI8658_STATUSINT_CMD_DONE)
+			QMI8658_fifo_next_chunk();
+		else if (++fifo_rd.retry < 100)
+			QMI8658_fifo_submit(FIFO_RD_WAIT, QMI8658Register_StatusInt, 0, 1);
+		else
+			QMI8658_fifo_submit(FIFO_RD_EXIT, QMI8658Register_FifoCtrl, fifo_ctrl_cfg, 0);
+		break;
+	case FIFO_RD_DATA:
+	{
+		unsigned short chunk = txn->rd_len / 12;
+		QMI8658_unpack_fifo(fifo_rd.buf, chunk, &fifo_rd.acc[fifo_rd.done], &fifo_rd.gyro[fifo_rd.done]);
+		fifo_rd.done += chunk;
+		if (fifo_rd.done < fifo_rd.samples)
+			QMI8658_fifo_next_chunk();
+		else
+			QMI8658_fifo_submit(FIFO_RD_EXIT, QMI8658Register_FifoCtrl, fifo_ctrl_cfg, 0);
+		break;
+	}
+	case FIFO_RD_EXIT:
+		QMI8658_fifo_submit(FIFO_RD_ACK, QMI8658Register_Ctrl9, QMI8658_Ctrl9_Cmd_NOP, 0);
+		break;
+	case FIFO_RD_ACK:
+	default:
+		QMI8658_fifo_finish(fifo_rd.done);
+		break;
+	}
+}
+
+unsigned char QMI8658_read_fifo_async(short raw_acc_xyz[][3], short raw_gyro_xyz[][3], unsigned short max_samples, void (*done)(unsigned short count))
+{
+	if (fifo_rd.state != FIFO_RD_IDLE || max_samples == 0)
+		return 0;
+
+	fifo_rd.acc = raw_acc_xyz;
+	fifo_rd.gyro = raw_gyro_xyz;
+	fifo_rd.max = max_samples;
+	fifo_rd.done = 0;
+	fifo_rd.cb = done;
+	QMI8658_fifo_submit(FIFO_RD_COUNT, QMI8658Register_FifoSmplCnt, 0, 2);
+	return 1;
+}
+
+unsigned short QMI8658_get_acc_lsb_div(void)
+{
+	return acc_lsb_div;
+}
+
+unsigned short QMI8658_get_gyro_lsb_div(void)
+{
+	return gyro_lsb_div;
+}
+
+unsigned int QMI8658_get_odr_hz(void)
+{
+	switch (QMI8658_config.accOdr)
+	{
+	case QMI8658AccOdr_LowPower_128Hz:
+		return 128;
+	case QMI8658AccOdr_LowPower_21Hz:
+		return 21;
+	case QMI8658AccOdr_LowPower_11Hz:
+		return 11;
+	case QMI8658AccOdr_LowPower_3Hz:
+		return 3;
+	default:
+		return 8000u >> QMI8658_config.accOdr;
+	}
+}
+
 void QMI8658_enableSensors(unsigned char enableFlags)
 {
 	if (enableFlags & QMI8658_CONFIG_AE_ENABLE)
@@ -32,6 +32,19 @@
 #define QMI8658_STATUS1_CMD_DONE (0x01)
 #define QMI8658_STATUS1_WAKEUP_EVENT (0x04)
 
+#define QMI8658_STATUSINT_CMD_DONE (0x80)
+
+#define QMI8658_FIFO_CTRL_RD_MODE (0x80)
+#define QMI8658_FIFO_MODE_BYPASS (0x00)
+#define QMI8658_FIFO_MODE_FIFO (0x01)
+#define QMI8658_FIFO_MODE_STREAM (0x02)
+#define QMI8658_FIFO_SIZE_16 (0x00 << 2)
+#define QMI8658_FIFO_SIZE_32 (0x01 << 2)
+#define QMI8658_FIFO_SIZE_64 (0x02 << 2)
+#define QMI8658_FIFO_SIZE_128 (0x03 << 2)
+#define QMI8658_FIFO_STATUS_FULL (0x80)
+#define QMI8658_FIFO_STATUS_OVERFLOW (0x20)
+
 enum QMI8658Register
 {
     /*! \brief FIS device identifier register. */
@@ -72,12 +85,16 @@ enum QMI8658Register
     QMI8658Register_Cal4_L,
     /*! \brief Calibration register 4 least significant byte. */
     QMI8658Register_Cal4_H,
+    /*! \brief FIFO watermark level, in ODR samples. */
+    QMI8658Register_FifoWtmTh = 19,
     /*! \brief FIFO control register. */
-    QMI8658Register_FifoCtrl = 19,
-    /*! \brief FIFO data register. */
-    QMI8658Register_FifoData, // 20
+    QMI8658Register_FifoCtrl, // 20
+    /*! \brief FIFO sample count least significant byte. */
+    QMI8658Register_FifoSmplCnt, // 21
     /*! \brief FIFO status register. */
-    QMI8658Register_FifoStatus, // 21
+    QMI8658Register_FifoStatus, // 22
+    /*! \brief FIFO data register. */
+    QMI8658Register_FifoData, // 23
     /*! \brief Output data overrun and availability. */
     QMI8658Register_StatusInt = 45,
     /*! \brief Output data overrun and availability. */
@@ -224,6 +241,7 @@ enum QMI8658_Ctrl9Command
     QMI8658_Ctrl9_Cmd_NOP = 0X00,
     QMI8658_Ctrl9_Cmd_GyroBias = 0X01,
     QMI8658_Ctrl9_Cmd_Rqst_Sdi_Mod = 0X03,
+    QMI8658_Ctrl9_Cmd_Req_Fifo = 0x05,
     QMI8658_Ctrl9_Cmd_WoM_Setting = 0x08,
     QMI8658_Ctrl9_Cmd_AccelHostDeltaOffset = 0x09,
     QMI8658_Ctrl9_Cmd_GyroHostDeltaOffset = 0x0A,
@@ -484,7 +502,14 @@ extern void QMI8658_read_ae(float quat[4], float velocity[3]);
 extern unsigned char QMI8658_readStatus0(void);
 extern unsigned char QMI8658_readStatus1(void);
 extern float QMI8658_readTemp(void);
-extern void QMI8658_enableWakeOnMotion(void);
+extern unsigned char QMI8658_enableWakeOnMotion(void);
 extern void QMI8658_disableWakeOnMotion(void);
+extern void QMI8658_resume(void);
+extern void QMI8658_enableFifo(unsigned char size, unsigned char watermark);
+extern unsigned short QMI8658_read_fifo_raw(short raw_acc_xyz[][3], short raw_gyro_xyz[][3], unsigned short max_samples);
+extern unsigned char QMI8658_read_fifo_async(short raw_acc_xyz[][3], short raw_gyro_xyz[][3], unsigned short max_samples, void (*done)(unsigned short count));
+extern unsigned short QMI8658_get_acc_lsb_div(void);
+extern unsigned short QMI8658_get_gyro_lsb_div(void);
+extern unsigned int QMI8658_get_odr_hz(void);
 
 #endif
@@ -8,115 +8,142 @@
 #include "hardware/pio.h"
 #endif
 
-// --------------- //
-// qspi_4wire_data //
-// --------------- //
+// ---------- //
+// qspi_frame //
+// ---------- //
 
-#define qspi_4wire_data_wrap_target 0
-#define qspi_4wire_data_wrap 1
-#define qspi_4wire_data_pio_version 0
+#define qspi_frame_wrap_target 0
+#define qspi_frame_wrap 15
+#define qspi_frame_pio_version 0
 
-static const uint16_t qspi_4wire_data_program_instructions[] = {
+static const uint16_t qspi_frame_program_instructions[] = {
             //     .wrap_target
-    0x7004, //  0: out    pins, 4         side 0
-    0xb842, //  1: nop                    side 1
+    0x70c2, //  0: out    isr, 2          side 0
+    0x6049, //  1: out    y, 9
+    0x6035, //  2: out    x, 21
+    0xe000, //  3: set    pins, 0
+    0x0085, //  4: jmp    y--, 5
+    0x7001, //  5: out    pins, 1         side 0
+    0x1885, //  6: jmp    y--, 5          side 1
+    0xb046, //  7: mov    y, isr          side 0
+    0x000a, //  8: jmp    10
+    0x6068, //  9: out    null, 8
+    0x0089, // 10: jmp    y--, 9
+    0x002f, // 11: jmp    !x, 15
+    0x004d, // 12: jmp    x--, 13
+    0x7004, // 13: out    pins, 4         side 0
+    0x184d, // 14: jmp    x--, 13         side 1
+    0xf301, // 15: set    pins, 1         side 0 [3]
             //     .wrap
 };
 
 #if !PICO_NO_HARDWARE
-static const struct pio_program qspi_4wire_data_program = {
-    .instructions = qspi_4wire_data_program_instructions,
-    .length = 2,
+static const struct pio_program qspi_frame_program = {
+    .instructions = qspi_frame_program_instructions,
+    .length = 16,
     .origin = -1,
-    .pio_version = qspi_4wire_data_pio_version,
+    .pio_version = qspi_frame_pio_version,
 #if PICO_PIO_VERSION > 0
     .used_gpio_ranges = 0x0
 #endif
 };
 
-static inline pio_sm_config qspi_4wire_data_program_get_default_config(uint offset) {
+static inline pio_sm_config qspi_frame_program_get_default_config(uint offset) {
     pio_sm_config c = pio_get_default_sm_config();
-    sm_config_set_wrap(&c, offset + qspi_4wire_data_wrap_target, offset + qspi_4wire_data_wrap);
+    sm_config_set_wrap(&c, offset + qspi_frame_wrap_target, offset + qspi_frame_wrap);
     sm_config_set_sideset(&c, 2, true, false);
     return c;
 }
+
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+static inline void qspi_frame_program_init(PIO pio, uint sm, uint offset, uint pin_scl, uint pin_cs, uint out_base, uint out_pin_num, uint32_t div_int, uint8_t div_frac) {
+    pio_sm_config c = qspi_frame_program_get_default_config( offset );  
+    // CLK
+    pio_gpio_init(pio, pin_scl);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin_scl, 1, true);
+    sm_config_set_sideset_pins(&c, pin_scl);
+    // CS, idle high
+    pio_sm_set_pins_with_mask(pio, sm, 1u << pin_cs, (1u << pin_cs) | (1u << pin_scl));
+    pio_gpio_init(pio, pin_cs);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin_cs, 1, true);
+    sm_config_set_set_pins(&c, pin_cs, 1);
+    // DAT
+    sm_config_set_out_pins(&c, out_base, out_pin_num);
+    sm_config_set_out_shift(&c, false, true, 32);
+    for (uint32_t pin_offset = 0; pin_offset < out_pin_num; pin_offset++) {
+        pio_gpio_init(pio, out_base + pin_offset);
+    }
+    pio_sm_set_consecutive_pindirs(pio, sm, out_base, out_pin_num, true);
+    // Deeper FIFO so DMA refills never starve the clock
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    // PIO CLK, two cycles per SCLK period
+    sm_config_set_clkdiv_int_frac8(&c, div_int, div_frac);
+    // INIT
+    pio_sm_init( pio, sm, offset, &c );
+    pio_sm_clear_fifos( pio , sm);
+    pio_sm_set_enabled( pio, sm, true );
+}
+
 #endif
 
-// --------------- //
-// qspi_1write_cmd //
-// --------------- //
+// --------- //
+// qspi_read //
+// --------- //
 
-#define qspi_1write_cmd_wrap_target 0
-#define qspi_1write_cmd_wrap 1
-#define qspi_1write_cmd_pio_version 0
+#define qspi_read_wrap_target 0
+#define qspi_read_wrap 11
+#define qspi_read_pio_version 0
 
-static const uint16_t qspi_1write_cmd_program_instructions[] = {
+static const uint16_t qspi_read_program_instructions[] = {
             //     .wrap_target
-    0x7001, //  0: out    pins, 1         side 0
-    0xb842, //  1: nop                    side 1
+    0x80a0, //  0: pull   block
+    0x6020, //  1: out    x, 32
+    0x80a0, //  2: pull   block
+    0x6040, //  3: out    y, 32
+    0x80a0, //  4: pull   block
+    0xe000, //  5: set    pins, 0
+    0x7001, //  6: out    pins, 1         side 0
+    0x1846, //  7: jmp    x--, 6          side 1
+    0xb142, //  8: nop                    side 0 [1]
+    0x5801, //  9: in     pins, 1         side 1
+    0x0088, // 10: jmp    y--, 8
+    0xf001, // 11: set    pins, 1         side 0
             //     .wrap
 };
 
 #if !PICO_NO_HARDWARE
-static const struct pio_program qspi_1write_cmd_program = {
-    .instructions = qspi_1write_cmd_program_instructions,
-    .length = 2,
+static const struct pio_program qspi_read_program = {
+    .instructions = qspi_read_program_instructions,
+    .length = 12,
     .origin = -1,
-    .pio_version = qspi_1write_cmd_pio_version,
+    .pio_version = qspi_read_pio_version,
 #if PICO_PIO_VERSION > 0
     .used_gpio_ranges = 0x0
 #endif
 };
 
-static inline pio_sm_config qspi_1write_cmd_program_get_default_config(uint offset) {
+static inline pio_sm_config qspi_read_program_get_default_config(uint offset) {
     pio_sm_config c = pio_get_default_sm_config();
-    sm_config_set_wrap(&c, offset + qspi_1write_cmd_wrap_target, offset + qspi_1write_cmd_wrap);
+    sm_config_set_wrap(&c, offset + qspi_read_wrap_target, offset + qspi_read_wrap);
     sm_config_set_sideset(&c, 2, true, false);
     return c;
 }
 
-#include "hardware/clocks.h"
-#include "hardware/gpio.h"
-static inline void qspi_4wire_data_program_init(PIO pio, uint sm, uint offset, uint pin_scl, uint out_base, uint out_pin_num) {
-    pio_sm_config c = qspi_4wire_data_program_get_default_config( offset );  
-    // CLK
-    pio_gpio_init(pio, pin_scl);
-    pio_sm_set_consecutive_pindirs(pio, sm, pin_scl, 1, true);
+static inline void qspi_read_program_init(PIO pio, uint sm, uint offset, uint pin_scl, uint pin_cs, uint pin_mosi, uint pin_miso, uint32_t div_int, uint8_t div_frac) {
+    pio_sm_config c = qspi_read_program_get_default_config( offset );
+    // Pins are set up and owned by the frame engine; only the mapping here
     sm_config_set_sideset_pins(&c, pin_scl);
-    // DAT
-    sm_config_set_out_pins(&c, out_base, out_pin_num);
-    sm_config_set_out_shift(&c, false, true, 8);
-    for (uint32_t pin_offset = 0; pin_offset < out_pin_num; pin_offset++) {
-        pio_gpio_init(pio, out_base + pin_offset);
-    }
-    pio_sm_set_consecutive_pindirs(pio, sm, out_base, out_pin_num, true);
-    // PIO CLK
-    sm_config_set_clkdiv( &c, 2.0f);
-    // INIT
-    pio_sm_init( pio, sm, offset, &c );
-    pio_sm_clear_fifos( pio , sm);
-    pio_sm_set_enabled( pio, sm, true );
-}
-static inline void qspi_1write_cmd_program_init(PIO pio, uint sm, uint offset, uint pin_scl, uint out_base, uint out_pin_num) {
-    pio_sm_config c = qspi_1write_cmd_program_get_default_config( offset );
-    // CLK
-    pio_gpio_init(pio, pin_scl);
-    pio_sm_set_consecutive_pindirs(pio, sm, pin_scl, 1, true);
-    sm_config_set_sideset_pins(&c, pin_scl);
-    // DAT
-    sm_config_set_out_pins(&c, out_base, out_pin_num);
-    sm_config_set_out_shift(&c, false, true, 8);
-    for (uint32_t pin_offset = 0; pin_offset < out_pin_num; pin_offset++) {
-        pio_gpio_init(pio, out_base + pin_offset);
-    }
-    pio_sm_set_consecutive_pindirs(pio, sm, out_base, out_pin_num, true);
-    // PIO CLK
-    sm_config_set_clkdiv( &c, 2.0f);
-    // INIT
+    sm_config_set_set_pins(&c, pin_cs, 1);
+    sm_config_set_out_pins(&c, pin_mosi, 1);
+    sm_config_set_in_pins(&c, pin_miso);
+    sm_config_set_out_shift(&c, false, false, 32);
+    sm_config_set_in_shift(&c, false, true, 8);
+    // PIO CLK, four cycles per SCLK period
+    sm_config_set_clkdiv_int_frac8(&c, div_int, div_frac);
+    // INIT, left stopped
     pio_sm_init( pio, sm, offset, &c );
     pio_sm_clear_fifos( pio , sm);
-    pio_sm_set_enabled( pio, sm, true );
 }
 
 #endif
-
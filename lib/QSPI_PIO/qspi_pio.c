@@ -28,6 +28,7 @@
 ******************************************************************************/
 #include "qspi_pio.h"
 #include "pico/stdlib.h"
+#include "hardware/clocks.h"
 pio_qspi_t qspi = {
     .pio = pio0,
     .sm = 0,
@@ -43,6 +44,9 @@ pio_qspi_t qspi = {
     .pin_rst = PIN_RST
 };
 
+static uint32_t qspi_sclk_target = QSPI_SCLK_HZ_DEFAULT;
+static uint32_t qspi_sclk_hz;
+
 /******************************************************************************
 function : QSPI related GPIO initialization
 parameter:
@@ -63,21 +67,51 @@ void QSPI_GPIO_Init(pio_qspi_t qspi){
 }
 
 /******************************************************************************
-function : QSPI Select
+function : Wait until every queued nibble has been clocked out
 parameter:
     qspi : QSPI structure
+info     : DMA completion only means the last word reached the TX FIFO;
+           the frame is on the wire once the program stalls on the next
+           header, with CS already released
 ******************************************************************************/	
-void QSPI_Select(pio_qspi_t qspi){
-    gpio_put(qspi.pin_cs,0);
+static void QSPI_Wait_SM_Idle(PIO pio, uint sm){
+    uint32_t stall = 1u << (PIO_FDEBUG_TXSTALL_LSB + sm);
+
+    // A stopped state machine never stalls
+    if (!(pio->ctrl & (1u << (PIO_CTRL_SM_ENABLE_LSB + sm))))
+        return;
+    pio->fdebug = stall;
+    while (!(pio->fdebug & stall))
+        tight_loop_contents();
+}
+
+void QSPI_Wait_Idle(pio_qspi_t qspi){
+    QSPI_Wait_SM_Idle(qspi.pio, qspi.sm);
 }
 
 /******************************************************************************
-function : QSPI Deselect
+function : Work out a PIO divider for an SCLK target
 parameter:
-    qspi : QSPI structure
-******************************************************************************/	
-void QSPI_Deselect(pio_qspi_t qspi){
-    gpio_put(qspi.pin_cs,1);
+    hz       : SCLK target
+    cycles   : PIO cycles per SCLK period
+    div_int  : receives the integer part of the divider
+    div_frac : receives the fraction, in 1/256
+info     : Rounded up so SCLK never runs faster than asked; returns the
+           resulting SCLK. A fractional divider dithers the edges, so single
+           periods can be one system clock shorter.
+******************************************************************************/
+static uint32_t QSPI_Clock_Div(uint32_t hz, uint32_t cycles, uint32_t *div_int, uint8_t *div_frac){
+    uint64_t sys = clock_get_hz(clk_sys);
+    uint64_t den = (uint64_t)hz * cycles;
+    uint64_t div = (sys * 256 + den - 1) / den;
+
+    if (div < 0x100)
+        div = 0x100;
+    if (div > 0xffffff)
+        div = 0xffffff;
+    *div_int = div >> 8;
+    *div_frac = div & 0xff;
+    return sys * 256 / (div * cycles);
 }
 
 /******************************************************************************
@@ -86,122 +120,202 @@ parameter:
     qspi : QSPI structure
 ******************************************************************************/	
 void QSPI_PIO_Init(pio_qspi_t qspi){
-    uint offset = pio_add_program(qspi.pio, &qspi_4wire_data_program);
-    qspi_4wire_data_program_init(qspi.pio, qspi.sm_4wire, offset, PIN_SCLK, PIN_DIO0, 4);
+    uint32_t div_int;
+    uint8_t div_frac;
 
-    // offset = pio_add_program(qspi.pio, &qspi_1write_cmd_program);
-    // qspi_1write_cmd_program_init(qspi.pio, qspi.sm_1wire, offset, PIN_SCLK, PIN_DIO0, 1);
-    // pio_sm_clear_fifos(qspi.pio, qspi.sm_1wire);
+    uint offset = pio_add_program(qspi.pio, &qspi_frame_program);
+    qspi_sclk_hz = QSPI_Clock_Div(qspi_sclk_target, 2, &div_int, &div_frac);
+    qspi_frame_program_init(qspi.pio, qspi.sm_4wire, offset, PIN_SCLK, PIN_CS, PIN_DIO0, 4, div_int, div_frac);
+
+    offset = pio_add_program(qspi.pio, &qspi_read_program);
+    QSPI_Clock_Div(QSPI_READ_SCLK_HZ, 4, &div_int, &div_frac);
+    qspi_read_program_init(qspi.pio, qspi.sm_1wire, offset, PIN_SCLK, PIN_CS, PIN_DIO0, PIN_MISO, div_int, div_frac);
 
     pio_sm_set_enabled(qspi.pio, qspi.sm_4wire, false);  
     pio_sm_set_enabled(qspi.pio, qspi.sm_1wire, false);  
 }
 
 /******************************************************************************
-function : QSPI PIO one-line mode, generally used to send commands
+function : Start the frame engine; both lane widths run from one program
 parameter:
     qspi : QSPI structure
 ******************************************************************************/	
-void QSPI_1Wrie_Mode(pio_qspi_t *qspi){
-    pio_sm_set_enabled(qspi->pio, qspi->sm_4wire, false);  
-    pio_sm_set_enabled(qspi->pio, qspi->sm_1wire, true);  
-    qspi->sm = qspi->sm_1wire;
+void QSPI_4Wrie_Mode(pio_qspi_t *qspi){
+    pio_sm_set_enabled(qspi->pio, qspi->sm_4wire, true); 
+    pio_sm_set_enabled(qspi->pio, qspi->sm_1wire, false);   
+    qspi->sm = qspi->sm_4wire;
 }
 
 /******************************************************************************
-function : QSPI PIO four-wire mode, generally used to send data
+function : Set the SCLK target for display traffic
 parameter:
     qspi : QSPI structure
+    hz   : SCLK target
+info     : Returns the SCLK actually reached. No DMA may be feeding the
+           frame engine (LCD_3IN49_Flush_Wait)
 ******************************************************************************/	
-void QSPI_4Wrie_Mode(pio_qspi_t *qspi){
-    pio_sm_set_enabled(qspi->pio, qspi->sm_4wire, true); 
-    pio_sm_set_enabled(qspi->pio, qspi->sm_1wire, false);   
-    qspi->sm = qspi->sm_4wire;
+uint32_t QSPI_Set_Clock(pio_qspi_t qspi, uint32_t hz){
+    qspi_sclk_target = hz;
+    QSPI_Update_Clock(qspi);
+    return qspi_sclk_hz;
+}
+
+uint32_t QSPI_Get_Clock(void){
+    return qspi_sclk_hz;
 }
 
 /******************************************************************************
-function : QSPI PIO sends data
+function : Recompute the PIO dividers from the current system clock
 parameter:
     qspi : QSPI structure
+info     : Call whenever clk_sys changes, with display traffic stopped
+           across the change, as for rp_mem_update_timing
 ******************************************************************************/	
-static void QSPI_PIO_Write(pio_qspi_t qspi, uint32_t val){
-    pio_sm_put_blocking(qspi.pio, qspi.sm, val << 24);
+void QSPI_Update_Clock(pio_qspi_t qspi){
+    uint32_t div_int;
+    uint8_t div_frac;
+
+    // Let the frame in flight finish at the clock it started with
+    QSPI_Wait_SM_Idle(qspi.pio, qspi.sm_4wire);
+    qspi_sclk_hz = QSPI_Clock_Div(qspi_sclk_target, 2, &div_int, &div_frac);
+    pio_sm_set_clkdiv_int_frac8(qspi.pio, qspi.sm_4wire, div_int, div_frac);
+    QSPI_Clock_Div(QSPI_READ_SCLK_HZ, 4, &div_int, &div_frac);
+    pio_sm_set_clkdiv_int_frac8(qspi.pio, qspi.sm_1wire, div_int, div_frac);
 }
 
 /******************************************************************************
-function : QSPI PIO 1-wire mode sends data
+function : Read a panel register over one lane
 parameter:
     qspi : QSPI structure
+    cmd  : Register address
+    data : receives the register bytes
+    len  : number of bytes to read
+info     : Runs at QSPI_READ_SCLK_HZ whatever the write clock. The frame
+           engine is stopped for the read and PIN_MISO turned around, so no
+           DMA may be feeding it (LCD_3IN49_Flush_Wait)
 ******************************************************************************/	
-void QSPI_DATA_Write(pio_qspi_t qspi, uint32_t val){
-    // QSPI_PIO_Write(qspi,val);
-    uint8_t cmd_buf[4];
-    uint8_t buf_temp;
-    for (int i = 0; i < 4; ++i)
-    {
-        uint8_t bit1 = (val & (1 << (2 * i))) ? 1 : 0;
-        uint8_t bit2 = (val & (1 << (2 * i + 1))) ? 1 : 0;
-        cmd_buf[3 - i] = bit1 | (bit2 << 4);
-    }
-
-    for (int i = 0; i < 4 ; i++)
-    {
-        QSPI_PIO_Write(qspi,cmd_buf[i]);
-    }
+void QSPI_Register_Read(pio_qspi_t qspi, uint8_t cmd, uint8_t *data, size_t len){
+    PIO pio = qspi.pio;
+
+    if (len == 0)
+        return;
+    QSPI_Wait_SM_Idle(pio, qspi.sm_4wire);
+    pio_sm_set_enabled(pio, qspi.sm_4wire, false);
+    pio_sm_set_consecutive_pindirs(pio, qspi.sm_1wire, PIN_MISO, 1, false);
+    pio_sm_set_enabled(pio, qspi.sm_1wire, true);
+
+    pio_sm_put_blocking(pio, qspi.sm_1wire, 32 - 1);
+    pio_sm_put_blocking(pio, qspi.sm_1wire, len * 8 - 1);
+    pio_sm_put_blocking(pio, qspi.sm_1wire, (uint32_t)QSPI_OP_READ << 24 | (uint32_t)cmd << 8);
+    for (size_t i = 0; i < len; i++)
+        data[i] = pio_sm_get_blocking(pio, qspi.sm_1wire);
+
+    // CS is released once the program is back waiting for a command
+    QSPI_Wait_SM_Idle(pio, qspi.sm_1wire);
+    pio_sm_set_enabled(pio, qspi.sm_1wire, false);
+    pio_sm_set_consecutive_pindirs(pio, qspi.sm_1wire, PIN_MISO, 1, true);
+    pio_sm_set_enabled(pio, qspi.sm_4wire, true);
 }
 
 /******************************************************************************
-function : QSPI PIO 1-wire mode sends data
+function : QSPI PIO sends frame bytes
 parameter:
     qspi : QSPI structure
+    buf  : frame bytes, a whole number of words
+    len  : number of bytes
+info     : Packs the bytes MSB first, as the byte-swapping DMA does
 ******************************************************************************/	
-void QSPI_CMD_Write(pio_qspi_t qspi, uint32_t val){
-    // QSPI_PIO_Write(qspi,val);
-    uint8_t cmd_buf[4];
-    uint8_t buf_temp;
-    for (int i = 0; i < 4; ++i)
-    {
-        uint8_t bit1 = (val & (1 << (2 * i))) ? 1 : 0;
-        uint8_t bit2 = (val & (1 << (2 * i + 1))) ? 1 : 0;
-        cmd_buf[3 - i] = bit1 | (bit2 << 4);
-    }
-
-    for (int i = 0; i < 4 ; i++)
-    {
-        QSPI_PIO_Write(qspi,cmd_buf[i]);
-    }
+static void QSPI_PIO_Write(pio_qspi_t qspi, const uint8_t *buf, size_t len){
+    for (size_t i = 0; i < len; i += 4)
+        pio_sm_put_blocking(qspi.pio, qspi.sm,
+                            (uint32_t)buf[i] << 24 | (uint32_t)buf[i + 1] << 16 |
+                            (uint32_t)buf[i + 2] << 8 | buf[i + 3]);
 }
 
 /******************************************************************************
-function : QSPI PIO 1-wire mode configuration register
+function : Build a frame header
 parameter:
-    qspi : QSPI structure
-    addr : Register address
+    buf          : receives QSPI_FRAME_HEADER_BYTES bytes
+    single_bytes : bytes sent on DIO0 only (opcode + address + parameters)
+    quad_bytes   : bytes sent on all four lanes after them, a multiple of 4
+******************************************************************************/	
+size_t QSPI_Build_Header(uint8_t *buf, uint32_t single_bytes, uint32_t quad_bytes){
+    uint32_t pad = QSPI_PAD_BYTES(single_bytes);
+    uint32_t word = pad << 30 | (single_bytes * 8) << 21 | (quad_bytes * 2);
+    buf[0] = word >> 24;
+    buf[1] = word >> 16;
+    buf[2] = word >> 8;
+    buf[3] = word;
+    return QSPI_FRAME_HEADER_BYTES;
+}
+
+/******************************************************************************
+function : Build the header and 1-lane opcode/address of a frame
+parameter:
+    buf        : receives QSPI_CMD_BYTES(0) bytes
+    op         : QSPI opcode
+    cmd        : register address
+    params     : 1-lane parameter bytes that will follow
+    quad_bytes : 4-lane bytes that will follow
+******************************************************************************/	
+static size_t QSPI_Build_Opening(uint8_t *buf, uint8_t op, uint8_t cmd, uint32_t params, uint32_t quad_bytes){
+    uint8_t *p = buf + QSPI_Build_Header(buf, 4 + params, quad_bytes);
+    *p++ = op;
+    *p++ = 0x00;
+    *p++ = cmd;
+    *p++ = 0x00;
+    return p - buf;
+}
+
+/******************************************************************************
+function : Build a register write frame
+parameter:
+    buf  : receives QSPI_CMD_BYTES(len) bytes
+    cmd  : register address
+    data : parameter bytes
+    len  : number of parameter bytes, at most QSPI_CMD_MAX_PARAMS
 ******************************************************************************/	
-void QSPI_REGISTER_Write(pio_qspi_t qspi, uint32_t addr){
-    //1 WIRE CMD
-    QSPI_CMD_Write(qspi,0x02);
+size_t QSPI_Build_Command(uint8_t *buf, uint8_t cmd, const uint8_t *data, size_t len){
+    uint8_t *p = buf + QSPI_Build_Opening(buf, QSPI_OP_REGISTER, cmd, len, 0);
+    for (size_t i = 0; i < len; i++)
+        *p++ = data[i];
+    for (size_t i = 0; i < QSPI_PAD_BYTES(4 + len); i++)
+        *p++ = 0x00;
+    return p - buf;
+}
 
-    //1 WIRE ADDR
-    QSPI_DATA_Write(qspi,0x00);
-    QSPI_DATA_Write(qspi,addr);
-    QSPI_DATA_Write(qspi,0x00);
-    // WAIT_TIME();
+/******************************************************************************
+function : Build the opening of a pixel write frame
+parameter:
+    buf   : receives QSPI_PIXEL_HEADER_BYTES bytes
+    cmd   : RGB pixel interface register address
+    bytes : pixel bytes that follow on four lanes, a multiple of 4
+******************************************************************************/	
+size_t QSPI_Build_Pixel_Header(uint8_t *buf, uint8_t cmd, uint32_t bytes){
+    return QSPI_Build_Opening(buf, QSPI_OP_PIXEL, cmd, 0, bytes);
 }
 
 /******************************************************************************
-function : QSPI RGB pixel interface one line to send address
+function : QSPI PIO configuration register
 parameter:
     qspi : QSPI structure
-    addr : RGB pixel interface register address
+    cmd  : Register address
+    data : parameter bytes
+    len  : number of parameter bytes, at most QSPI_CMD_MAX_PARAMS
+******************************************************************************/	
+void QSPI_Command_Write(pio_qspi_t qspi, uint8_t cmd, const uint8_t *data, size_t len){
+    uint8_t buf[QSPI_CMD_BYTES(QSPI_CMD_MAX_PARAMS)];
+    QSPI_PIO_Write(qspi, buf, QSPI_Build_Command(buf, cmd, data, len));
+}
+
+/******************************************************************************
+function : QSPI RGB pixel interface, open a pixel frame
+parameter:
+    qspi  : QSPI structure
+    cmd   : RGB pixel interface register address
+    bytes : pixel bytes the caller pushes next (normally by DMA)
 ******************************************************************************/	
-void QSPI_Pixel_Write(pio_qspi_t qspi, uint32_t addr){
-    //1 WIRE CMD
-    QSPI_CMD_Write(qspi,0x32);
-    
-    //1 WIRE ADDR
-    QSPI_DATA_Write(qspi,0x00);
-    QSPI_DATA_Write(qspi,addr);
-    QSPI_DATA_Write(qspi,0x00);
-    // WAIT_TIME();
+void QSPI_Pixel_Write(pio_qspi_t qspi, uint8_t cmd, uint32_t bytes){
+    uint8_t buf[QSPI_PIXEL_HEADER_BYTES];
+    QSPI_PIO_Write(qspi, buf, QSPI_Build_Pixel_Header(buf, cmd, bytes));
 }
@@ -42,13 +42,38 @@
 #define PIN_PWR_EN  37
 #define PIN_RST     34
 
+// Every transfer is one frame: a header word giving how many bits go out on
+// DIO0 alone and how many nibbles on all four lanes, then the body. The PIO
+// program does the lane switching and drives CS around the frame. Frames are
+// streamed as 32-bit words, MSB first; in memory a frame is a byte string
+// that the DMA reads with byte swapping enabled. The 1-lane phase is padded
+// to a word, and the 4-lane phase must be a whole number of words.
+#define QSPI_FRAME_HEADER_BYTES 4
+
+#define QSPI_OP_REGISTER 0x02
+#define QSPI_OP_PIXEL    0x32
+
+#define QSPI_PAD_BYTES(n) ((4 - ((n) & 3)) & 3)
+#define QSPI_CMD_MAX_PARAMS (511 / 8 - 4)
+#define QSPI_CMD_BYTES(len) (QSPI_FRAME_HEADER_BYTES + 4 + (len) + QSPI_PAD_BYTES(4 + (len)))
+#define QSPI_PIXEL_HEADER_BYTES QSPI_CMD_BYTES(0)
+
+// SCLK targets. The frame engine takes two PIO cycles per SCLK period and the
+// read program four; dividers are rounded so SCLK never exceeds the target.
+// The default is what the fixed divider of 2 gave at 150 MHz.
+#define QSPI_SCLK_HZ_DEFAULT 37500000
+#define QSPI_READ_SCLK_HZ    5000000
+#define QSPI_OP_READ         0x03
+// Panel data out during register reads
+#define PIN_MISO    PIN_DIO1
+
 #define WAIT_TIME() for(int i=0;i<2;i++) __asm__ volatile("nop");
 
 typedef struct pio_qspi {
     PIO pio;
     uint8_t sm;
     uint8_t sm_4wire;
-    uint8_t sm_1wire;
+    uint8_t sm_1wire;           // register reads
     uint8_t pin_cs;
     uint8_t pin_sclk;
     uint8_t pin_dio0;
@@ -62,13 +87,17 @@ typedef struct pio_qspi {
 extern pio_qspi_t qspi;
 
 void QSPI_GPIO_Init(pio_qspi_t qspi);
-void QSPI_Select(pio_qspi_t qspi);
-void QSPI_Deselect(pio_qspi_t qspi);
+void QSPI_Wait_Idle(pio_qspi_t qspi);
 void QSPI_PIO_Init(pio_qspi_t qspi);
-void QSPI_1Wrie_Mode(pio_qspi_t *qspi);
 void QSPI_4Wrie_Mode(pio_qspi_t *qspi);
-void QSPI_DATA_Write(pio_qspi_t qspi, uint32_t val);
-void QSPI_REGISTER_Write(pio_qspi_t qspi, uint32_t addr);
-void QSPI_Pixel_Write(pio_qspi_t qspi, uint32_t addr);
+uint32_t QSPI_Set_Clock(pio_qspi_t qspi, uint32_t hz);
+uint32_t QSPI_Get_Clock(void);
+void QSPI_Update_Clock(pio_qspi_t qspi);
+void QSPI_Register_Read(pio_qspi_t qspi, uint8_t cmd, uint8_t *data, size_t len);
+size_t QSPI_Build_Header(uint8_t *buf, uint32_t single_bytes, uint32_t quad_bytes);
+size_t QSPI_Build_Command(uint8_t *buf, uint8_t cmd, const uint8_t *data, size_t len);
+size_t QSPI_Build_Pixel_Header(uint8_t *buf, uint8_t cmd, uint32_t bytes);
+void QSPI_Command_Write(pio_qspi_t qspi, uint8_t cmd, const uint8_t *data, size_t len);
+void QSPI_Pixel_Write(pio_qspi_t qspi, uint8_t cmd, uint32_t bytes);
 
 #endif // _QSPI_PIO_H
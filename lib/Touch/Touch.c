@@ -28,51 +28,139 @@
 ******************************************************************************/
 #include "Touch.h"
 #include "DEV_Config.h"
+#include "idle.h"
+#include "hardware/sync.h"
 
 Touch_Struct TOUCH;
 uint8_t read_touchpad_cmd[11] = {0xb5, 0xab, 0xa5, 0x5a, 0x0, 0x0, 0x0, 0x0e, 0x0, 0x0, 0x0};
 uint8_t read_touchpad_data[32] = {0};
 
-/******************************************************************************
-function :	Send n byte of data to the specified register of TOUCH
-parameter:
-******************************************************************************/
-static void Touch_I2C_Write_nByte(uint8_t buf[], uint8_t len) {
-    i2c_write_blocking(TOUCH_I2C_PORT, TOUCH_I2C_ADDR, buf, len, true);
-}
+touch_ring_t TOUCH_RING;
+
+// Matches HORIZONTAL in LCD_3IN49.h; the controller reports in landscape
+#define TOUCH_SCAN_HORIZONTAL 0
+static uint8_t touch_scan_dir = 1;
+
+// The touch GPIO interrupt and the I2C completion can run on different
+// cores (LVGL_ON_CORE1), so the read state below is guarded by touch_lock.
+// touch_busy owns touch_txn, read_touchpad_data and touch_irq_us from
+// submit to completion.
+static spin_lock_t *touch_lock;
+static i2c_txn_t touch_txn;
+static void (*touch_done_cb)(void);
+static bool touch_busy;
+static uint32_t touch_irq_us;   // edge time of the report being read
+static uint32_t touch_rearm_us; // edge seen while a read was pending
+static bool touch_rearm;
 
 /******************************************************************************
-function :	Read n byte of data from the specified register of TOUCH
+function :	Decode the report in read_touchpad_data into TOUCH
 parameter:
 ******************************************************************************/
-static uint8_t Touch_I2C_Read_nByte(uint8_t buf[], uint8_t len) {
-    i2c_read_blocking(TOUCH_I2C_PORT, TOUCH_I2C_ADDR, buf, len, false);
+static void Touch_Map(uint16_t pointX, uint16_t pointY, uint16_t *x, uint16_t *y) {
+    if(pointX > 640) pointX = 640;
+    if(pointY > 172) pointY = 172;
+    if(touch_scan_dir == TOUCH_SCAN_HORIZONTAL) {
+        *x = pointX;
+        *y = pointY;
+    } else {
+        *x = pointY;
+        *y = 640-pointX;
+    }
 }
 
-/******************************************************************************
-function :	Read the current status of TOUCH
-parameter:
-******************************************************************************/
-void Touch_Read_State(){
-    Touch_I2C_Write_nByte(read_touchpad_cmd,11);
-    Touch_I2C_Read_nByte(read_touchpad_data,32);
+static void Touch_Parse(void) {
     TOUCH.Finger_Num = read_touchpad_data[1]; 
     uint16_t pointX;
     uint16_t pointY;
     pointX = (((uint16_t)read_touchpad_data[2] & 0x0f) << 8) | (uint16_t)read_touchpad_data[3];
     pointY = (((uint16_t)read_touchpad_data[4] & 0x0f) << 8) | (uint16_t)read_touchpad_data[5];
-    if(pointX > 640) pointX = 640;
-    if(pointY > 172) pointY = 172;
-    TOUCH.Point1_x = pointY;
-    TOUCH.Point1_y = 640-pointX;
+    Touch_Map(pointX, pointY, &TOUCH.Point1_x, &TOUCH.Point1_y);
     if(TOUCH.Finger_Num > 1)
     {
         pointX = (((uint16_t)read_touchpad_data[8] & 0x0f) << 8) | (uint16_t)read_touchpad_data[9];
         pointY = (((uint16_t)read_touchpad_data[10] & 0x0f) << 8) | (uint16_t)read_touchpad_data[11];
-        if(pointX > 640) pointX = 640;
-        if(pointY > 172) pointY = 172;
-        TOUCH.Point2_x = pointY;
-        TOUCH.Point2_y = 640-pointX;
+        Touch_Map(pointX, pointY, &TOUCH.Point2_x, &TOUCH.Point2_y);
     }
 }
 
+// Called with touch_lock held
+static void Touch_Submit(uint32_t irq_us) {
+    touch_irq_us = irq_us;
+    touch_busy = i2c_dma_submit(TOUCH_I2C_PORT, &touch_txn);
+}
+
+static void Touch_Txn_Done(i2c_txn_t *txn) {
+    if (txn->status == I2C_TXN_DONE) {
+        Touch_Parse();
+        touch_sample_t sample = {
+            .t_us = touch_irq_us,
+            .x = TOUCH.Point1_x,
+            .y = TOUCH.Point1_y,
+            .fingers = TOUCH.Finger_Num,
+        };
+        touch_ring_push(&TOUCH_RING, &sample);
+        // The LVGL loop may be asleep on a core this interrupt isn't on
+        idle_kick();
+    }
+    if (touch_done_cb)
+        touch_done_cb();
+    // A report that arrived during this read has not been fetched yet
+    uint32_t save = spin_lock_blocking(touch_lock);
+    if (touch_rearm) {
+        touch_rearm = false;
+        Touch_Submit(touch_rearm_us);
+    } else {
+        touch_busy = false;
+    }
+    spin_unlock(touch_lock, save);
+}
+
+/******************************************************************************
+function :	Set up the asynchronous touch read
+parameter:
+Info:       Call once, before the touch interrupt is enabled.
+******************************************************************************/
+void Touch_Init(void) {
+    touch_lock = spin_lock_instance(spin_lock_claim_unused(true));
+    touch_txn.addr = TOUCH_I2C_ADDR;
+    touch_txn.wr = read_touchpad_cmd;
+    touch_txn.wr_len = sizeof(read_touchpad_cmd);
+    touch_txn.rd = read_touchpad_data;
+    touch_txn.rd_len = sizeof(read_touchpad_data);
+    touch_txn.cb = Touch_Txn_Done;
+}
+
+/******************************************************************************
+function :	Queue a touch report read on the DMA I2C engine
+parameter:
+    done :  called from the I2C interrupt once TOUCH is updated (may be NULL)
+Info:       Returns immediately; safe to call from the touch GPIO interrupt
+            on either core. Every completed read is also pushed into
+            TOUCH_RING stamped with the time of this call. If the previous
+            read is still on the bus one more read is queued behind it, so
+            no report is skipped.
+******************************************************************************/
+uint8_t Touch_Read_Async(void (*done)(void)) {
+    uint32_t now = time_us_32();
+    uint32_t save = spin_lock_blocking(touch_lock);
+    touch_done_cb = done;
+    if (touch_busy) {
+        if (!touch_rearm)
+            touch_rearm_us = now;
+        touch_rearm = true;
+    } else {
+        Touch_Submit(now);
+    }
+    spin_unlock(touch_lock, save);
+    return 1;
+}
+
+/******************************************************************************
+function :	Map touch reports to the display orientation
+parameter:
+    Scan_dir :  HORIZONTAL or VERTICAL, as passed to LCD_3IN49_SetAttributes
+******************************************************************************/
+void Touch_Set_Scan_Dir(uint8_t Scan_dir) {
+    touch_scan_dir = Scan_dir;
+}
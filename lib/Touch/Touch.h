@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include "hardware/i2c.h"
 #include "pico/time.h"
+#include "touch_ring.h"
 
 #define TOUCH_I2C_ADDR  0x3B
 
@@ -44,6 +45,9 @@ typedef struct{
 } Touch_Struct;
 
 extern Touch_Struct TOUCH;
+extern touch_ring_t TOUCH_RING;
 
-void Touch_Read_State();
+void Touch_Init(void);
+void Touch_Set_Scan_Dir(uint8_t Scan_dir);
+uint8_t Touch_Read_Async(void (*done)(void));
 #endif // !_TOUCH_H_
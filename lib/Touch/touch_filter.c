@@ -0,0 +1,109 @@
+#include "touch_filter.h"
+#include <string.h>
+
+#define POS_SHIFT 4
+#define US_PER_S 1000000
+// 1e6 / (2 * pi): time constant in us of a 1 Hz first-order low-pass
+#define TAU_1HZ_US 159155u
+#define MIN_DT_US 1000u
+#define MAX_DT_US 100000u
+
+void touch_filter_default_config(touch_filter_config_t *cfg) {
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->mode = TOUCH_FILTER_ONE_EURO;
+  // Tuned on tools/touch_replay. Speed is in px/s, so beta is far above
+  // the 0.007 often quoted for normalised coordinates; a longer prediction
+  // overshoots the start and end of every move.
+  cfg->predict_us = 2000;
+  cfg->min_cutoff_q8 = 1 << 8;
+  cfg->beta_q16 = 13107; // 0.2
+  cfg->d_cutoff_q8 = 1 << 8;
+  cfg->alpha_q16 = 32768; // 0.5
+  cfg->beta_ab_q16 = 6554; // 0.1
+}
+
+void touch_filter_init(touch_filter_t *f, const touch_filter_config_t *cfg) {
+  memset(f, 0, sizeof(*f));
+  f->cfg = *cfg;
+}
+
+void touch_filter_reset(touch_filter_t *f) { f->primed = false; }
+
+// Smoothing factor of a first-order low-pass with cutoff fc sampled at dt
+static int32_t lowpass_alpha(uint32_t fc_q8, uint32_t dt_us) {
+  if (fc_q8 == 0)
+    fc_q8 = 1;
+  uint32_t tau_us = (TAU_1HZ_US << 8) / fc_q8;
+  return (int32_t)(((uint64_t)dt_us << 16) / (dt_us + tau_us));
+}
+
+static inline int32_t lerp_q16(int32_t from, int32_t to, int32_t a_q16) {
+  return from + (int32_t)(((int64_t)(to - from) * a_q16) >> 16);
+}
+
+static void one_euro(const touch_filter_config_t *c, touch_filter_axis_t *a,
+                     int32_t x, uint32_t dt_us) {
+  int32_t dx = (int32_t)(((int64_t)(x - a->x) * US_PER_S) / (int32_t)dt_us);
+  a->dx = lerp_q16(a->dx, dx, lowpass_alpha(c->d_cutoff_q8, dt_us));
+
+  uint32_t speed = (uint32_t)(a->dx < 0 ? -a->dx : a->dx);
+  // beta (Q16) * speed (Q4) -> cutoff (Q8)
+  uint32_t fc_q8 = c->min_cutoff_q8 +
+                   (uint32_t)(((uint64_t)c->beta_q16 * speed) >> (16 + POS_SHIFT - 8));
+  a->x = lerp_q16(a->x, x, lowpass_alpha(fc_q8, dt_us));
+}
+
+static void alpha_beta(const touch_filter_config_t *c, touch_filter_axis_t *a,
+                       int32_t x, uint32_t dt_us) {
+  int32_t xp = a->x + (int32_t)(((int64_t)a->dx * dt_us) / US_PER_S);
+  int32_t r = x - xp;
+  a->x = xp + (int32_t)(((int64_t)r * c->alpha_q16) >> 16);
+  a->dx += (int32_t)(((int64_t)r * c->beta_ab_q16 * US_PER_S / dt_us) >> 16);
+}
+
+static uint16_t output(const touch_filter_config_t *c,
+                       const touch_filter_axis_t *a) {
+  int32_t x = a->x + (int32_t)(((int64_t)a->dx * c->predict_us) / US_PER_S);
+  x = (x + (1 << (POS_SHIFT - 1))) >> POS_SHIFT;
+  if (x < 0)
+    x = 0;
+  if (x > 0xffff)
+    x = 0xffff;
+  return (uint16_t)x;
+}
+
+void touch_filter_update(touch_filter_t *f, uint16_t x, uint16_t y,
+                         uint32_t t_us, uint16_t *out_x, uint16_t *out_y) {
+  int32_t in[2] = {(int32_t)x << POS_SHIFT, (int32_t)y << POS_SHIFT};
+
+  if (f->cfg.mode == TOUCH_FILTER_NONE) {
+    *out_x = x;
+    *out_y = y;
+    return;
+  }
+
+  if (!f->primed) {
+    for (int i = 0; i < 2; i++) {
+      f->axis[i].x = in[i];
+      f->axis[i].dx = 0;
+    }
+    f->t_us = t_us;
+    f->primed = true;
+  } else {
+    uint32_t dt = t_us - f->t_us;
+    f->t_us = t_us;
+    if (dt < MIN_DT_US)
+      dt = MIN_DT_US;
+    if (dt > MAX_DT_US)
+      dt = MAX_DT_US;
+    for (int i = 0; i < 2; i++) {
+      if (f->cfg.mode == TOUCH_FILTER_ALPHA_BETA)
+        alpha_beta(&f->cfg, &f->axis[i], in[i], dt);
+      else
+        one_euro(&f->cfg, &f->axis[i], in[i], dt);
+    }
+  }
+
+  *out_x = output(&f->cfg, &f->axis[0]);
+  *out_y = output(&f->cfg, &f->axis[1]);
+}
@@ -0,0 +1,61 @@
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Touch coordinate filter with short-horizon prediction, all integer math.
+//
+// TOUCH_FILTER_ONE_EURO: adaptive low-pass whose cutoff rises with speed, so
+// a resting finger is smoothed hard while a fast drag is barely delayed.
+// TOUCH_FILTER_ALPHA_BETA: fixed-gain position/velocity tracker, cheaper and
+// more predictable, but lags more at low speed.
+//
+// Both keep a velocity estimate that is used to extrapolate the output
+// predict_us ahead of the sample time, which hides part of the latency of
+// the touch -> LVGL -> panel path. Positions are tracked in 1/16 px.
+// Hardware independent so recorded traces can be replayed on the host.
+
+typedef enum {
+  TOUCH_FILTER_NONE = 0,
+  TOUCH_FILTER_ONE_EURO,
+  TOUCH_FILTER_ALPHA_BETA,
+} touch_filter_mode_t;
+
+typedef struct {
+  touch_filter_mode_t mode;
+  uint32_t predict_us;     // extrapolation horizon, 0 disables prediction
+  // 1-euro
+  uint32_t min_cutoff_q8;  // Hz, Q8
+  uint32_t beta_q16;       // cutoff slope, Hz per px/s, Q16
+  uint32_t d_cutoff_q8;    // derivative cutoff, Hz, Q8
+  // alpha-beta
+  uint32_t alpha_q16;
+  uint32_t beta_ab_q16;
+} touch_filter_config_t;
+
+typedef struct {
+  int32_t x;  // filtered position, 1/16 px
+  int32_t dx; // filtered velocity, 1/16 px per second
+} touch_filter_axis_t;
+
+typedef struct {
+  touch_filter_config_t cfg;
+  touch_filter_axis_t axis[2];
+  uint32_t t_us;
+  bool primed;
+} touch_filter_t;
+
+// 1-euro, min cutoff 1 Hz, beta 0.2, d cutoff 1 Hz, 2 ms prediction
+void touch_filter_default_config(touch_filter_config_t *cfg);
+void touch_filter_init(touch_filter_t *f, const touch_filter_config_t *cfg);
+
+// Forget the history; call on every new contact
+void touch_filter_reset(touch_filter_t *f);
+
+// Feeds one raw sample taken at t_us and returns the filtered, predicted
+// position in whole pixels (never negative).
+void touch_filter_update(touch_filter_t *f, uint16_t x, uint16_t y,
+                         uint32_t t_us, uint16_t *out_x, uint16_t *out_y);
+
+#endif
@@ -0,0 +1,48 @@
+#include "touch_ring.h"
+#include <string.h>
+
+#define TOUCH_RING_MASK (TOUCH_RING_SIZE - 1)
+
+void touch_ring_init(touch_ring_t *r) { memset(r, 0, sizeof(*r)); }
+
+void touch_ring_push(touch_ring_t *r, const touch_sample_t *s) {
+  uint32_t head = r->head;
+  r->buf[head & TOUCH_RING_MASK] = *s;
+  r->buf[head & TOUCH_RING_MASK].seq = head;
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  r->head = head + 1;
+}
+
+void touch_reader_init(touch_reader_t *rd, const touch_ring_t *r) {
+  rd->tail = r->head;
+  rd->lost = 0;
+}
+
+uint32_t touch_ring_pending(const touch_ring_t *r, const touch_reader_t *rd) {
+  uint32_t n = r->head - rd->tail;
+  return n >= TOUCH_RING_SIZE ? TOUCH_RING_SIZE - 1 : n;
+}
+
+bool touch_ring_pop(const touch_ring_t *r, touch_reader_t *rd,
+                    touch_sample_t *out) {
+  for (;;) {
+    uint32_t head = r->head;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (head == rd->tail)
+      return false;
+    // The slot at head - TOUCH_RING_SIZE is the next one to be overwritten,
+    // so a reader can trail by at most TOUCH_RING_SIZE - 1 samples
+    if (head - rd->tail >= TOUCH_RING_SIZE) {
+      uint32_t skip = head - rd->tail - (TOUCH_RING_SIZE - 1);
+      rd->lost += skip;
+      rd->tail += skip;
+    }
+    *out = r->buf[rd->tail & TOUCH_RING_MASK];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    // Retry if the writer reached this slot while it was being copied
+    if (r->head - rd->tail < TOUCH_RING_SIZE) {
+      rd->tail++;
+      return true;
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#ifndef TOUCH_RING_H
+#define TOUCH_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Timestamped touch sample ring. The touch driver pushes one sample per
+// controller report from the I2C completion interrupt; any number of readers
+// (LVGL indev, trackpad, gesture logic) consume it independently through
+// their own touch_reader_t, so every consumer sees every sample. A reader
+// that falls TOUCH_RING_SIZE - 1 samples behind skips ahead and the gap is
+// counted in touch_reader_t.lost.
+//
+// Single writer; no locking. Hardware independent.
+
+#define TOUCH_RING_SIZE 64 // power of two
+
+typedef struct {
+  uint32_t t_us;   // controller interrupt edge (contact report time)
+  uint32_t seq;    // running sample number, detects gaps
+  uint16_t x;
+  uint16_t y;
+  uint8_t fingers; // 0 == lifted
+} touch_sample_t;
+
+typedef struct {
+  touch_sample_t buf[TOUCH_RING_SIZE];
+  volatile uint32_t head; // samples written since init
+} touch_ring_t;
+
+typedef struct {
+  uint32_t tail;
+  uint32_t lost;
+} touch_reader_t;
+
+void touch_ring_init(touch_ring_t *r);
+void touch_ring_push(touch_ring_t *r, const touch_sample_t *s);
+
+// Attaches a reader at the current head (only new samples are seen)
+void touch_reader_init(touch_reader_t *rd, const touch_ring_t *r);
+bool touch_ring_pop(const touch_ring_t *r, touch_reader_t *rd,
+                    touch_sample_t *out);
+uint32_t touch_ring_pending(const touch_ring_t *r, const touch_reader_t *rd);
+
+#endif
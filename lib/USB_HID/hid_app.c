@@ -1,5 +1,9 @@
 #include "hid_app.h"
+#include "hid_cmd.h"
+#include "boot_prof.h"
 #include "bsp/board_api.h"
+#include "idle.h"
+#include "sys_clock.h"
 #include "tusb.h"
 #include "usb_descriptors.h"
 #include <stdlib.h>
@@ -18,11 +22,13 @@ void hid_set_mouse_velocity(int8_t x, int8_t y) {
   m_mouse_state.x = x;
   m_mouse_state.y = y;
   m_mouse_state.dirty = true;
+  idle_kick();
 }
 
 void hid_mouse_button(uint8_t buttons) {
   m_mouse_state.buttons = buttons;
   m_mouse_state.dirty = true;
+  idle_kick();
 }
 
 // Immediate click - sends report right away (blocking)
@@ -52,6 +58,9 @@ void hid_mouse_click(uint8_t buttons) {
 static key_event_t m_macro_queue[MACRO_MAX_STEPS];
 static uint8_t m_macro_head = 0;
 static uint8_t m_macro_tail = 0;
+static volatile bool m_macro_cancel = false;
+// 0: idle, 1: key pressed, 2: waiting out a delay
+static uint8_t m_kbd_state = 0;
 
 // Helper macros for defining macro steps more cleanly
 #define KEY(k) {0, k, 0}
@@ -97,6 +106,7 @@ static void macro_queue_add(uint8_t modifier, uint8_t key_code) {
     m_macro_queue[m_macro_head].modifier = modifier;
     m_macro_queue[m_macro_head].key_code = key_code;
     m_macro_head = next;
+    idle_kick();
   }
 }
 
@@ -373,13 +383,27 @@ void hid_run_macro_by_index(uint8_t index) {
   }
 }
 
+// Queue a single key combination (e.g. GUI+L) without defining a macro
+void hid_send_key_combo(uint8_t modifier, uint8_t key_code) {
+  macro_queue_add(modifier, key_code);
+}
+
+// Drop everything still queued; hid_app_task() releases any held key
+void hid_cancel_macro(void) {
+  m_macro_cancel = true;
+  idle_kick();
+}
+
 //--------------------------------------------------------------------+
 // Helpers
 //--------------------------------------------------------------------+
 bool send_key_press(uint8_t modifier, uint8_t key_code) {
   uint8_t keycode[6] = {0};
   keycode[0] = key_code;
-  return tud_hid_keyboard_report(REPORT_ID_KEYBOARD, modifier, keycode);
+  if (!tud_hid_keyboard_report(REPORT_ID_KEYBOARD, modifier, keycode))
+    return false;
+  boot_mark(BOOT_FIRST_KEY);
+  return true;
 }
 
 bool send_key_release(void) {
@@ -389,39 +413,71 @@ bool send_key_release(void) {
 //--------------------------------------------------------------------+
 // Task
 //--------------------------------------------------------------------+
+// Builds the macro table up front; call it before another core reads macro
+// labels, since the lazy path is not safe across cores
+void hid_app_init(void) { initialize_macros(); }
+
+// Whether the 10 ms poll has anything to do: a key down or queued, a delay
+// running, or the mouse moving
+static bool hid_app_busy(void) {
+  return m_kbd_state != 0 || m_macro_head != m_macro_tail || m_macro_cancel ||
+         m_mouse_state.dirty || m_mouse_state.x != 0 || m_mouse_state.y != 0;
+}
+
 void hid_app_task(void) {
   initialize_macros(); // Ensure macros are initialized
 
+  // Requests from the UI, whichever core it runs on
+  hid_cmd_task();
+
   // Poll every 10ms for Mouse/Macro
   const uint32_t interval_ms = 10;
   static uint32_t start_ms = 0;
-
-  if (board_millis() - start_ms < interval_ms)
+  uint32_t now_ms = board_millis();
+  bool due = now_ms - start_ms >= interval_ms;
+
+  // Paced from the last poll, without catching up on those the loop slept
+  // through with nothing to send
+  if (due)
+    start_ms = now_ms - start_ms < 2 * interval_ms ? start_ms + interval_ms
+                                                   : now_ms;
+  // Only wake for the next poll while there is something to poll for; ms
+  // and us since boot wrap together, so this is the exact ms boundary
+  if (hid_app_busy()) {
+    sys_clock_boost(); // keys, macros and mouse motion at full clock
+    idle_wake_at((start_ms + interval_ms) * 1000u);
+  }
+  if (!due)
     return;
-  start_ms += interval_ms;
 
   if (!tud_hid_ready())
     return;
 
   // 1. Handle Macros (Keyboard)
-  // State 0: Idle, State 1: Pressing, State 2: Waiting for delay
-  static uint8_t kbd_state = 0;
   static key_event_t current_key;
   static uint32_t delay_start_ms = 0;
 
-  if (kbd_state == 1) { // Key is currently pressed
+  if (m_macro_cancel) {
+    m_macro_cancel = false;
+    m_macro_tail = m_macro_head;
+    if (m_kbd_state == 1)
+      send_key_release();
+    m_kbd_state = 0;
+  }
+
+  if (m_kbd_state == 1) { // Key is currently pressed
     send_key_release(); // Release it
     if (current_key.delay_ms > 0) {
-      kbd_state = 2; // Delay state
+      m_kbd_state = 2; // Delay state
       delay_start_ms = board_millis();
     } else {
-      kbd_state = 0; // Back to idle
+      m_kbd_state = 0; // Back to idle
     }
-  } else if (kbd_state == 2) { // Delaying
+  } else if (m_kbd_state == 2) { // Delaying
     if (board_millis() - delay_start_ms >= current_key.delay_ms) {
-      kbd_state = 0; // Delay done, back to idle
+      m_kbd_state = 0; // Delay done, back to idle
     }
-  } else if (kbd_state == 0) {
+  } else if (m_kbd_state == 0) {
     if (m_macro_head != m_macro_tail) {
       // Get next key
       current_key = m_macro_queue[m_macro_tail];
@@ -429,12 +485,12 @@ void hid_app_task(void) {
 
       if (current_key.key_code == 0 && current_key.modifier == 0 && current_key.delay_ms > 0) {
         // This is a delay event - no key press, just delay
-        kbd_state = 2;
+        m_kbd_state = 2;
         delay_start_ms = board_millis();
       } else {
         // Normal key press
         send_key_press(current_key.modifier, current_key.key_code);
-        kbd_state = 1; // Mark as pressed
+        m_kbd_state = 1; // Mark as pressed
       }
     }
   }
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+void hid_app_init(void);
 void hid_app_task(void);
 
 // Keyboard API
@@ -29,6 +30,8 @@ uint8_t hid_get_macro_count(void);
 const char *hid_get_macro_label(uint8_t index);
 const char *hid_get_macro_comment(uint8_t index);
 void hid_run_macro_by_index(uint8_t index);
+void hid_send_key_combo(uint8_t modifier, uint8_t key_code);
+void hid_cancel_macro(void);
 
 // Helper functions for dynamic macro creation
 macro_definition_t* create_macro(const char* label, const char* comment);
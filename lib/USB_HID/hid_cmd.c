@@ -0,0 +1,65 @@
+#include "hid_cmd.h"
+#include "hid_app.h"
+#include "idle.h"
+#include "spsc_queue.h"
+
+#define HID_CMD_QUEUE_SIZE 16 // power of two
+
+static hid_cmd_t m_cmd_storage[HID_CMD_QUEUE_SIZE];
+static spsc_queue_t m_cmd_queue = SPSC_QUEUE_INIT(m_cmd_storage);
+
+static bool hid_post(hid_cmd_type_t type, uint8_t a, uint8_t b) {
+  hid_cmd_t cmd = {.type = type, .a = a, .b = b};
+
+  if (!spsc_queue_push(&m_cmd_queue, &cmd))
+    return false;
+  // hid_app_task() may be on the other core, or already done this pass
+  idle_kick();
+  return true;
+}
+
+bool hid_post_macro(uint8_t index) {
+  return hid_post(HID_CMD_RUN_MACRO, index, 0);
+}
+
+bool hid_post_mouse_click(uint8_t buttons) {
+  return hid_post(HID_CMD_MOUSE_CLICK, buttons, 0);
+}
+
+bool hid_post_mouse_velocity(int8_t x, int8_t y) {
+  return hid_post(HID_CMD_MOUSE_VELOCITY, (uint8_t)x, (uint8_t)y);
+}
+
+bool hid_post_key_combo(uint8_t modifier, uint8_t key_code) {
+  return hid_post(HID_CMD_KEY_COMBO, modifier, key_code);
+}
+
+bool hid_post_cancel_macro(void) {
+  return hid_post(HID_CMD_CANCEL_MACRO, 0, 0);
+}
+
+void hid_cmd_task(void) {
+  hid_cmd_t cmd;
+
+  while (spsc_queue_pop(&m_cmd_queue, &cmd)) {
+    switch (cmd.type) {
+    case HID_CMD_RUN_MACRO:
+      hid_run_macro_by_index(cmd.a);
+      break;
+    case HID_CMD_MOUSE_CLICK:
+      hid_mouse_click(cmd.a);
+      break;
+    case HID_CMD_MOUSE_VELOCITY:
+      hid_set_mouse_velocity((int8_t)cmd.a, (int8_t)cmd.b);
+      break;
+    case HID_CMD_KEY_COMBO:
+      hid_send_key_combo(cmd.a, cmd.b);
+      break;
+    case HID_CMD_CANCEL_MACRO:
+      hid_cancel_macro();
+      break;
+    }
+  }
+}
+
+uint32_t hid_cmd_dropped(void) { return m_cmd_queue.dropped; }
@@ -0,0 +1,36 @@
+#ifndef HID_CMD_H
+#define HID_CMD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// HID requests from the UI. Widgets post here instead of calling hid_app
+// directly, so every HID call runs on the core that owns TinyUSB whichever
+// core LVGL is on; hid_app_task() drains the queue. One producer: the LVGL
+// core. A full queue drops the request and returns false.
+
+typedef enum {
+  HID_CMD_RUN_MACRO = 0, // a = macro index
+  HID_CMD_MOUSE_CLICK,   // a = buttons
+  HID_CMD_MOUSE_VELOCITY,// a, b = x, y (int8_t)
+  HID_CMD_KEY_COMBO,     // a = modifier, b = key code
+  HID_CMD_CANCEL_MACRO,
+} hid_cmd_type_t;
+
+typedef struct {
+  uint8_t type;
+  uint8_t a;
+  uint8_t b;
+} hid_cmd_t;
+
+bool hid_post_macro(uint8_t index);
+bool hid_post_mouse_click(uint8_t buttons);
+bool hid_post_mouse_velocity(int8_t x, int8_t y);
+bool hid_post_key_combo(uint8_t modifier, uint8_t key_code);
+bool hid_post_cancel_macro(void);
+
+// Consumer side, from hid_app_task()
+void hid_cmd_task(void);
+uint32_t hid_cmd_dropped(void);
+
+#endif
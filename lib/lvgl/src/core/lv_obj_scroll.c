@@ -624,6 +624,11 @@ static void scroll_by_raw(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
     lv_obj_move_children_by(obj, x, y, true);
     lv_res_t res = lv_event_send(obj, LV_EVENT_SCROLL, NULL);
     if(res != LV_RES_OK) return;
+
+    /*Let the display shift the content in hardware if it can*/
+    lv_disp_t * disp = lv_obj_get_disp(obj);
+    if(x == 0 && disp->driver->scroll_cb && disp->driver->scroll_cb(disp->driver, obj, y)) return;
+
     lv_obj_invalidate(obj);
 }
 
@@ -135,6 +135,10 @@ typedef struct _lv_disp_drv_t {
     void (*gpu_fill_cb)(struct _lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
                         const lv_area_t * fill_area, lv_color_t color);
 
+    /** OPTIONAL: Called when `obj` was scrolled vertically by `dy`, instead of invalidating it.
+     * Return true if the display moved the content itself and invalidated only what it needs redrawn.*/
+    bool (*scroll_cb)(struct _lv_disp_drv_t * disp_drv, struct _lv_obj_t * obj, lv_coord_t dy);
+
     /** On CHROMA_KEYED images this color will be transparent.
      * `LV_COLOR_CHROMA_KEY` by default. (lv_conf.h)*/
     lv_color_t color_chroma_key;
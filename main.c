@@ -1,12 +1,26 @@
 #include "LCD_test.h" //example
+#include "boot_prof.h"
 #include "bsp/board_api.h"
 #include "hid_app.h"
+#include "idle.h"
+#include "battery.h"
+#include "motion.h"
+#include "sys_clock.h"
 #include "tusb.h"
+#include "ui_bridge.h"
+
+// Keeps enumeration going through the bring-up waits
+static void boot_usb_service(void) { tud_task(); }
+
+void tud_mount_cb(void) { boot_mark(BOOT_USB_MOUNTED); }
 
 int main(void) {
+  boot_mark(BOOT_MAIN);
   // TinyUSB Init
   board_init();
   tud_init(BOARD_TUD_RHPORT);
+  boot_set_service(boot_usb_service);
+  boot_mark(BOOT_USB_INIT);
 
   // Initialize LCD (Original Code)
   // Note: LCD_3IN49_LVGL_Test probably has its own loop, we might need to
@@ -28,11 +42,24 @@ int main(void) {
 
   // Initialize LCD and LVGL
   LCD_3IN49_LVGL_Init();
+  boot_set_service(NULL);
 
   while (1) {
     tud_task(); // tinyusb device task
+    boot_prof_task(); // boot timeline, printed as phases complete
     hid_app_task();
+    motion_task(); // IMU FIFO -> attitude fusion
+    battery_task(); // ADC ring -> voltage and charge, twice a second
+    ui_bridge_task(); // USB state -> UI
+#if !LVGL_ON_CORE1
     LCD_3IN49_LVGL_Task(); // Handle LVGL tasks
+#endif
+    sys_clock_task(); // clk_sys down after a quiet spell, up on demand
+    idle_report_task(); // duty cycle and wakes per core, every 10 s
+    // TinyUSB events queued outside its interrupt, e.g. deferred by a report
+    if (tud_task_event_ready())
+      idle_kick();
+    idle_sleep(); // until a task's deadline, an interrupt or a kick
   }
 
   return 0;
@@ -0,0 +1,160 @@
+// Host check of the battery estimator (lib/Battery/battery_est.c) against
+// synthetic charge curves. Each curve is fed to battery_est_update() the way
+// battery_task() does: one block of BLOCK_SAMPLES 12-bit ADC readings per
+// BATTERY_PERIOD_US pass, with noise at the battery and the divider and
+// quantisation of the real input. Per curve it checks that the shown
+// percent, once the IIR has settled from the first block,
+//   - never moves against the curve (the 1% deadband holds through noise),
+//   - stays within PCT_TOL of the true charge,
+//   - changes no more often than the true charge crosses a whole percent,
+// and it checks the OCV table's ends and interpolation and the snapshot
+// round trip. The exit status is non-zero if a check fails.
+//
+//   cmake -S tools/battery_est -B build-battery && cmake --build build-battery
+//   ./build-battery/battery_est
+
+#include "battery_est.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BLOCK_SAMPLES 500 // 1 kS/s over a 500 ms pass
+#define SETTLE_BLOCKS 40 // five IIR time constants
+#define PCT_TOL 2
+
+typedef struct {
+  const char *name;
+  uint16_t from_permille;
+  uint16_t to_permille;
+  uint32_t blocks;
+  uint16_t noise_mv; // uniform, +-, per sample at the battery
+} curve_t;
+
+static const curve_t m_curves[] = {
+    {"discharge 1 h", 1000, 0, 7200, 40},
+    {"discharge 5 min", 1000, 0, 600, 40},
+    {"charge 30 min", 0, 1000, 3600, 40},
+    {"rest 45%", 450, 450, 600, 60},
+    {"rest 90%, quiet", 900, 900, 600, 2},
+};
+
+#define CURVES (sizeof(m_curves) / sizeof(m_curves[0]))
+
+static int m_failed;
+static uint32_t m_rng = 0x9e3779b9;
+
+static uint32_t rnd(void) {
+  m_rng ^= m_rng << 13;
+  m_rng ^= m_rng >> 17;
+  m_rng ^= m_rng << 5;
+  return m_rng;
+}
+
+static void check(int ok, const char *what, const char *curve, long got,
+                  long want) {
+  if (ok)
+    return;
+  printf("  FAIL %s: %s, got %ld, want %ld\n", curve, what, got, want);
+  m_failed++;
+}
+
+// Resting voltage for a charge, by bisection on the estimator's own table
+static uint16_t mv_for(uint16_t permille) {
+  uint16_t lo = 3270, hi = 4200;
+
+  while (lo < hi) {
+    uint16_t mid = (lo + hi) / 2;
+    if (battery_est_soc(mid) < permille)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static uint32_t adc_block(uint16_t mv, uint16_t noise_mv) {
+  uint32_t sum = 0;
+
+  for (int i = 0; i < BLOCK_SAMPLES; i++) {
+    int32_t v = mv;
+    if (noise_mv)
+      v += (int32_t)(rnd() % (2u * noise_mv + 1)) - noise_mv;
+    int32_t raw = v * BATTERY_ADC_COUNTS / BATTERY_ADC_FULL_SCALE_MV;
+    sum += raw < 0 ? 0 : raw > BATTERY_ADC_COUNTS - 1 ? BATTERY_ADC_COUNTS - 1
+                                                      : raw;
+  }
+  return sum;
+}
+
+static void run(const curve_t *c) {
+  battery_est_t e;
+  int dir = c->to_permille > c->from_permille ? 1
+            : c->to_permille < c->from_permille ? -1
+                                                : 0;
+  int last = 0, backward = 0, changes = 0, err_max = 0;
+
+  battery_est_init(&e);
+  for (uint32_t b = 0; b < c->blocks; b++) {
+    int32_t span = (int32_t)c->to_permille - c->from_permille;
+    uint16_t truth = c->from_permille + span * (int32_t)b / (int32_t)c->blocks;
+    battery_est_update(&e, adc_block(mv_for(truth), c->noise_mv),
+                       BLOCK_SAMPLES);
+    battery_est_publish(&e, b * 500000u);
+
+    int pct = e.percent;
+    if (b < SETTLE_BLOCKS) {
+      last = pct;
+      continue;
+    }
+    if (pct != last) {
+      changes++;
+      if (dir == 0 || (pct - last) * dir < 0)
+        backward++;
+    }
+    last = pct;
+    int err = abs(pct - (truth + 5) / 10);
+    if (err > err_max)
+      err_max = err;
+  }
+
+  int crossed = abs((int)c->to_permille - (int)c->from_permille) / 10;
+  printf("%-16s %5u blocks, +-%2u mV: %3d changes, %d backward, max error "
+         "%d%%, ends at %u%% (%u mV)\n",
+         c->name, c->blocks, c->noise_mv, changes, backward, err_max,
+         e.percent, battery_est_mv(&e));
+  check(backward == 0, "percent moved against the curve", c->name, backward,
+        0);
+  check(err_max <= PCT_TOL, "error after settling", c->name, err_max,
+        PCT_TOL);
+  check(changes <= crossed, "percent changes", c->name, changes, crossed);
+}
+
+int main(void) {
+  static const struct {
+    uint16_t mv;
+    uint16_t permille;
+  } table[] = {
+      {5000, 1000}, {4200, 1000}, {3840, 500}, {3845, 525},
+      {3270, 0},    {3000, 0},    {3440, 25},
+  };
+  battery_snapshot_t snap;
+
+  for (unsigned i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    check(battery_est_soc(table[i].mv) == table[i].permille, "table", "soc",
+          battery_est_soc(table[i].mv), table[i].permille);
+  check(!battery_est_get_snapshot(&snap), "snapshot before publish",
+        "snapshot", 1, 0);
+
+  for (unsigned i = 0; i < CURVES; i++)
+    run(&m_curves[i]);
+
+  // Holds the last curve's estimator
+  long samples = (long)m_curves[CURVES - 1].blocks * BLOCK_SAMPLES;
+  check(battery_est_get_snapshot(&snap), "snapshot after publish", "snapshot",
+        0, 1);
+  check(snap.samples == samples, "snapshot samples", "snapshot", snap.samples,
+        samples);
+
+  printf(m_failed ? "%d checks failed\n" : "passed\n", m_failed);
+  return m_failed != 0;
+}
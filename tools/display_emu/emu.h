@@ -0,0 +1,69 @@
+#ifndef EMU_H
+#define EMU_H
+
+#include "pico/types.h"
+
+// Display emulator internals: the DMA and PIO models, the SH8601 panel on
+// the other end of the QSPI pins, and the counters they share.
+//
+// Everything runs synchronously on one thread. A DMA kick runs its whole
+// chain, every word it writes to a PIO FIFO is clocked out by the PIO
+// model before the next one, and the DMA interrupt is delivered when the
+// chain stops. Simulated time only advances with PIO cycles and sleeps, so
+// it measures the bus, not the host.
+
+// Bus traffic since the last emu_stats_reset
+typedef struct {
+  uint32_t fifo_words;   // words into a PIO TX FIFO
+  uint32_t dma_words;    // of those, written by DMA
+  uint32_t dma_blocks;   // channel runs (control blocks, blit rows)
+  uint32_t dma_irqs;     // DMA_IRQ_0 deliveries
+  uint32_t transactions; // CS low periods
+  uint32_t windows;      // RAMWR/RAMWRC frames
+  uint32_t cmd_bytes;    // bytes clocked on DIO0 alone
+  uint32_t pixel_bytes;  // bytes clocked on all four lanes
+  uint32_t errors;       // malformed frames, pixels outside the panel
+  uint64_t sclk_cycles;  // rising SCLK edges
+  uint64_t pio_cycles;   // state machine cycles, delays included
+  uint64_t bus_sys256;   // time those cycles took, 1/256 sys clocks
+} emu_stats_t;
+
+extern emu_stats_t emu_stats;
+void emu_stats_reset(void);
+
+// Prints the message and exits; for states the hardware would hang in
+void emu_fatal(const char *fmt, ...) __attribute__((noreturn, format(printf, 1, 2)));
+
+// Simulated time, in 1/256 system clock cycles
+void emu_time_advance(uint64_t sys256);
+uint64_t emu_time_sys256(void);
+
+// The drivers hand 32-bit bus addresses to the DMA, so every buffer it
+// touches must sit below 4 GB in the host process (see CMakeLists.txt)
+uint32_t emu_bus_addr(const volatile void *p);
+static inline void *emu_host_ptr(uint32_t addr) { return (void *)(uintptr_t)addr; }
+
+// DMA write path: registers, PIO FIFOs, or memory
+void emu_bus_write(uint32_t addr, uint32_t value, uint size);
+
+// PIO model
+bool emu_pio_is_txf(uint32_t addr);
+void emu_pio_txf_write(uint32_t addr, uint32_t value);
+
+// Panel model, fed the pin levels after every change
+#define EMU_PANEL_WIDTH 172
+#define EMU_PANEL_HEIGHT 640
+
+extern uint16_t emu_panel_fb[EMU_PANEL_WIDTH * EMU_PANEL_HEIGHT]; // RGB565
+// What the panel shows: memory read through the vertical scroll area
+void emu_panel_scanout(uint16_t *out);
+void emu_panel_pins_changed(void);
+// Register writes clocked faster than this arrive corrupted; 0 = no limit
+void emu_panel_set_max_sclk(uint32_t hz);
+// Likewise for pixels on the four lanes
+void emu_panel_set_max_quad_sclk(uint32_t hz);
+uint8_t emu_panel_brightness(void);
+
+int emu_png_write_rgb565(const char *path, const uint16_t *px, int w, int h);
+
+#endif
@@ -0,0 +1,262 @@
+#include "emu.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include <string.h>
+
+// DMA model. Register writes are decoded by offset within a channel, so
+// the four aliases and their trigger registers behave as on the RP2350:
+// writing a trigger starts the channel, writing zero to one is a null
+// trigger that only raises the interrupt of an IRQ_QUIET channel. A
+// channel runs its whole count at once (the PIO model keeps DREQ high),
+// then raises its interrupt unless quiet and triggers its chain_to.
+
+dma_hw_t emu_dma_hw __attribute__((aligned(0x1000)));
+
+enum { REG_READ, REG_WRITE, REG_COUNT, REG_CTRL };
+
+// Register role and trigger flag for the 16 words of a channel
+static const uint8_t m_reg_role[16] = {
+    REG_READ,  REG_WRITE, REG_COUNT, REG_CTRL,  // alias 0
+    REG_CTRL,  REG_READ,  REG_WRITE, REG_COUNT, // alias 1
+    REG_CTRL,  REG_COUNT, REG_READ,  REG_WRITE, // alias 2
+    REG_CTRL,  REG_WRITE, REG_COUNT, REG_READ,  // alias 3
+};
+static const uint16_t m_reg_trig = 1u << 3 | 1u << 7 | 1u << 11 | 1u << 15;
+
+typedef struct {
+  uint32_t read;
+  uint32_t write;
+  uint32_t reload; // TRANS_COUNT as last written
+  uint32_t ctrl;
+  bool claimed;
+} emu_dma_ch_t;
+
+static emu_dma_ch_t m_ch[NUM_DMA_CHANNELS];
+static uint32_t m_pending;
+static bool m_running;
+static bool m_delivering;
+static uint32_t m_int_acks; // INTS0 writes that cleared a raised bit
+
+static void dma_raise(uint ch) {
+  dma_hw->intr |= 1u << ch;
+  dma_hw->ints0 = dma_hw->intr & dma_hw->inte0;
+}
+
+static void dma_trigger(uint ch, uint32_t value) {
+  if (value == 0) {
+    if (m_ch[ch].ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS)
+      dma_raise(ch);
+    return;
+  }
+  if (m_ch[ch].ctrl & DMA_CH0_CTRL_TRIG_EN_BITS)
+    m_pending |= 1u << ch;
+}
+
+static void dma_reg_write(uint ch, uint reg, uint32_t value) {
+  uint32_t *mirror = (uint32_t *)&dma_hw->ch[ch];
+
+  mirror[reg] = value;
+  switch (m_reg_role[reg]) {
+  case REG_READ:
+    m_ch[ch].read = value;
+    break;
+  case REG_WRITE:
+    m_ch[ch].write = value;
+    break;
+  case REG_COUNT:
+    // MODE lives in the top bits on the RP2350; only mode 0 is modelled
+    if (value >> 28)
+      emu_fatal("DMA channel %u: TRANS_COUNT mode %u", ch, value >> 28);
+    m_ch[ch].reload = value;
+    break;
+  case REG_CTRL:
+    m_ch[ch].ctrl = value;
+    break;
+  }
+  if (m_reg_trig & (1u << reg))
+    dma_trigger(ch, value);
+}
+
+static uint32_t dma_step_addr(uint32_t addr, uint size, bool incr,
+                              uint ring_bits) {
+  if (!incr)
+    return addr;
+  if (!ring_bits)
+    return addr + size;
+  uint32_t mask = (1u << ring_bits) - 1;
+  return (addr & ~mask) | ((addr + size) & mask);
+}
+
+static void dma_transfer(uint ch) {
+  emu_dma_ch_t *c = &m_ch[ch];
+  uint32_t ctrl = c->ctrl;
+  uint size = 1u << ((ctrl >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB) & 3);
+  uint ring = (ctrl >> DMA_CH0_CTRL_TRIG_RING_SIZE_LSB) & 0xf;
+  bool ring_write = ctrl & DMA_CH0_CTRL_TRIG_RING_SEL_BITS;
+  bool incr_read = ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_BITS;
+  bool incr_write = ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS;
+  uint chain = (ctrl >> DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB) & 0xf;
+
+  emu_stats.dma_blocks++;
+  for (uint32_t n = c->reload; n; n--) {
+    uint32_t v = 0;
+    memcpy(&v, emu_host_ptr(c->read), size);
+    if (ctrl & DMA_CH0_CTRL_TRIG_BSWAP_BITS) {
+      if (size == 4)
+        v = __builtin_bswap32(v);
+      else if (size == 2)
+        v = __builtin_bswap16(v);
+    }
+    if (emu_pio_is_txf(c->write))
+      emu_stats.dma_words++;
+    emu_bus_write(c->write, v, size);
+    c->read = dma_step_addr(c->read, size, incr_read, ring_write ? 0 : ring);
+    c->write = dma_step_addr(c->write, size, incr_write, ring_write ? ring : 0);
+  }
+
+  if (!(ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS))
+    dma_raise(ch);
+  if (chain != ch)
+    dma_trigger(chain, 1);
+}
+
+static void dma_run(void) {
+  if (m_running)
+    return;
+  m_running = true;
+  while (m_pending) {
+    uint ch = __builtin_ctz(m_pending);
+    m_pending &= ~(1u << ch);
+    dma_transfer(ch);
+  }
+  m_running = false;
+
+  // The interrupt arrives once the chain has stopped; a handler that kicks
+  // another flush is served by the loop rather than recursion
+  if (m_delivering)
+    return;
+  m_delivering = true;
+  while ((dma_hw->ints0 & dma_hw->inte0) && irq_is_enabled(DMA_IRQ_0)) {
+    uint32_t before = dma_hw->ints0;
+    uint32_t acks = m_int_acks;
+    emu_stats.dma_irqs++;
+    emu_irq_raise(DMA_IRQ_0);
+    if (m_int_acks == acks)
+      emu_fatal("DMA_IRQ_0 handler left INTS0 0x%x set", before);
+  }
+  m_delivering = false;
+}
+
+void emu_bus_write(uint32_t addr, uint32_t value, uint size) {
+  uint32_t base = emu_bus_addr(&emu_dma_hw);
+
+  if (addr >= base && addr < base + sizeof(emu_dma_hw)) {
+    uint32_t off = addr - base;
+    if (size != 4)
+      emu_fatal("DMA register 0x%x written %u bytes wide", off, size);
+    if (off < sizeof(emu_dma_hw.ch)) {
+      dma_reg_write(off / sizeof(dma_channel_hw_t),
+                    off % sizeof(dma_channel_hw_t) / 4, value);
+    } else if (addr == emu_bus_addr(&dma_hw->ints0)) {
+      if (dma_hw->intr & value)
+        m_int_acks++;
+      dma_hw->intr &= ~value;
+      dma_hw->ints0 = dma_hw->intr & dma_hw->inte0;
+    } else {
+      *(volatile uint32_t *)emu_host_ptr(addr) = value;
+    }
+    return;
+  }
+  if (emu_pio_is_txf(addr)) {
+    emu_pio_txf_write(addr, value);
+    return;
+  }
+  memcpy(emu_host_ptr(addr), &value, size);
+}
+
+// SDK interface
+
+int dma_claim_unused_channel(bool required) {
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    if (!m_ch[ch].claimed) {
+      m_ch[ch].claimed = true;
+      return ch;
+    }
+  }
+  if (required)
+    emu_fatal("no free DMA channel");
+  return -1;
+}
+
+void dma_channel_unclaim(uint channel) { m_ch[channel].claimed = false; }
+
+static void dma_cpu_write(volatile io_rw_32 *reg, uint32_t value) {
+  emu_bus_write(emu_bus_addr(reg), value, 4);
+  dma_run();
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config,
+                            bool trigger) {
+  dma_cpu_write(trigger ? &dma_hw->ch[channel].ctrl_trig
+                        : &dma_hw->ch[channel].al1_ctrl,
+                channel_config_get_ctrl_value(config));
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr,
+                               bool trigger) {
+  dma_cpu_write(trigger ? &dma_hw->ch[channel].al3_read_addr_trig
+                        : &dma_hw->ch[channel].read_addr,
+                emu_bus_addr(read_addr));
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr,
+                                bool trigger) {
+  dma_cpu_write(trigger ? &dma_hw->ch[channel].al2_write_addr_trig
+                        : &dma_hw->ch[channel].write_addr,
+                emu_bus_addr(write_addr));
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t count, bool trigger) {
+  dma_cpu_write(trigger ? &dma_hw->ch[channel].al1_transfer_count_trig
+                        : &dma_hw->ch[channel].transfer_count,
+                count);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config,
+                           volatile void *write_addr,
+                           const volatile void *read_addr,
+                           uint transfer_count, bool trigger) {
+  dma_channel_set_read_addr(channel, read_addr, false);
+  dma_channel_set_write_addr(channel, write_addr, false);
+  dma_channel_set_trans_count(channel, transfer_count, false);
+  dma_channel_set_config(channel, config, trigger);
+}
+
+void dma_channel_start(uint channel) {
+  dma_trigger(channel, 1);
+  dma_run();
+}
+
+void dma_channel_abort(uint channel) { m_pending &= ~(1u << channel); }
+
+bool dma_channel_is_busy(uint channel) {
+  return m_pending & (1u << channel);
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) { (void)channel; }
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+  if (enabled)
+    dma_hw->inte0 |= 1u << channel;
+  else
+    dma_hw->inte0 &= ~(1u << channel);
+  dma_hw->ints0 = dma_hw->intr & dma_hw->inte0;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+  return dma_hw->ints0 & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+  emu_bus_write(emu_bus_addr(&dma_hw->ints0), 1u << channel, 4);
+}
@@ -0,0 +1,324 @@
+#include "emu.h"
+#include "qspi_pio.h"
+#include <string.h>
+
+// SH8601 as seen from its QSPI pins. Each CS low period is one frame: the
+// opcode and 24-bit address arrive on DIO0, sampled on rising SCLK, then
+// the data: parameters on DIO0 for opcode 0x02, pixels on DIO3..DIO0 for
+// 0x32, or, for a 0x03 read, register bytes the panel drives on DIO1 after
+// each falling edge. Commands take effect when CS rises; RAMWR/RAMWRC
+// pixels are stored as they arrive. RAMRD answers with the window's pixels
+// from its start, RGB565 high byte first.
+
+#define OP_WRITE 0x02
+#define OP_READ 0x03
+#define OP_PIXEL 0x32
+
+#define CMD_SLPOUT 0x11
+#define CMD_DISPON 0x29
+#define CMD_CASET 0x2a
+#define CMD_RASET 0x2b
+#define CMD_RAMWR 0x2c
+#define CMD_RAMRD 0x2e
+#define CMD_VSCRDEF 0x33
+#define CMD_MADCTL 0x36
+#define CMD_VSCSAD 0x37
+#define CMD_RAMWRC 0x3c
+#define CMD_WRDISBV 0x51
+#define CMD_RDDISBV 0x52
+
+#define MADCTL_MY 0x80
+#define MADCTL_MX 0x40
+#define MADCTL_MV 0x20
+
+#define PANEL_MAX_PARAMS 64
+#define PANEL_MAX_READ 64
+
+uint16_t emu_panel_fb[EMU_PANEL_WIDTH * EMU_PANEL_HEIGHT];
+
+static struct {
+  bool cs, sclk, rst; // last levels seen
+
+  uint32_t header; // opcode and address, MSB first
+  uint8_t header_bits;
+  uint8_t op, cmd;
+  uint8_t byte, byte_bits;
+  bool corrupt;
+
+  uint8_t params[PANEL_MAX_PARAMS];
+  uint8_t nparams;
+
+  uint8_t read_data[PANEL_MAX_READ];
+  uint16_t read_bit;
+
+  uint16_t xs, xe, ys, ye; // window, inclusive
+  uint16_t px, py;         // RAMWR pointer
+  uint8_t pixel_hi;
+  bool have_hi;
+
+  uint8_t brightness;
+  uint8_t madctl;
+  uint16_t tfa, vsa, vsp; // scroll area and start
+
+  uint32_t max_sclk;
+  uint32_t max_quad_sclk;
+  uint64_t last_rise;
+} m = {.cs = true, .rst = true, .xe = EMU_PANEL_WIDTH - 1,
+       .ye = EMU_PANEL_HEIGHT - 1, .vsa = EMU_PANEL_HEIGHT};
+
+void emu_panel_set_max_sclk(uint32_t hz) { m.max_sclk = hz; }
+
+void emu_panel_set_max_quad_sclk(uint32_t hz) { m.max_quad_sclk = hz; }
+
+uint8_t emu_panel_brightness(void) { return m.brightness; }
+
+static void panel_reset(void) {
+  m.xs = m.ys = 0;
+  m.xe = EMU_PANEL_WIDTH - 1;
+  m.ye = EMU_PANEL_HEIGHT - 1;
+  m.brightness = 0;
+  m.madctl = 0;
+  m.tfa = 0;
+  m.vsa = EMU_PANEL_HEIGHT;
+  m.vsp = 0;
+}
+
+void emu_panel_scanout(uint16_t *out) {
+  for (int y = 0; y < EMU_PANEL_HEIGHT; y++) {
+    int row = y;
+    if (y >= m.tfa && y < m.tfa + m.vsa && m.vsp >= m.tfa &&
+        m.vsp < m.tfa + m.vsa)
+      row = m.tfa + (y - m.tfa + m.vsp - m.tfa) % m.vsa;
+    memcpy(&out[y * EMU_PANEL_WIDTH], &emu_panel_fb[row * EMU_PANEL_WIDTH],
+           EMU_PANEL_WIDTH * sizeof(uint16_t));
+  }
+}
+
+// Memory behind window position (px, py), or NULL outside the panel.
+// Address mode: MX and MY reverse the column and page order, MV exchanges
+// them, so the window is in rotated coordinates and memory stays portrait.
+static uint16_t *panel_mem(uint16_t px, uint16_t py) {
+  bool mv = m.madctl & MADCTL_MV;
+  uint16_t cols = mv ? EMU_PANEL_HEIGHT : EMU_PANEL_WIDTH;
+  uint16_t pages = mv ? EMU_PANEL_WIDTH : EMU_PANEL_HEIGHT;
+  if (px >= cols || py >= pages)
+    return NULL;
+  uint16_t c = m.madctl & MADCTL_MX ? cols - 1 - px : px;
+  uint16_t r = m.madctl & MADCTL_MY ? pages - 1 - py : py;
+  uint16_t x = mv ? r : c;
+  uint16_t y = mv ? c : r;
+  return &emu_panel_fb[y * EMU_PANEL_WIDTH + x];
+}
+
+static void panel_advance(void) {
+  if (++m.px > m.xe) {
+    m.px = m.xs;
+    if (++m.py > m.ye)
+      m.py = m.ys;
+  }
+}
+
+static void panel_pixel(uint8_t b) {
+  if (!m.have_hi) {
+    m.pixel_hi = b;
+    m.have_hi = true;
+    return;
+  }
+  m.have_hi = false;
+
+  uint16_t *p = panel_mem(m.px, m.py);
+  if (p)
+    *p = m.pixel_hi << 8 | b;
+  else
+    emu_stats.errors++;
+  panel_advance();
+}
+
+static void panel_byte(uint8_t b) {
+  if (m.op == OP_PIXEL) {
+    emu_stats.pixel_bytes++;
+    if (m.cmd == CMD_RAMWR || m.cmd == CMD_RAMWRC)
+      panel_pixel(b);
+    return;
+  }
+  emu_stats.cmd_bytes++;
+  if (m.op == OP_WRITE && m.nparams < PANEL_MAX_PARAMS)
+    m.params[m.nparams++] = m.corrupt ? b ^ 0x01 : b;
+}
+
+static void panel_command(void) {
+  const uint8_t *p = m.params;
+
+  switch (m.cmd) {
+  case CMD_CASET:
+    if (m.nparams >= 4) {
+      m.xs = p[0] << 8 | p[1];
+      m.xe = p[2] << 8 | p[3];
+    }
+    break;
+  case CMD_RASET:
+    if (m.nparams >= 4) {
+      m.ys = p[0] << 8 | p[1];
+      m.ye = p[2] << 8 | p[3];
+    }
+    break;
+  case CMD_VSCRDEF:
+    if (m.nparams >= 6) {
+      uint16_t tfa = p[0] << 8 | p[1];
+      uint16_t vsa = p[2] << 8 | p[3];
+      uint16_t bfa = p[4] << 8 | p[5];
+      if (tfa + vsa + bfa == EMU_PANEL_HEIGHT && vsa) {
+        m.tfa = tfa;
+        m.vsa = vsa;
+      } else {
+        emu_stats.errors++;
+      }
+    }
+    break;
+  case CMD_VSCSAD:
+    if (m.nparams >= 2)
+      m.vsp = p[0] << 8 | p[1];
+    break;
+  case CMD_MADCTL:
+    if (m.nparams >= 1)
+      m.madctl = p[0];
+    break;
+  case CMD_WRDISBV:
+    if (m.nparams >= 1)
+      m.brightness = p[0];
+    break;
+  default:
+    break;
+  }
+}
+
+static void panel_header_done(void) {
+  m.op = m.header >> 24;
+  m.cmd = m.header >> 8;
+  switch (m.op) {
+  case OP_WRITE:
+    break;
+  case OP_PIXEL:
+    emu_stats.windows++;
+    m.have_hi = false;
+    if (m.cmd == CMD_RAMWR) {
+      m.px = m.xs;
+      m.py = m.ys;
+    }
+    break;
+  case OP_READ:
+    memset(m.read_data, 0, sizeof(m.read_data));
+    if (m.cmd == CMD_RDDISBV)
+      m.read_data[0] = m.brightness;
+    if (m.cmd == CMD_RAMRD) {
+      m.px = m.xs;
+      m.py = m.ys;
+      for (int i = 0; i < PANEL_MAX_READ; i += 2) {
+        uint16_t *p = panel_mem(m.px, m.py);
+        uint16_t v = p ? *p : 0;
+        m.read_data[i] = v >> 8;
+        m.read_data[i + 1] = v & 0xff;
+        panel_advance();
+      }
+    }
+    m.read_bit = 0;
+    break;
+  default:
+    emu_stats.errors++;
+    break;
+  }
+}
+
+static void panel_rise(void) {
+  uint64_t now = emu_time_sys256();
+  uint64_t period = now - m.last_rise;
+
+  m.last_rise = now;
+  emu_stats.sclk_cycles++;
+
+  if (m.header_bits < 32) {
+    m.header = m.header << 1 | emu_gpio_level[PIN_DIO0];
+    if (++m.header_bits == 32)
+      panel_header_done();
+    return;
+  }
+  if (m.op == OP_READ)
+    return;
+  if (m.op == OP_PIXEL) {
+    uint8_t nibble = emu_gpio_level[PIN_DIO3] << 3 |
+                     emu_gpio_level[PIN_DIO2] << 2 |
+                     emu_gpio_level[PIN_DIO1] << 1 | emu_gpio_level[PIN_DIO0];
+    // Lane skew: a nibble clocked too fast loses its DIO0 bit
+    if (m.max_quad_sclk &&
+        period * m.max_quad_sclk < 256ull * EMU_SYS_CLOCK_HZ)
+      nibble ^= 0x01;
+    m.byte = m.byte << 4 | nibble;
+    m.byte_bits += 4;
+  } else {
+    // Register data clocked too fast is latched wrong
+    if (m.max_sclk && period * m.max_sclk < 256ull * EMU_SYS_CLOCK_HZ)
+      m.corrupt = true;
+    m.byte = m.byte << 1 | emu_gpio_level[PIN_DIO0];
+    m.byte_bits++;
+  }
+  if (m.byte_bits == 8) {
+    panel_byte(m.byte);
+    m.byte_bits = 0;
+    m.corrupt = false;
+  }
+}
+
+static void panel_fall(void) {
+  if (m.header_bits < 32 || m.op != OP_READ)
+    return;
+  uint16_t i = m.read_bit++;
+  uint8_t b = i / 8 < sizeof(m.read_data) ? m.read_data[i / 8] : 0;
+  emu_gpio_level[PIN_MISO] = (b >> (7 - i % 8)) & 1;
+}
+
+static void panel_select(void) {
+  m.header = 0;
+  m.header_bits = 0;
+  m.op = 0;
+  m.byte_bits = 0;
+  m.nparams = 0;
+  m.corrupt = false;
+}
+
+static void panel_deselect(void) {
+  emu_stats.transactions++;
+  if (m.header_bits < 32 || m.byte_bits) {
+    emu_stats.errors++;
+    return;
+  }
+  if (m.op == OP_WRITE)
+    panel_command();
+}
+
+void emu_panel_pins_changed(void) {
+  bool rst = emu_gpio_level[PIN_RST];
+  bool cs = emu_gpio_level[PIN_CS];
+  bool sclk = emu_gpio_level[PIN_SCLK];
+
+  if (rst != m.rst) {
+    m.rst = rst;
+    if (!rst)
+      panel_reset();
+  }
+  if (cs != m.cs) {
+    m.cs = cs;
+    if (!cs)
+      panel_select();
+    else
+      panel_deselect();
+  }
+  if (sclk != m.sclk) {
+    m.sclk = sclk;
+    if (!m.cs && m.rst) {
+      if (sclk)
+        panel_rise();
+      else
+        panel_fall();
+    }
+  }
+}
@@ -0,0 +1,511 @@
+#include "emu.h"
+#include "hardware/pio.h"
+#include <string.h>
+
+// PIO model: runs the real program instructions. OUT/IN/SET/MOV/JMP and
+// PULL/PUSH are supported with side-set, delays, wrap, autopull and
+// autopush; WAIT and IRQ are not used by the QSPI programs and stop the
+// emulator. A state machine runs whenever it is enabled and has work, until
+// it stalls on an empty TX FIFO or a full RX FIFO. Pin writes go straight
+// to emu_gpio_level and the panel model sees every change.
+
+pio_hw_t emu_pio_hw[2] __attribute__((aligned(0x1000)));
+
+#define EMU_PIO_FIFO_DEPTH 4
+
+typedef struct {
+  pio_sm_config cfg;
+  uint8_t pc;
+  uint32_t x, y, isr, osr;
+  uint8_t isr_count, osr_count;
+  bool push_stalled; // IN done, its autopush waiting for RX FIFO room
+  bool enabled;
+  uint32_t txf[2 * EMU_PIO_FIFO_DEPTH];
+  uint8_t tx_head, tx_level;
+  uint32_t rxf[2 * EMU_PIO_FIFO_DEPTH];
+  uint8_t rx_head, rx_level;
+} emu_sm_t;
+
+typedef struct {
+  uint16_t instr[PIO_INSTRUCTION_COUNT];
+  uint32_t used;
+  emu_sm_t sm[NUM_PIO_STATE_MACHINES];
+} emu_pio_t;
+
+static emu_pio_t m_pio[2];
+
+static emu_pio_t *pio_model(PIO pio) { return &m_pio[pio - emu_pio_hw]; }
+
+static uint fifo_depth(const emu_sm_t *s, bool tx) {
+  enum pio_fifo_join joined = tx ? PIO_FIFO_JOIN_TX : PIO_FIFO_JOIN_RX;
+  enum pio_fifo_join lost = tx ? PIO_FIFO_JOIN_RX : PIO_FIFO_JOIN_TX;
+  if (s->cfg.fifo_join == joined)
+    return 2 * EMU_PIO_FIFO_DEPTH;
+  return s->cfg.fifo_join == lost ? 0 : EMU_PIO_FIFO_DEPTH;
+}
+
+static uint32_t tx_pop(emu_sm_t *s) {
+  uint32_t v = s->txf[s->tx_head];
+  s->tx_head = (s->tx_head + 1) % (2 * EMU_PIO_FIFO_DEPTH);
+  s->tx_level--;
+  return v;
+}
+
+static void rx_push(emu_sm_t *s, uint32_t v) {
+  s->rxf[(s->rx_head + s->rx_level) % (2 * EMU_PIO_FIFO_DEPTH)] = v;
+  s->rx_level++;
+}
+
+static void pins_write(uint base, uint count, uint32_t value) {
+  for (uint i = 0; i < count; i++)
+    emu_gpio_level[(base + i) % NUM_BANK0_GPIOS] = (value >> i) & 1;
+}
+
+static uint32_t pins_read(uint base) {
+  uint32_t v = 0;
+  for (uint i = 0; i < 32; i++)
+    v |= (uint32_t)emu_gpio_level[(base + i) % NUM_BANK0_GPIOS] << i;
+  return v;
+}
+
+static uint32_t shift_out(emu_sm_t *s, uint n) {
+  uint32_t v;
+  if (n == 32) {
+    v = s->osr;
+    s->osr = 0;
+  } else if (s->cfg.out_shift_right) {
+    v = s->osr & ((1u << n) - 1);
+    s->osr >>= n;
+  } else {
+    v = s->osr >> (32 - n);
+    s->osr <<= n;
+  }
+  s->osr_count = s->osr_count + n > 32 ? 32 : s->osr_count + n;
+  return v;
+}
+
+static void shift_in(emu_sm_t *s, uint32_t v, uint n) {
+  if (n < 32)
+    v &= (1u << n) - 1;
+  if (n == 32)
+    s->isr = v;
+  else if (s->cfg.in_shift_right)
+    s->isr = (s->isr >> n) | (v << (32 - n));
+  else
+    s->isr = (s->isr << n) | v;
+  s->isr_count = s->isr_count + n > 32 ? 32 : s->isr_count + n;
+}
+
+static uint32_t bit_reverse(uint32_t v) {
+  uint32_t r = 0;
+  for (int i = 0; i < 32; i++, v >>= 1)
+    r = (r << 1) | (v & 1);
+  return r;
+}
+
+static uint32_t mov_src(emu_sm_t *s, uint src) {
+  switch (src) {
+  case 0:
+    return pins_read(s->cfg.in_base);
+  case 1:
+    return s->x;
+  case 2:
+    return s->y;
+  case 3:
+    return 0;
+  case 6:
+    return s->isr;
+  case 7:
+    return s->osr;
+  default:
+    emu_fatal("PIO: unsupported MOV source %u", src);
+  }
+}
+
+// Executes one instruction; false if the state machine stalled on it
+static bool sm_step(PIO pio, uint sm) {
+  emu_pio_t *p = pio_model(pio);
+  emu_sm_t *s = &p->sm[sm];
+  uint16_t ins = p->instr[s->pc];
+  uint ss_bits = s->cfg.sideset_bits;
+  uint field = (ins >> 8) & 0x1f;
+  uint delay = field & ((1u << (5 - ss_bits)) - 1);
+  uint ss_pins = s->cfg.sideset_opt ? ss_bits - 1 : ss_bits;
+  uint32_t ss_value = (field >> (5 - ss_bits)) & ((1u << ss_pins) - 1);
+  bool ss_enable = ss_bits && (!s->cfg.sideset_opt || (field & 0x10));
+  uint op = ins >> 13;
+  uint arg1 = (ins >> 5) & 7;
+  uint arg2 = ins & 0x1f;
+  bool jumped = false;
+
+  // Side-set is asserted even by an instruction that then stalls
+  if (ss_enable) {
+    pins_write(s->cfg.sideset_base, ss_pins, ss_value);
+    emu_panel_pins_changed();
+  }
+
+  switch (op) {
+  case 0: { // JMP
+    bool take;
+    switch (arg1) {
+    case 0:
+      take = true;
+      break;
+    case 1:
+      take = s->x == 0;
+      break;
+    case 2:
+      take = s->x-- != 0;
+      break;
+    case 3:
+      take = s->y == 0;
+      break;
+    case 4:
+      take = s->y-- != 0;
+      break;
+    case 5:
+      take = s->x != s->y;
+      break;
+    case 7:
+      take = s->osr_count < s->cfg.pull_threshold;
+      break;
+    default:
+      emu_fatal("PIO: unsupported JMP condition %u", arg1);
+    }
+    if (take) {
+      s->pc = arg2;
+      jumped = true;
+    }
+    break;
+  }
+  case 2: { // IN
+    uint n = arg2 ? arg2 : 32;
+    uint32_t v;
+    if (s->push_stalled) {
+      if (s->rx_level >= fifo_depth(s, false))
+        return false;
+      rx_push(s, s->isr);
+      s->isr = 0;
+      s->isr_count = 0;
+      s->push_stalled = false;
+      break;
+    }
+    if (s->cfg.autopush && s->isr_count >= s->cfg.push_threshold) {
+      if (s->rx_level >= fifo_depth(s, false))
+        return false;
+      rx_push(s, s->isr);
+      s->isr = 0;
+      s->isr_count = 0;
+    }
+    switch (arg1) {
+    case 0:
+      v = pins_read(s->cfg.in_base);
+      break;
+    case 1:
+      v = s->x;
+      break;
+    case 2:
+      v = s->y;
+      break;
+    case 3:
+      v = 0;
+      break;
+    case 6:
+      v = s->isr;
+      break;
+    case 7:
+      v = s->osr;
+      break;
+    default:
+      emu_fatal("PIO: unsupported IN source %u", arg1);
+    }
+    shift_in(s, v, n);
+    if (s->cfg.autopush && s->isr_count >= s->cfg.push_threshold) {
+      // The shift has happened; the IN itself stalls until the push can
+      if (s->rx_level >= fifo_depth(s, false)) {
+        s->push_stalled = true;
+        return false;
+      }
+      rx_push(s, s->isr);
+      s->isr = 0;
+      s->isr_count = 0;
+    }
+    break;
+  }
+  case 3: { // OUT
+    uint n = arg2 ? arg2 : 32;
+    uint32_t v;
+    if (s->cfg.autopull && s->osr_count >= s->cfg.pull_threshold) {
+      if (!s->tx_level) {
+        pio->fdebug |= 1u << (PIO_FDEBUG_TXSTALL_LSB + sm);
+        return false;
+      }
+      s->osr = tx_pop(s);
+      s->osr_count = 0;
+    }
+    v = shift_out(s, n);
+    switch (arg1) {
+    case 0:
+      pins_write(s->cfg.out_base, n < s->cfg.out_count ? n : s->cfg.out_count,
+                 v);
+      emu_panel_pins_changed();
+      break;
+    case 1:
+      s->x = v;
+      break;
+    case 2:
+      s->y = v;
+      break;
+    case 3:
+      break;
+    case 5:
+      s->pc = v & 0x1f;
+      jumped = true;
+      break;
+    case 6:
+      s->isr = v;
+      s->isr_count = n;
+      break;
+    default:
+      emu_fatal("PIO: unsupported OUT destination %u", arg1);
+    }
+    break;
+  }
+  case 4: { // PUSH / PULL
+    bool is_pull = ins & 0x80;
+    bool if_flag = ins & 0x40;
+    bool block = ins & 0x20;
+    if (is_pull) {
+      if (if_flag && s->osr_count < s->cfg.pull_threshold)
+        break;
+      if (s->tx_level) {
+        s->osr = tx_pop(s);
+      } else if (block) {
+        pio->fdebug |= 1u << (PIO_FDEBUG_TXSTALL_LSB + sm);
+        return false;
+      } else {
+        s->osr = s->x;
+      }
+      s->osr_count = 0;
+    } else {
+      if (if_flag && s->isr_count < s->cfg.push_threshold)
+        break;
+      if (s->rx_level >= fifo_depth(s, false)) {
+        if (block)
+          return false;
+      } else {
+        rx_push(s, s->isr);
+      }
+      s->isr = 0;
+      s->isr_count = 0;
+    }
+    break;
+  }
+  case 5: { // MOV
+    uint mop = (arg2 >> 3) & 3;
+    uint32_t v = mov_src(s, arg2 & 7);
+    if (mop == 1)
+      v = ~v;
+    else if (mop == 2)
+      v = bit_reverse(v);
+    switch (arg1) {
+    case 0:
+      pins_write(s->cfg.out_base, s->cfg.out_count, v);
+      emu_panel_pins_changed();
+      break;
+    case 1:
+      s->x = v;
+      break;
+    case 2:
+      s->y = v;
+      break;
+    case 5:
+      s->pc = v & 0x1f;
+      jumped = true;
+      break;
+    case 6:
+      s->isr = v;
+      s->isr_count = 0;
+      break;
+    case 7:
+      s->osr = v;
+      s->osr_count = 0;
+      break;
+    default:
+      emu_fatal("PIO: unsupported MOV destination %u", arg1);
+    }
+    break;
+  }
+  case 7: // SET
+    switch (arg1) {
+    case 0:
+      pins_write(s->cfg.set_base, s->cfg.set_count, arg2);
+      emu_panel_pins_changed();
+      break;
+    case 1:
+      s->x = arg2;
+      break;
+    case 2:
+      s->y = arg2;
+      break;
+    case 4:
+      break; // pindirs
+    default:
+      emu_fatal("PIO: unsupported SET destination %u", arg1);
+    }
+    break;
+  default:
+    emu_fatal("PIO: unsupported instruction 0x%04x at %u", ins, s->pc);
+  }
+
+  uint64_t cycles = 1 + delay;
+  uint64_t div256 = (uint64_t)s->cfg.clkdiv_int * 256 + s->cfg.clkdiv_frac;
+  emu_stats.pio_cycles += cycles;
+  emu_stats.bus_sys256 += cycles * div256;
+  emu_time_advance(cycles * div256);
+
+  if (!jumped)
+    s->pc = s->pc == s->cfg.wrap ? s->cfg.wrap_target : s->pc + 1;
+  return true;
+}
+
+static void sm_run(PIO pio, uint sm) {
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+  while (s->enabled && sm_step(pio, sm))
+    ;
+}
+
+bool emu_pio_is_txf(uint32_t addr) {
+  uint32_t base = emu_bus_addr(&emu_pio_hw[0]);
+  uint32_t end = emu_bus_addr(&emu_pio_hw[2]);
+  if (addr < base || addr >= end)
+    return false;
+  uint32_t off = (addr - base) % sizeof(pio_hw_t);
+  return off >= offsetof(pio_hw_t, txf) && off < offsetof(pio_hw_t, rxf);
+}
+
+void emu_pio_txf_write(uint32_t addr, uint32_t value) {
+  uint32_t off = addr - emu_bus_addr(&emu_pio_hw[0]);
+  PIO pio = &emu_pio_hw[off / sizeof(pio_hw_t)];
+  uint sm = (off % sizeof(pio_hw_t) - offsetof(pio_hw_t, txf)) / 4;
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+
+  if (s->tx_level >= fifo_depth(s, true))
+    emu_fatal("PIO%u SM%u TX FIFO written while full; the state machine is "
+              "%s",
+              (uint)(pio - emu_pio_hw), sm, s->enabled ? "stalled" : "stopped");
+  s->txf[(s->tx_head + s->tx_level) % (2 * EMU_PIO_FIFO_DEPTH)] = value;
+  s->tx_level++;
+  emu_stats.fifo_words++;
+  // The FIFO refill cleared the stall
+  pio->fdebug &= ~(1u << (PIO_FDEBUG_TXSTALL_LSB + sm));
+  sm_run(pio, sm);
+}
+
+// SDK interface
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+  emu_pio_t *p = pio_model(pio);
+  uint32_t mask = (1u << program->length) - 1;
+
+  // Placed from the top down, as the SDK does for relocatable programs
+  for (int offset = PIO_INSTRUCTION_COUNT - program->length; offset >= 0;
+       offset--) {
+    if (p->used & (mask << offset))
+      continue;
+    for (uint i = 0; i < program->length; i++) {
+      uint16_t ins = program->instructions[i];
+      // JMP targets are relative to the program
+      if ((ins >> 13) == 0)
+        ins += offset;
+      p->instr[offset + i] = ins;
+    }
+    p->used |= mask << offset;
+    return offset;
+  }
+  emu_fatal("no room for a %u instruction PIO program", program->length);
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+  (void)pio;
+  (void)pin;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+  return (uint)(pio - emu_pio_hw) * 8 + (is_tx ? 0 : 4) + sm;
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *c) {
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+
+  pio_sm_set_enabled(pio, sm, false);
+  s->cfg = *c;
+  s->pc = initial_pc;
+  s->x = s->y = s->isr = s->osr = 0;
+  s->isr_count = 0;
+  s->osr_count = 32;
+  s->push_stalled = false;
+  pio_sm_clear_fifos(pio, sm);
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm) {
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+  s->tx_level = s->rx_level = 0;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+  uint32_t bit = 1u << (PIO_CTRL_SM_ENABLE_LSB + sm);
+
+  s->enabled = enabled;
+  pio->ctrl = enabled ? pio->ctrl | bit : pio->ctrl & ~bit;
+  sm_run(pio, sm);
+}
+
+void pio_sm_set_clkdiv_int_frac8(PIO pio, uint sm, uint32_t div_int,
+                                 uint8_t div_frac) {
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+  s->cfg.clkdiv_int = div_int;
+  s->cfg.clkdiv_frac = div_frac;
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base,
+                                    uint pin_count, bool is_out) {
+  (void)pio;
+  (void)sm;
+  (void)pin_base;
+  (void)pin_count;
+  (void)is_out;
+}
+
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values,
+                               uint32_t pin_mask) {
+  (void)pio;
+  (void)sm;
+  for (uint pin = 0; pin < 32; pin++)
+    if (pin_mask & (1u << pin))
+      emu_gpio_level[pin] = (pin_values >> pin) & 1;
+  emu_panel_pins_changed();
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+  emu_pio_txf_write(emu_bus_addr(&pio->txf[sm]), data);
+}
+
+uint32_t pio_sm_get_blocking(PIO pio, uint sm) {
+  emu_sm_t *s = &pio_model(pio)->sm[sm];
+  uint32_t v;
+
+  if (!s->rx_level)
+    sm_run(pio, sm);
+  if (!s->rx_level)
+    emu_fatal("PIO%u SM%u RX FIFO read while empty and the state machine "
+              "is %s",
+              (uint)(pio - emu_pio_hw), sm, s->enabled ? "stalled" : "stopped");
+  v = s->rxf[s->rx_head];
+  s->rx_head = (s->rx_head + 1) % (2 * EMU_PIO_FIFO_DEPTH);
+  s->rx_level--;
+  // Room in the FIFO may let a stalled push go ahead
+  sm_run(pio, sm);
+  return v;
+}
@@ -0,0 +1,115 @@
+#include "emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Minimal PNG writer: 8-bit RGB, filter 0, zlib stream of stored deflate
+// blocks. Files are larger than they need to be, but nothing beyond libc
+// is required.
+
+static uint32_t m_crc_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t n) {
+  if (!m_crc_table[1]) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++)
+        c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      m_crc_table[i] = c;
+    }
+  }
+  crc = ~crc;
+  while (n--)
+    crc = m_crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+static void write_chunk(FILE *f, const char *type, const uint8_t *data,
+                        size_t len) {
+  uint8_t hdr[8];
+  uint8_t crc_be[4];
+  uint32_t crc;
+
+  put_be32(hdr, len);
+  for (int i = 0; i < 4; i++)
+    hdr[4 + i] = type[i];
+  crc = crc32_update(0, hdr + 4, 4);
+  crc = crc32_update(crc, data, len);
+  put_be32(crc_be, crc);
+  fwrite(hdr, 1, 8, f);
+  fwrite(data, 1, len, f);
+  fwrite(crc_be, 1, 4, f);
+}
+
+int emu_png_write_rgb565(const char *path, const uint16_t *px, int w, int h) {
+  static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  size_t raw_len = (size_t)h * (1 + 3 * w);
+  size_t blocks = (raw_len + 65534) / 65535;
+  size_t z_len = 2 + raw_len + 5 * blocks + 4;
+  uint8_t *raw = malloc(raw_len);
+  uint8_t *z = malloc(z_len);
+  uint8_t ihdr[13];
+  uint32_t a = 1, b = 0;
+  FILE *f;
+
+  if (!raw || !z) {
+    free(raw);
+    free(z);
+    return -1;
+  }
+
+  // Scanlines, each led by its filter byte
+  uint8_t *r = raw;
+  for (int y = 0; y < h; y++) {
+    *r++ = 0;
+    for (int x = 0; x < w; x++) {
+      uint16_t c = px[y * w + x];
+      uint8_t r5 = c >> 11, g6 = (c >> 5) & 0x3f, b5 = c & 0x1f;
+      *r++ = r5 << 3 | r5 >> 2;
+      *r++ = g6 << 2 | g6 >> 4;
+      *r++ = b5 << 3 | b5 >> 2;
+    }
+  }
+
+  uint8_t *o = z;
+  *o++ = 0x78;
+  *o++ = 0x01;
+  for (size_t off = 0; off < raw_len; off += 65535) {
+    size_t n = raw_len - off < 65535 ? raw_len - off : 65535;
+    *o++ = off + n == raw_len;
+    *o++ = n;
+    *o++ = n >> 8;
+    *o++ = ~n;
+    *o++ = ~n >> 8;
+    for (size_t i = 0; i < n; i++) {
+      *o++ = raw[off + i];
+      a = (a + raw[off + i]) % 65521;
+      b = (b + a) % 65521;
+    }
+  }
+  put_be32(o, b << 16 | a);
+
+  put_be32(ihdr, w);
+  put_be32(ihdr + 4, h);
+  ihdr[8] = 8; // bit depth
+  ihdr[9] = 2; // truecolour
+  ihdr[10] = ihdr[11] = ihdr[12] = 0;
+
+  f = fopen(path, "wb");
+  if (f) {
+    fwrite(sig, 1, sizeof(sig), f);
+    write_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(f, "IDAT", z, z_len);
+    write_chunk(f, "IEND", NULL, 0);
+    fclose(f);
+  }
+  free(raw);
+  free(z);
+  return f ? 0 : -1;
+}
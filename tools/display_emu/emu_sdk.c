@@ -0,0 +1,130 @@
+#include "DEV_Config.h"
+#include "emu.h"
+#include "hardware/clocks.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+emu_stats_t emu_stats;
+uint8_t emu_gpio_level[NUM_BANK0_GPIOS];
+uint dma_tx;
+
+static uint64_t m_sys256;
+
+#define EMU_IRQ_COUNT 64
+#define EMU_IRQ_HANDLERS 4
+static irq_handler_t m_handlers[EMU_IRQ_COUNT][EMU_IRQ_HANDLERS];
+static bool m_irq_enabled[EMU_IRQ_COUNT];
+
+void emu_stats_reset(void) { memset(&emu_stats, 0, sizeof(emu_stats)); }
+
+void emu_fatal(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  fprintf(stderr, "display_emu: ");
+  vfprintf(stderr, fmt, ap);
+  fprintf(stderr, "\n");
+  va_end(ap);
+  exit(2);
+}
+
+uint32_t emu_bus_addr(const volatile void *p) {
+  uintptr_t a = (uintptr_t)p;
+  if (a > UINT32_MAX)
+    emu_fatal("address %p is not a 32-bit bus address; the emulator must "
+              "be linked without PIE",
+              (const void *)p);
+  return (uint32_t)a;
+}
+
+// Time
+
+void emu_time_advance(uint64_t sys256) { m_sys256 += sys256; }
+
+uint64_t emu_time_sys256(void) { return m_sys256; }
+
+uint64_t time_us_64(void) {
+  return m_sys256 / 256 / (EMU_SYS_CLOCK_HZ / 1000000);
+}
+
+void sleep_us(uint64_t us) {
+  m_sys256 += us * (EMU_SYS_CLOCK_HZ / 1000000) * 256;
+}
+
+void sleep_ms(uint32_t ms) { sleep_us((uint64_t)ms * 1000); }
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+  (void)clk_index;
+  return EMU_SYS_CLOCK_HZ;
+}
+
+// GPIO
+
+void gpio_init(uint gpio) { emu_gpio_level[gpio] = 0; }
+
+void gpio_set_dir(uint gpio, bool out) {
+  (void)gpio;
+  (void)out;
+}
+
+void gpio_put(uint gpio, bool value) {
+  emu_gpio_level[gpio] = value;
+  emu_panel_pins_changed();
+}
+
+bool gpio_get(uint gpio) { return emu_gpio_level[gpio]; }
+
+void gpio_pull_up(uint gpio) { (void)gpio; }
+
+void gpio_pull_down(uint gpio) { (void)gpio; }
+
+uint32_t gpio_get_irq_event_mask(uint gpio) {
+  (void)gpio;
+  return 0;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) {
+  (void)gpio;
+  (void)event_mask;
+}
+
+// Interrupts
+
+void irq_add_shared_handler(uint num, irq_handler_t handler,
+                            uint8_t order_priority) {
+  (void)order_priority;
+  for (int i = 0; i < EMU_IRQ_HANDLERS; i++) {
+    if (!m_handlers[num][i]) {
+      m_handlers[num][i] = handler;
+      return;
+    }
+  }
+  emu_fatal("too many handlers on IRQ %u", num);
+}
+
+void irq_set_enabled(uint num, bool enabled) { m_irq_enabled[num] = enabled; }
+
+bool irq_is_enabled(uint num) { return m_irq_enabled[num]; }
+
+void emu_irq_raise(uint num) {
+  if (!m_irq_enabled[num])
+    return;
+  for (int i = 0; i < EMU_IRQ_HANDLERS && m_handlers[num][i]; i++)
+    m_handlers[num][i]();
+}
+
+// DEV_Config
+
+void DEV_Delay_ms(UDOUBLE xms) { sleep_ms(xms); }
+
+void DEV_Delay_us(UDOUBLE xus) { sleep_us(xus); }
+
+void DEV_GPIO_Mode(UWORD Pin, UWORD Mode) { gpio_set_dir(Pin, Mode); }
+
+void DEV_IRQ_ADD_RAW(uint gpio, uint32_t events, irq_handler_t handler) {
+  (void)gpio;
+  (void)events;
+  irq_add_shared_handler(IO_IRQ_BANK0, handler, 0);
+  irq_set_enabled(IO_IRQ_BANK0, true);
+}
@@ -0,0 +1,485 @@
+#include "DEV_Config.h"
+#include "ImageData.h"
+#include "LCD_3IN49.h"
+#include "disp_drv.h"
+#include "emu.h"
+#include "frame_prof.h"
+#include "hardware/clocks.h"
+#include "qspi_pio.h"
+#include <getopt.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Host run of the display path: brings the panel up through the real
+// drivers, pushes a few known images through each flush path and checks
+// what the panel model received, then runs LVGL for a number of frames.
+// Each step prints its bus counters and can dump the panel as a PNG.
+
+#define W LCD_3IN49_WIDTH
+#define H LCD_3IN49_HEIGHT
+
+static const char *m_outdir;
+static int m_failed;
+static uint16_t m_screen[W * H]; // last scanout
+
+// Panel RGB565 for an image stored the way the flush DMA sends it
+static inline uint16_t swap16(uint16_t v) { return v << 8 | v >> 8; }
+
+static uint16_t pattern(int x, int y) {
+  uint16_t r = x * 31 / (W - 1);
+  uint16_t g = y * 63 / (H - 1);
+  uint16_t b = ((x / 16) ^ (y / 16)) & 1 ? 31 : 0;
+  return r << 11 | g << 5 | b;
+}
+
+static void dma_init(void) {
+  dma_channel_config c;
+
+  // As DEV_Module_Init sets it up
+  dma_tx = dma_claim_unused_channel(true);
+  c = dma_channel_get_default_config(dma_tx);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_bswap(&c, true);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, pio_get_dreq(qspi.pio, qspi.sm, true));
+  dma_channel_configure(dma_tx, &c, &qspi.pio->txf[qspi.sm], NULL, 0, false);
+}
+
+// Compares an inclusive panel region against expected RGB565, or against
+// one colour when img is NULL
+static bool check_region(int x0, int y0, int x1, int y1, const uint16_t *img,
+                         int stride, uint16_t color) {
+  emu_panel_scanout(m_screen);
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      uint16_t want = img ? img[(y - y0) * stride + (x - x0)] : color;
+      uint16_t got = m_screen[y * W + x];
+      if (got != want) {
+        printf("  mismatch at (%d,%d): %04x, expected %04x\n", x, y, got,
+               want);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void step_begin(void) {
+  emu_stats_reset();
+}
+
+static void step_end(const char *name, int check) {
+  const emu_stats_t *s = &emu_stats;
+
+  printf("%-10s %5u txn %4u win %7u fifo %7u dma %5u blk %3u irq "
+         "%7u cmd B %8u px B %9llu sclk %8.1f us %u err%s\n",
+         name, s->transactions, s->windows, s->fifo_words, s->dma_words,
+         s->dma_blocks, s->dma_irqs, s->cmd_bytes, s->pixel_bytes,
+         (unsigned long long)s->sclk_cycles,
+         s->bus_sys256 / 256.0 / (EMU_SYS_CLOCK_HZ / 1e6), s->errors,
+         check < 0 ? "" : check ? "  ok" : "  FAIL");
+  if (check == 0 || s->errors)
+    m_failed = 1;
+  if (m_outdir) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.png", m_outdir, name);
+    emu_panel_scanout(m_screen);
+    if (emu_png_write_rgb565(path, m_screen, W, H) != 0)
+      printf("  could not write %s\n", path);
+  }
+}
+
+// Panel RGB565 of an LCD_3IN49_IMAGE, for either format
+static void image_decode(const LCD_3IN49_IMAGE *image, uint16_t *out) {
+  const uint32_t *p = image->DATA;
+  uint32_t words = image->WIDTH * image->HEIGHT / 2;
+  uint32_t n = 0, w;
+
+  while (words) {
+    if (image->FORMAT == LCD_3IN49_IMAGE_RAW) {
+      n = words;
+    } else if (!n) {
+      n = *p & ~LCD_3IN49_RLE_RUN;
+      if (*p++ & LCD_3IN49_RLE_RUN) {
+        for (w = *p++; n; n--, words--, out += 2)
+          out[0] = swap16(w), out[1] = swap16(w >> 16);
+        continue;
+      }
+    }
+    for (; n && words; n--, words--, out += 2) {
+      w = *p++;
+      out[0] = swap16(w), out[1] = swap16(w >> 16);
+    }
+  }
+}
+
+static void run_splash(uint16_t *want) {
+  const int w = splash_img.WIDTH, h = splash_img.HEIGHT;
+  const int x0 = (W - w) / 2 & ~1, y0 = (H - h) / 2 & ~1;
+
+  image_decode(&splash_img, want);
+  step_begin();
+  LCD_3IN49_Splash(&splash_img, SPLASH_BG);
+  step_end("splash",
+           check_region(0, 0, W - 1, y0 - 1, NULL, 0, SPLASH_BG) &&
+               check_region(x0, y0, x0 + w - 1, y0 + h - 1, want, w, 0) &&
+               check_region(0, y0 + h, W - 1, H - 1, NULL, 0, SPLASH_BG));
+}
+
+static void run_clear(void) {
+  step_begin();
+  LCD_3IN49_Clear(BLUE);
+  step_end("clear", check_region(0, 0, W - 1, H - 1, NULL, 0, BLUE));
+}
+
+static void run_display(uint16_t *img, uint16_t *want) {
+  for (int y = 0; y < H; y++) {
+    for (int x = 0; x < W; x++) {
+      want[y * W + x] = pattern(x, y);
+      img[y * W + x] = swap16(pattern(x, y));
+    }
+  }
+  step_begin();
+  LCD_3IN49_Display(img);
+  step_end("display", check_region(0, 0, W - 1, H - 1, want, W, 0));
+}
+
+static void run_windows(uint16_t *img, uint16_t *want) {
+  // Sub-window out of a full-width image; ends are exclusive and even
+  const int x0 = 20, y0 = 100, x1 = 140, y1 = 300;
+
+  for (int i = 0; i < W * H; i++) {
+    want[i] = ~pattern(i % W, i / W);
+    img[i] = swap16(want[i]);
+  }
+  step_begin();
+  LCD_3IN49_DisplayWindows(x0, y0, x1, y1, img);
+  step_end("windows",
+           check_region(x0, y0, x1 - 1, y1 - 1, want + y0 * W + x0, W, 0));
+}
+
+static volatile int m_fill_done;
+
+static void fill_done(void *user) {
+  (void)user;
+  m_fill_done = 1;
+}
+
+static void run_fill(void) {
+  const int x0 = 40, y0 = 400, x1 = 132, y1 = 600;
+
+  step_begin();
+  m_fill_done = 0;
+  LCD_3IN49_Fill_Async(x0, y0, x1, y1, RED, fill_done, NULL);
+  LCD_3IN49_Flush_Wait();
+  step_end("fill",
+           m_fill_done && check_region(x0, y0, x1 - 1, y1 - 1, NULL, 0, RED));
+}
+
+static void run_image(uint16_t *want) {
+  // RLE streamed into the scroll area across the end of its ring, so runs
+  // and literals get split between the two segments
+  const int top = 100, height = 400, offset = 360;
+  const int w = splash_img.WIDTH, h = splash_img.HEIGHT, y0 = 120;
+
+  image_decode(&splash_img, want);
+  LCD_3IN49_Clear(BLACK);
+  LCD_3IN49_SetScrollArea(top, height);
+  LCD_3IN49_SetScrollStart(offset);
+  step_begin();
+  m_fill_done = 0;
+  LCD_3IN49_Image_Async(0, y0, &splash_img, fill_done, NULL);
+  LCD_3IN49_Flush_Wait();
+  step_end("image_rle",
+           m_fill_done && check_region(0, y0, w - 1, y0 + h - 1, want, w, 0) &&
+               check_region(0, y0 + h, W - 1, H - 1, NULL, 0, BLACK));
+  LCD_3IN49_SetScrollArea(0, 0);
+}
+
+static void run_rotate(uint16_t *img, uint16_t *want) {
+  // A landscape frame, written through MADCTL, lands in portrait memory
+  // turned a quarter: landscape (x, y) is panel (y, H - 1 - x)
+  LCD_3IN49_SetAttributes(HORIZONTAL);
+  for (int y = 0; y < W; y++) {
+    for (int x = 0; x < H; x++) {
+      uint16_t c = pattern(y, x) ^ 0x001f;
+      img[y * H + x] = swap16(c);
+      want[(H - 1 - x) * W + y] = c;
+    }
+  }
+  step_begin();
+  LCD_3IN49_Display(img);
+  step_end("rotate", LCD_3IN49.WIDTH == H &&
+                         check_region(0, 0, W - 1, H - 1, want, W, 0));
+  LCD_3IN49_SetAttributes(VERTICAL);
+}
+
+// LVGL demo: a few widgets with something animating every frame
+static lv_obj_t *m_bar;
+static lv_obj_t *m_count;
+static lv_obj_t *m_logo;
+
+static void demo_scene(bool landscape) {
+  lv_obj_t *scr = lv_scr_act();
+  lv_obj_t *title = lv_label_create(scr);
+  lv_obj_t *btn;
+
+  lv_label_set_text(title, "QSPI emulator");
+  lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 20);
+  for (int i = 0; i < 3; i++) {
+    btn = lv_btn_create(scr);
+    lv_obj_set_size(btn, 120, 50);
+    if (landscape)
+      lv_obj_align(btn, LV_ALIGN_TOP_LEFT, 60 + i * 140, 50);
+    else
+      lv_obj_align(btn, LV_ALIGN_TOP_MID, 0, 80 + i * 70);
+    lv_label_set_text_fmt(lv_label_create(btn), "Button %d", i + 1);
+  }
+  m_bar = lv_bar_create(scr);
+  lv_obj_set_size(m_bar, 140, 16);
+  lv_obj_align(m_bar, LV_ALIGN_BOTTOM_MID, 0, landscape ? -40 : -120);
+  m_count = lv_label_create(scr);
+  lv_obj_align(m_count, LV_ALIGN_BOTTOM_MID, 0, landscape ? -10 : -60);
+  // The splash straight from flash, composed over the screen by the flush
+  m_logo = LVGL_Image_Overlay_Create(scr, &splash_img);
+  lv_obj_set_pos(m_logo, landscape ? 460 : 0, landscape ? 50 : 300);
+}
+
+// Whether the overlay is on the panel; landscape (x, y) is panel
+// (y, H - 1 - x), as in run_rotate
+static bool check_logo(bool landscape, uint16_t *want) {
+  const int w = splash_img.WIDTH, h = splash_img.HEIGHT;
+  const int x0 = lv_obj_get_x(m_logo), y0 = lv_obj_get_y(m_logo);
+
+  image_decode(&splash_img, want);
+  emu_panel_scanout(m_screen);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int px = landscape ? y0 + y : x0 + x;
+      int py = landscape ? H - 1 - (x0 + x) : y0 + y;
+      if (m_screen[py * W + px] != want[y * w + x]) {
+        printf("  overlay mismatch at (%d,%d)\n", x0 + x, y0 + y);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void run_lvgl(int frames, bool landscape, uint16_t *want) {
+  lvgl_flush_stats_t fs;
+
+  LCD_3IN49_SetAttributes(landscape ? HORIZONTAL : VERTICAL);
+  lv_init();
+  disp_drv_init();
+  // Fatal if the draw buffers landed above 4 GB
+  emu_bus_addr(lv_disp_get_default()->driver->draw_buf->buf1);
+  emu_bus_addr(lv_disp_get_default()->driver->draw_buf->buf2);
+  demo_scene(landscape);
+
+  // First frame draws the whole screen
+  step_begin();
+  lv_timer_handler();
+  LCD_3IN49_Flush_Wait();
+  step_end("lvgl_full", -1);
+
+  step_begin();
+  LVGL_Reset_Flush_Stats();
+  prof_reset();
+  for (int i = 0; i < frames; i++) {
+    lv_bar_set_value(m_bar, i * 100 / frames, LV_ANIM_OFF);
+    lv_label_set_text_fmt(m_count, "frame %d", i);
+    sleep_ms(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+  }
+  LCD_3IN49_Flush_Wait();
+  step_end("lvgl_anim", check_logo(landscape, want));
+
+  LVGL_Get_Flush_Stats(&fs);
+  printf("  %u frames, %u flushes, %llu px bytes, frame max %u B / %u us\n",
+         fs.frames, fs.flushes, (unsigned long long)fs.bytes,
+         fs.frame_bytes_max, fs.frame_us_max);
+}
+
+static void run_scroll(int frames) {
+  static uint16_t scrolled[W * H];
+  lv_obj_t *old = lv_scr_act();
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_coord_t hor = lv_disp_get_hor_res(NULL);
+  lvgl_flush_stats_t fs;
+  bool attached;
+
+  // LVGL's heap is 32 KB, as on the device: drop the last scene first
+  lv_scr_load(scr);
+  lv_obj_del(old);
+
+  // A title above a full-width list; the list's rows are the scroll area
+  lv_obj_t *title = lv_label_create(scr);
+  lv_label_set_text(title, "scroll");
+  lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 12);
+  lv_obj_t *list = lv_list_create(scr);
+  lv_obj_set_size(list, hor, lv_disp_get_ver_res(NULL) - 64);
+  lv_obj_align(list, LV_ALIGN_TOP_LEFT, 0, 48);
+  for (int i = 0; i < 24; i++) {
+    char text[16];
+    snprintf(text, sizeof(text), "Item %d", i);
+    lv_list_add_btn(list, LV_SYMBOL_FILE, text);
+  }
+  sleep_ms(LV_DISP_DEF_REFR_PERIOD);
+  lv_timer_handler();
+  LCD_3IN49_Flush_Wait();
+  attached = LVGL_HW_Scroll_Attach(list);
+
+  step_begin();
+  LVGL_Reset_Flush_Stats();
+  for (int i = 0; i < frames; i++) {
+    // Odd and even steps, as a finger drag gives them
+    lv_obj_scroll_by(list, 0, -(3 + i % 4), LV_ANIM_OFF);
+    sleep_ms(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+  }
+  LCD_3IN49_Flush_Wait();
+  step_end("scroll", -1);
+  LVGL_Get_Flush_Stats(&fs);
+  printf("  hw scroll %s: %u steps shifted, %u redrawn, %llu px bytes "
+         "(%u a step for the whole list)\n",
+         attached ? "on" : "off", fs.scrolls_hw, fs.scrolls_redrawn,
+         (unsigned long long)fs.bytes,
+         (unsigned)(lv_area_get_size(&list->coords) * sizeof(lv_color_t)));
+
+  // Redrawing the list straight must not change what is on screen
+  emu_panel_scanout(scrolled);
+  step_begin();
+  LVGL_HW_Scroll_Attach(NULL);
+  sleep_ms(LV_DISP_DEF_REFR_PERIOD);
+  lv_timer_handler();
+  LCD_3IN49_Flush_Wait();
+  step_end("scroll_ref", check_region(0, 0, W - 1, H - 1, scrolled, W, 0));
+}
+
+static void write_file(const char *s, size_t len, void *user) {
+  fwrite(s, 1, len, user);
+}
+
+static void write_trace(void) {
+  char path[512];
+  FILE *f;
+
+  snprintf(path, sizeof(path), "%s/trace.json", m_outdir);
+  f = fopen(path, "w");
+  if (!f) {
+    printf("could not write %s\n", path);
+    return;
+  }
+  prof_export_chrome(write_file, f);
+  fclose(f);
+}
+
+static void usage(const char *argv0) {
+  printf("usage: %s [-o outdir] [-n frames] [--landscape] [--calibrate]\n"
+         "          [--max-sclk hz] [--max-quad-sclk hz]\n"
+         "  -o DIR         write a PNG per step and trace.json into DIR\n"
+         "  -n FRAMES      LVGL frames to run (default 60)\n"
+         "  --landscape    run LVGL at 640x172 through the panel's MADCTL\n"
+         "  --calibrate    run LCD_3IN49_Calibrate_Clock after init\n"
+         "  --max-sclk HZ  fastest SCLK the panel takes register writes at\n"
+         "  --max-quad-sclk HZ\n"
+         "                 fastest SCLK the panel takes pixels at\n",
+         argv0);
+}
+
+int main(int argc, char **argv) {
+  static const struct option opts[] = {
+      {"calibrate", no_argument, NULL, 'c'},
+      {"max-sclk", required_argument, NULL, 's'},
+      {"max-quad-sclk", required_argument, NULL, 'q'},
+      {"landscape", no_argument, NULL, 'l'},
+      {"help", no_argument, NULL, 'h'},
+      {NULL, 0, NULL, 0},
+  };
+  bool calibrate = false;
+  bool landscape = false;
+  int frames = 60;
+  uint16_t *img, *want;
+  int opt;
+
+  while ((opt = getopt_long(argc, argv, "o:n:h", opts, NULL)) != -1) {
+    switch (opt) {
+    case 'o':
+      m_outdir = optarg;
+      break;
+    case 'n':
+      frames = atoi(optarg);
+      break;
+    case 'c':
+      calibrate = true;
+      break;
+    case 's':
+      emu_panel_set_max_sclk(strtoul(optarg, NULL, 0));
+      break;
+    case 'q':
+      emu_panel_set_max_quad_sclk(strtoul(optarg, NULL, 0));
+      break;
+    case 'l':
+      landscape = true;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 2;
+    }
+  }
+  if (m_outdir)
+    mkdir(m_outdir, 0755);
+
+  // Keep large blocks on the brk heap, which a non-PIE binary has below
+  // 4 GB, rather than in mmap regions that may not be
+  mallopt(M_MMAP_THRESHOLD, 256 * 1024 * 1024);
+  img = malloc(W * H * sizeof(uint16_t));
+  want = malloc(W * H * sizeof(uint16_t));
+  if (!img || !want)
+    emu_fatal("out of memory");
+  emu_bus_addr(img + W * H);
+
+  // Bring-up, as display_init does it on the device
+  dma_init();
+  step_begin();
+  uint32_t t0 = time_us_32();
+  QSPI_GPIO_Init(qspi);
+  QSPI_PIO_Init(qspi);
+  QSPI_4Wrie_Mode(&qspi);
+  LCD_3IN49_Init();
+  step_end("init", -1);
+  printf("  panel up in %.1f ms\n", (time_us_32() - t0) / 1000.0);
+  if (calibrate) {
+    // Not one of LCD_3IN49_Check_Link's patterns, so a missed restore shows
+    uint8_t level = 0x80;
+    QSPI_Command_Write(qspi, 0x51, &level, 1);
+    step_begin();
+    uint32_t hz = LCD_3IN49_Calibrate_Clock(
+        LCD_3IN49_SCLK_MIN_HZ, LCD_3IN49_SCLK_MAX_HZ, LCD_3IN49_SCLK_STEP_HZ);
+    step_end("calibrate", hz != 0 && emu_panel_brightness() == level);
+    printf("  SCLK %u Hz, brightness 0x%02x (0x%02x before)\n", QSPI_Get_Clock(),
+           emu_panel_brightness(), level);
+  }
+
+  run_splash(want);
+  run_clear();
+  run_display(img, want);
+  run_windows(img, want);
+  run_fill();
+  run_image(want);
+  run_rotate(img, want);
+  run_lvgl(frames, landscape, want);
+  run_scroll(frames);
+  if (m_outdir)
+    write_trace();
+
+  free(img);
+  free(want);
+  printf("%s\n", m_failed ? "FAILED" : "passed");
+  return m_failed;
+}
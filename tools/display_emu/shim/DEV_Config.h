@@ -0,0 +1,26 @@
+#ifndef _DEV_CONFIG_H_
+#define _DEV_CONFIG_H_
+
+// Stand-in for lib/Config/DEV_Config.h: only what the display path uses.
+// The real header pulls in the I2C, SPI and ADC drivers as well.
+
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define UBYTE uint8_t
+#define UWORD uint16_t
+#define UDOUBLE uint32_t
+
+extern uint dma_tx;
+
+void DEV_Delay_ms(UDOUBLE xms);
+void DEV_Delay_us(UDOUBLE xus);
+void DEV_GPIO_Mode(UWORD Pin, UWORD Mode);
+void DEV_IRQ_ADD_RAW(uint gpio, uint32_t events, irq_handler_t handler);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef EMU_HARDWARE_CLOCKS_H
+#define EMU_HARDWARE_CLOCKS_H
+
+#include "pico/types.h"
+
+enum clock_index { clk_sys = 5 };
+
+#define EMU_SYS_CLOCK_HZ 150000000u
+
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef EMU_HARDWARE_DMA_H
+#define EMU_HARDWARE_DMA_H
+
+#include "pico/types.h"
+
+#define NUM_DMA_CHANNELS 16
+
+// Same layout as the RP2350 channel registers, so alias addresses taken
+// by the drivers (al1_ctrl, al3_read_addr_trig, ...) decode to the right
+// register and trigger in the model
+typedef struct {
+  io_rw_32 read_addr;
+  io_rw_32 write_addr;
+  io_rw_32 transfer_count;
+  io_rw_32 ctrl_trig;
+  io_rw_32 al1_ctrl;
+  io_rw_32 al1_read_addr;
+  io_rw_32 al1_write_addr;
+  io_rw_32 al1_transfer_count_trig;
+  io_rw_32 al2_ctrl;
+  io_rw_32 al2_transfer_count;
+  io_rw_32 al2_read_addr;
+  io_rw_32 al2_write_addr_trig;
+  io_rw_32 al3_ctrl;
+  io_rw_32 al3_write_addr;
+  io_rw_32 al3_transfer_count;
+  io_rw_32 al3_read_addr_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+  dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+  io_rw_32 intr;
+  io_rw_32 inte0;
+  io_rw_32 intf0;
+  io_rw_32 ints0;
+} dma_hw_t;
+
+extern dma_hw_t emu_dma_hw;
+#define dma_hw (&emu_dma_hw)
+
+// CTRL register fields (RP2350)
+#define DMA_CH0_CTRL_TRIG_EN_BITS 0x00000001u
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB 2
+#define DMA_CH0_CTRL_TRIG_INCR_READ_BITS 0x00000010u
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS 0x00000040u
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_LSB 8
+#define DMA_CH0_CTRL_TRIG_RING_SEL_BITS 0x00001000u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB 13
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB 17
+#define DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS 0x00800000u
+#define DMA_CH0_CTRL_TRIG_BSWAP_BITS 0x01000000u
+#define DREQ_FORCE 0x3f
+
+enum dma_channel_transfer_size {
+  DMA_SIZE_8 = 0,
+  DMA_SIZE_16 = 1,
+  DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+  uint32_t ctrl;
+} dma_channel_config;
+
+static inline void channel_config_set_bits(dma_channel_config *c,
+                                           uint32_t bits, bool on) {
+  c->ctrl = on ? c->ctrl | bits : c->ctrl & ~bits;
+}
+
+static inline void channel_config_set_field(dma_channel_config *c, uint lsb,
+                                            uint32_t mask, uint32_t value) {
+  c->ctrl = (c->ctrl & ~(mask << lsb)) | (value & mask) << lsb;
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c,
+                                                     bool incr) {
+  channel_config_set_bits(c, DMA_CH0_CTRL_TRIG_INCR_READ_BITS, incr);
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c,
+                                                      bool incr) {
+  channel_config_set_bits(c, DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS, incr);
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+  channel_config_set_field(c, DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB, 0x3f, dreq);
+}
+
+static inline void channel_config_set_chain_to(dma_channel_config *c,
+                                               uint chain_to) {
+  channel_config_set_field(c, DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB, 0xf, chain_to);
+}
+
+static inline void
+channel_config_set_transfer_data_size(dma_channel_config *c,
+                                      enum dma_channel_transfer_size size) {
+  channel_config_set_field(c, DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB, 0x3, size);
+}
+
+static inline void channel_config_set_ring(dma_channel_config *c, bool write,
+                                           uint size_bits) {
+  channel_config_set_field(c, DMA_CH0_CTRL_TRIG_RING_SIZE_LSB, 0xf, size_bits);
+  channel_config_set_bits(c, DMA_CH0_CTRL_TRIG_RING_SEL_BITS, write);
+}
+
+static inline void channel_config_set_bswap(dma_channel_config *c, bool bswap) {
+  channel_config_set_bits(c, DMA_CH0_CTRL_TRIG_BSWAP_BITS, bswap);
+}
+
+static inline void channel_config_set_irq_quiet(dma_channel_config *c,
+                                                bool irq_quiet) {
+  channel_config_set_bits(c, DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS, irq_quiet);
+}
+
+static inline void channel_config_set_enable(dma_channel_config *c,
+                                             bool enable) {
+  channel_config_set_bits(c, DMA_CH0_CTRL_TRIG_EN_BITS, enable);
+}
+
+static inline uint32_t
+channel_config_get_ctrl_value(const dma_channel_config *c) {
+  return c->ctrl;
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel) {
+  dma_channel_config c = {0};
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, DREQ_FORCE);
+  channel_config_set_chain_to(&c, channel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_enable(&c, true);
+  return c;
+}
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+void dma_channel_set_config(uint channel, const dma_channel_config *config,
+                            bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr,
+                               bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr,
+                                bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t count, bool trigger);
+void dma_channel_configure(uint channel, const dma_channel_config *config,
+                           volatile void *write_addr,
+                           const volatile void *read_addr,
+                           uint transfer_count, bool trigger);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef EMU_HARDWARE_GPIO_H
+#define EMU_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+#define NUM_BANK0_GPIOS 48
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_irq_level {
+  GPIO_IRQ_LEVEL_LOW = 0x1u,
+  GPIO_IRQ_LEVEL_HIGH = 0x2u,
+  GPIO_IRQ_EDGE_FALL = 0x4u,
+  GPIO_IRQ_EDGE_RISE = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_pull_up(uint gpio);
+void gpio_pull_down(uint gpio);
+uint32_t gpio_get_irq_event_mask(uint gpio);
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask);
+
+// Pin levels as seen on the board: whatever drives them last wins
+extern uint8_t emu_gpio_level[NUM_BANK0_GPIOS];
+
+#endif
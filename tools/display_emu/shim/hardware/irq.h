@@ -0,0 +1,20 @@
+#ifndef EMU_HARDWARE_IRQ_H
+#define EMU_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+typedef void (*irq_handler_t)(void);
+
+#define DMA_IRQ_0 10
+#define IO_IRQ_BANK0 21
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+void irq_add_shared_handler(uint num, irq_handler_t handler,
+                            uint8_t order_priority);
+void irq_set_enabled(uint num, bool enabled);
+bool irq_is_enabled(uint num);
+
+// Runs the handlers of an enabled interrupt; used by the peripheral models
+void emu_irq_raise(uint num);
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef EMU_HARDWARE_PIO_H
+#define EMU_HARDWARE_PIO_H
+
+#include "hardware/gpio.h"
+#include "pico/types.h"
+
+// Register block of one PIO as far as the drivers touch it directly. TX
+// FIFO writes by DMA land in txf[] and are routed to the model by address;
+// CPU access goes through the functions below.
+typedef struct {
+  io_rw_32 ctrl;
+  io_ro_32 fstat;
+  io_rw_32 fdebug;
+  io_ro_32 flevel;
+  io_wo_32 txf[4];
+  io_ro_32 rxf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t emu_pio_hw[2];
+#define pio0 (&emu_pio_hw[0])
+#define pio1 (&emu_pio_hw[1])
+
+#define NUM_PIO_STATE_MACHINES 4
+#define PIO_INSTRUCTION_COUNT 32
+#define PICO_PIO_VERSION 0
+
+#define PIO_CTRL_SM_ENABLE_LSB 0
+#define PIO_FDEBUG_TXSTALL_LSB 24
+
+typedef struct pio_program {
+  const uint16_t *instructions;
+  uint8_t length;
+  int8_t origin;
+  uint8_t pio_version;
+} pio_program_t;
+
+enum pio_fifo_join {
+  PIO_FIFO_JOIN_NONE = 0,
+  PIO_FIFO_JOIN_TX = 1,
+  PIO_FIFO_JOIN_RX = 2,
+};
+
+// Kept decoded rather than as register images; only the model reads it
+typedef struct {
+  uint32_t clkdiv_int;
+  uint8_t clkdiv_frac;
+  uint8_t wrap_target;
+  uint8_t wrap;
+  uint8_t sideset_bits; // including the enable bit when optional
+  bool sideset_opt;
+  uint8_t sideset_base;
+  uint8_t out_base;
+  uint8_t out_count;
+  uint8_t set_base;
+  uint8_t set_count;
+  uint8_t in_base;
+  bool out_shift_right;
+  bool autopull;
+  uint8_t pull_threshold;
+  bool in_shift_right;
+  bool autopush;
+  uint8_t push_threshold;
+  enum pio_fifo_join fifo_join;
+} pio_sm_config;
+
+static inline pio_sm_config pio_get_default_sm_config(void) {
+  pio_sm_config c = {0};
+  c.clkdiv_int = 1;
+  c.wrap = PIO_INSTRUCTION_COUNT - 1;
+  c.out_shift_right = true;
+  c.pull_threshold = 32;
+  c.in_shift_right = true;
+  c.push_threshold = 32;
+  return c;
+}
+
+static inline void sm_config_set_wrap(pio_sm_config *c, uint wrap_target,
+                                      uint wrap) {
+  c->wrap_target = wrap_target;
+  c->wrap = wrap;
+}
+
+static inline void sm_config_set_sideset(pio_sm_config *c, uint bit_count,
+                                         bool optional, bool pindirs) {
+  (void)pindirs;
+  c->sideset_bits = bit_count;
+  c->sideset_opt = optional;
+}
+
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint base) {
+  c->sideset_base = base;
+}
+
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint base,
+                                          uint count) {
+  c->out_base = base;
+  c->out_count = count;
+}
+
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint base,
+                                          uint count) {
+  c->set_base = base;
+  c->set_count = count;
+}
+
+static inline void sm_config_set_in_pins(pio_sm_config *c, uint base) {
+  c->in_base = base;
+}
+
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right,
+                                           bool autopull, uint threshold) {
+  c->out_shift_right = shift_right;
+  c->autopull = autopull;
+  c->pull_threshold = threshold;
+}
+
+static inline void sm_config_set_in_shift(pio_sm_config *c, bool shift_right,
+                                          bool autopush, uint threshold) {
+  c->in_shift_right = shift_right;
+  c->autopush = autopush;
+  c->push_threshold = threshold;
+}
+
+static inline void sm_config_set_fifo_join(pio_sm_config *c,
+                                           enum pio_fifo_join join) {
+  c->fifo_join = join;
+}
+
+static inline void sm_config_set_clkdiv_int_frac8(pio_sm_config *c,
+                                                  uint32_t div_int,
+                                                  uint8_t div_frac) {
+  c->clkdiv_int = div_int;
+  c->clkdiv_frac = div_frac;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_gpio_init(PIO pio, uint pin);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *c);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_set_clkdiv_int_frac8(PIO pio, uint sm, uint32_t div_int,
+                                 uint8_t div_frac);
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base,
+                                    uint pin_count, bool is_out);
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values,
+                               uint32_t pin_mask);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+uint32_t pio_sm_get_blocking(PIO pio, uint sm);
+
+#endif
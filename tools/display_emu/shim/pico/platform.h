@@ -0,0 +1,15 @@
+#ifndef EMU_PICO_PLATFORM_H
+#define EMU_PICO_PLATFORM_H
+
+#include "pico/types.h"
+
+#define PICO_NO_HARDWARE 0
+#define __not_in_flash_func(f) f
+#define __time_critical_func(f) f
+
+// The emulator runs everything on one thread, standing in for core 0
+static inline uint get_core_num(void) { return 0; }
+static inline void tight_loop_contents(void) {}
+static inline uint __get_current_exception(void) { return 0; }
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef EMU_PICO_STDLIB_H
+#define EMU_PICO_STDLIB_H
+
+#include "hardware/gpio.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "pico/types.h"
+
+#endif
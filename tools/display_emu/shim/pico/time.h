@@ -0,0 +1,12 @@
+#ifndef EMU_PICO_TIME_H
+#define EMU_PICO_TIME_H
+
+#include "pico/types.h"
+
+// Simulated time: advances with PIO cycles on the bus and with sleeps
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef EMU_PICO_TYPES_H
+#define EMU_PICO_TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef volatile uint32_t io_rw_32;
+typedef volatile uint32_t io_wo_32;
+typedef volatile uint32_t io_ro_32;
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef EMU_RP_PICO_ALLOC_H
+#define EMU_RP_PICO_ALLOC_H
+
+#include <stdlib.h>
+
+// No PSRAM on the host: everything comes from the process heap, whatever
+// the hint
+typedef enum {
+  RP_MEM_FAST = 0,
+  RP_MEM_DMA,
+  RP_MEM_BULK,
+  RP_MEM_ANY,
+} rp_mem_hint_t;
+
+static inline void *rp_mem_malloc(size_t size) { return malloc(size); }
+static inline void *rp_mem_malloc_hint(size_t size, rp_mem_hint_t hint) {
+  (void)hint;
+  return malloc(size);
+}
+static inline void rp_mem_free(void *ptr) { free(ptr); }
+static inline void *rp_mem_realloc(void *ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+#endif
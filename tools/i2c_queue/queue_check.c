@@ -0,0 +1,450 @@
+// Host check of the I2C transaction queue (lib/Config/i2c_queue.c) on a
+// simulated bus. sim_port_t stands in for a port of i2c_dma.c: a submit
+// pushes the transaction and starts it if the bus was idle, and at the
+// simulated STOP the port retires it, starts the next one and only then runs
+// the callback, as i2c_dma_irq() does. Devices are register files with an
+// auto-incrementing pointer; an address nobody answers NAKs.
+//
+// It first walks the queue through its ordering and status rules by hand,
+// then runs SIM_MS of traffic shaped like the firmware's:
+//   touch   i2c0, 14-byte reads on a random interrupt; one arriving while
+//           the read is pending is re-armed from the callback (Touch.c)
+//   imu     i2c1, FIFO status read every 16 ms, the callback chains the
+//           data read
+//   rtc     i2c1, time read every 512 ms, landing on an IMU poll
+//   absent  i2c1, a write to an address without a device, now and then
+//   config  i2c1, blocking register write and read-back from the main loop,
+//           spinning like i2c_dma_transfer_blocking()
+// and checks that every accepted transaction completes exactly once, in
+// submit order per port, with the device's bytes or a NAK, that a pending
+// transaction is never accepted again, and that the bus is never idle with
+// work queued. The exit status is non-zero if a check fails.
+//
+//   cmake -S tools/i2c_queue -B build-i2c && cmake --build build-i2c
+//   ./build-i2c/queue_check [seed]
+
+#include "i2c_queue.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_MS 20000
+#define BAUD 400000
+#define ABRT_7B_ADDR_NOACK (1u << 0) // IC_TX_ABRT_SOURCE
+#define SCRATCH_REG 0x80             // config writes land from here up
+#define MAX_REPORTED 10
+
+typedef struct {
+  uint8_t addr;
+  uint8_t ptr;
+  uint8_t regs[256];
+} sim_dev_t;
+
+typedef struct {
+  const char *name;
+  i2c_queue_t q;
+  sim_dev_t *devs[4];
+  bool busy;
+  uint64_t stop_us;  // STOP of the active transaction
+  uint32_t seq_next; // submit order, checked against completion order
+  uint32_t seq_done;
+} sim_port_t;
+
+typedef struct client client_t;
+struct client {
+  const char *name;
+  sim_port_t *port;
+  i2c_txn_t txn;
+  uint8_t wr[2];
+  uint8_t rd[32];
+  void (*done)(client_t *c);
+  uint64_t next_us; // next self-initiated submit, 0 for none
+  bool rearm;
+  uint32_t seq;
+  uint32_t submitted, completed, errors, rejected;
+};
+
+static sim_dev_t m_touch = {.addr = 0x3B};
+static sim_dev_t m_imu = {.addr = 0x6B};
+static sim_dev_t m_rtc = {.addr = 0x51};
+static sim_port_t m_port[2] = {
+    {.name = "i2c0", .devs = {&m_touch}},
+    {.name = "i2c1", .devs = {&m_imu, &m_rtc}},
+};
+
+static uint64_t m_now_us;
+static bool m_stopping;
+static uint32_t m_rng = 1;
+static int m_failed;
+
+static void fail(const char *fmt, ...) {
+  if (m_failed++ >= MAX_REPORTED)
+    return;
+  va_list ap;
+  va_start(ap, fmt);
+  printf("  FAIL at %llu us: ", (unsigned long long)m_now_us);
+  vprintf(fmt, ap);
+  printf("\n");
+  va_end(ap);
+}
+
+static uint32_t rng(uint32_t n) {
+  m_rng ^= m_rng << 13;
+  m_rng ^= m_rng >> 17;
+  m_rng ^= m_rng << 5;
+  return m_rng % n;
+}
+
+// Register contents the devices power up with; only config writes change
+// them, above SCRATCH_REG
+static uint8_t reset_value(uint8_t addr, uint8_t reg) {
+  return (uint8_t)(addr * 7 + reg);
+}
+
+static sim_dev_t *sim_find(sim_port_t *p, uint8_t addr) {
+  for (int i = 0; i < 4 && p->devs[i]; i++) {
+    if (p->devs[i]->addr == addr)
+      return p->devs[i];
+  }
+  return NULL;
+}
+
+// Head ACTIVE and on the bus, the rest QUEUED, depth and tail consistent
+static void check_port(sim_port_t *p) {
+  uint16_t n = 0;
+  const i2c_txn_t *last = NULL;
+  for (const i2c_txn_t *t = p->q.head; t; t = t->next, n++) {
+    i2c_txn_status_t want = t == p->q.head ? I2C_TXN_ACTIVE : I2C_TXN_QUEUED;
+    if (t->status != want) {
+      fail("%s: txn %u in the queue has status %d", p->name, n, t->status);
+      return;
+    }
+    last = t;
+  }
+  if (n != p->q.depth || last != p->q.tail)
+    fail("%s: %u queued but depth %u", p->name, n, p->q.depth);
+  if (p->q.head && !p->busy)
+    fail("%s: bus idle with %u queued", p->name, n);
+}
+
+static uint32_t txn_us(sim_port_t *p, const i2c_txn_t *t) {
+  // START, address and 9 clocks a byte; a read after a write adds a
+  // repeated start and the address again. A NAK ends after the address.
+  uint32_t bytes = 1;
+  if (sim_find(p, t->addr)) {
+    bytes += t->wr_len + t->rd_len;
+    if (t->wr_len && t->rd_len)
+      bytes++;
+  }
+  return (bytes * 9 + 2) * 1000000u / BAUD;
+}
+
+static void sim_start(sim_port_t *p, i2c_txn_t *t) {
+  if (p->busy)
+    fail("%s: started addr 0x%02x on a busy bus", p->name, t->addr);
+  p->busy = true;
+  p->stop_us = m_now_us + txn_us(p, t);
+}
+
+static bool sim_submit(client_t *c) {
+  sim_port_t *p = c->port;
+  bool was_pending = i2c_txn_pending(&c->txn), start;
+
+  c->txn.user = c;
+  if (!i2c_queue_push(&p->q, &c->txn, &start)) {
+    if (!was_pending)
+      fail("%s: idle transaction refused", c->name);
+    c->rejected++;
+    return false;
+  }
+  if (was_pending)
+    fail("%s: pending transaction accepted twice", c->name);
+  c->seq = p->seq_next++;
+  c->submitted++;
+  if (start != !p->busy)
+    fail("%s: start %d with the bus %s", c->name, start,
+         p->busy ? "busy" : "idle");
+  if (start)
+    sim_start(p, &c->txn);
+  check_port(p);
+  return true;
+}
+
+// The I2C interrupt at STOP_DET
+static void sim_stop(sim_port_t *p) {
+  i2c_txn_t *t = i2c_queue_active(&p->q);
+  sim_dev_t *d = sim_find(p, t->addr);
+
+  p->busy = false;
+  if (d) {
+    uint16_t i = 0;
+    if (t->wr_len)
+      d->ptr = t->wr[i++];
+    for (; i < t->wr_len; i++)
+      d->regs[d->ptr++] = t->wr[i];
+    for (i = 0; i < t->rd_len; i++)
+      t->rd[i] = d->regs[d->ptr++];
+  }
+
+  i2c_txn_t *next = i2c_queue_complete(&p->q, d != NULL,
+                                       d ? 0 : ABRT_7B_ADDR_NOACK);
+  if (t->status != (d ? I2C_TXN_DONE : I2C_TXN_ERROR) || t->next ||
+      t->abort_source != (d ? 0 : ABRT_7B_ADDR_NOACK))
+    fail("%s: addr 0x%02x retired with status %d abort 0x%x", p->name,
+         t->addr, t->status, t->abort_source);
+  if (next)
+    sim_start(p, next);
+  check_port(p);
+  if (t->cb)
+    t->cb(t);
+}
+
+static void client_cb(i2c_txn_t *t) {
+  client_t *c = t->user;
+  sim_port_t *p = c->port;
+
+  if (c->seq != p->seq_done)
+    fail("%s: completed as #%u, submitted as #%u", c->name, p->seq_done,
+         c->seq);
+  p->seq_done = c->seq + 1;
+  c->completed++;
+  if (t->status == I2C_TXN_ERROR)
+    c->errors++;
+  else if (t->wr_len && t->wr[0] < SCRATCH_REG) {
+    for (uint16_t i = 0; i < t->rd_len; i++) {
+      if (t->rd[i] != reset_value(t->addr, (uint8_t)(t->wr[0] + i))) {
+        fail("%s: read 0x%02x at reg 0x%02x", c->name, t->rd[i],
+             t->wr[0] + i);
+        break;
+      }
+    }
+  }
+  if (c->done)
+    c->done(c);
+}
+
+static void client_init(client_t *c, const char *name, sim_port_t *p,
+                        uint8_t addr, uint8_t reg, uint16_t wr_len,
+                        uint16_t rd_len) {
+  memset(c, 0, sizeof(*c));
+  c->name = name;
+  c->port = p;
+  c->wr[0] = reg;
+  c->txn = (i2c_txn_t){
+      .addr = addr,
+      .wr = c->wr,
+      .wr_len = wr_len,
+      .rd = c->rd,
+      .rd_len = rd_len,
+      .cb = client_cb,
+  };
+}
+
+static client_t m_touch_rd, m_imu_stat, m_imu_data, m_rtc_rd, m_absent;
+
+static void touch_irq(client_t *c) {
+  if (!sim_submit(c))
+    c->rearm = true;
+  c->next_us = m_now_us + 200 + rng(3000);
+}
+
+static void touch_done(client_t *c) {
+  if (c->rearm) {
+    c->rearm = false;
+    sim_submit(c);
+  }
+}
+
+static void imu_stat_done(client_t *c) {
+  if (c->txn.status == I2C_TXN_DONE && !sim_submit(&m_imu_data))
+    fail("imu: data read still pending at the next status");
+}
+
+static void periodic(client_t *c) {
+  sim_submit(c);
+  if (c == &m_absent)
+    c->next_us = m_now_us + 10000 + rng(90000);
+  else
+    c->next_us += c == &m_imu_stat ? 16000 : 512000;
+}
+
+static client_t *const m_clients[] = {
+    &m_touch_rd, &m_imu_stat, &m_imu_data, &m_rtc_rd, &m_absent,
+};
+#define CLIENTS (sizeof(m_clients) / sizeof(m_clients[0]))
+
+// Advances to the next STOP or client event and handles it. Returns false
+// once there is nothing left to do.
+static bool sim_step(void) {
+  uint64_t t = UINT64_MAX;
+  for (int i = 0; i < 2; i++) {
+    if (m_port[i].busy && m_port[i].stop_us < t)
+      t = m_port[i].stop_us;
+  }
+  for (size_t i = 0; i < CLIENTS && !m_stopping; i++) {
+    if (m_clients[i]->next_us && m_clients[i]->next_us < t)
+      t = m_clients[i]->next_us;
+  }
+  if (t == UINT64_MAX)
+    return false;
+
+  m_now_us = t;
+  for (int i = 0; i < 2; i++) {
+    if (m_port[i].busy && m_port[i].stop_us == t)
+      sim_stop(&m_port[i]);
+  }
+  for (size_t i = 0; i < CLIENTS && !m_stopping; i++) {
+    client_t *c = m_clients[i];
+    if (c->next_us == t)
+      c == &m_touch_rd ? touch_irq(c) : periodic(c);
+  }
+  return true;
+}
+
+// i2c_dma_transfer_blocking() from the main loop, interrupts still running
+static bool sim_blocking(client_t *c) {
+  if (!sim_submit(c))
+    return false;
+  while (i2c_txn_pending(&c->txn)) {
+    if (!sim_step()) {
+      fail("%s: bus stalled", c->name);
+      return false;
+    }
+  }
+  return c->txn.status == I2C_TXN_DONE;
+}
+
+static void config_write(uint32_t *writes) {
+  client_t w, r;
+  uint8_t reg = (uint8_t)(SCRATCH_REG + rng(16));
+  uint8_t val = (uint8_t)rng(256);
+
+  client_init(&w, "config", &m_port[1], m_imu.addr, reg, 2, 0);
+  w.wr[1] = val;
+  client_init(&r, "config", &m_port[1], m_imu.addr, reg, 1, 1);
+  if (!sim_blocking(&w) || !sim_blocking(&r))
+    fail("config: transfer failed");
+  else if (r.rd[0] != val)
+    fail("config: wrote 0x%02x to 0x%02x, read back 0x%02x", val, reg,
+         r.rd[0]);
+  (*writes)++;
+}
+
+// The rules one at a time, as i2c_dma.c relies on them
+static void check_rules(void) {
+  i2c_queue_t q;
+  i2c_txn_t a = {.addr = 1}, b = {.addr = 2}, c = {.addr = 3};
+  bool start;
+
+  i2c_queue_init(&q);
+  if (!i2c_queue_push(&q, &a, &start) || !start)
+    fail("rules: first push did not start");
+  if (!i2c_queue_push(&q, &b, &start) || start)
+    fail("rules: second push started");
+  if (i2c_queue_push(&q, &b, &start) || start || q.depth != 2)
+    fail("rules: queued transaction accepted twice");
+  if (i2c_queue_push(&q, &a, &start) || q.depth != 2)
+    fail("rules: active transaction accepted twice");
+  i2c_queue_push(&q, &c, &start);
+  if (a.status != I2C_TXN_ACTIVE || b.status != I2C_TXN_QUEUED ||
+      c.status != I2C_TXN_QUEUED)
+    fail("rules: statuses %d %d %d after three pushes", a.status, b.status,
+         c.status);
+
+  if (i2c_queue_complete(&q, true, 0) != &b || a.status != I2C_TXN_DONE ||
+      b.status != I2C_TXN_ACTIVE)
+    fail("rules: completing the head did not promote the next");
+  if (i2c_queue_complete(&q, false, ABRT_7B_ADDR_NOACK) != &c ||
+      b.status != I2C_TXN_ERROR || b.abort_source != ABRT_7B_ADDR_NOACK)
+    fail("rules: a NAK was not recorded");
+  if (!i2c_queue_push(&q, &a, &start) || start || a.abort_source)
+    fail("rules: a retired transaction could not be queued again");
+  if (i2c_queue_complete(&q, true, 0) != &a ||
+      i2c_queue_complete(&q, true, 0) != NULL || q.head || q.tail)
+    fail("rules: queue not empty after the last completion");
+  if (i2c_queue_complete(&q, true, 0) != NULL)
+    fail("rules: completing on an idle bus returned a transaction");
+  if (!i2c_queue_push(&q, &b, &start) || !start)
+    fail("rules: push on the drained queue did not start");
+  if (q.submitted != 5 || q.completed != 4 || q.errors != 1 ||
+      q.max_depth != 3)
+    fail("rules: stats %u submitted %u completed %u errors max depth %u",
+         q.submitted, q.completed, q.errors, q.max_depth);
+}
+
+int main(int argc, char **argv) {
+  uint32_t writes = 0, errors = 0;
+
+  if (argc > 1)
+    m_rng = (uint32_t)strtoul(argv[1], NULL, 0) | 1;
+  printf("seed %u\n", m_rng);
+
+  check_rules();
+
+  for (int i = 0; i < 256; i++) {
+    m_touch.regs[i] = reset_value(m_touch.addr, (uint8_t)i);
+    m_imu.regs[i] = reset_value(m_imu.addr, (uint8_t)i);
+    m_rtc.regs[i] = reset_value(m_rtc.addr, (uint8_t)i);
+  }
+  for (int i = 0; i < 2; i++)
+    i2c_queue_init(&m_port[i].q);
+  client_init(&m_touch_rd, "touch", &m_port[0], m_touch.addr, 0x01, 1, 14);
+  client_init(&m_imu_stat, "imu status", &m_port[1], m_imu.addr, 0x15, 1, 2);
+  client_init(&m_imu_data, "imu data", &m_port[1], m_imu.addr, 0x49, 1, 24);
+  client_init(&m_rtc_rd, "rtc", &m_port[1], m_rtc.addr, 0x04, 1, 7);
+  client_init(&m_absent, "absent", &m_port[1], 0x50, 0x00, 1, 0);
+  m_touch_rd.done = touch_done;
+  m_imu_stat.done = imu_stat_done;
+  m_touch_rd.next_us = 100;
+  m_imu_stat.next_us = 16000;
+  m_rtc_rd.next_us = 256000;
+  m_absent.next_us = 40000;
+
+  uint64_t next_config = 100000;
+  while (m_now_us < SIM_MS * 1000ull) {
+    if (m_now_us >= next_config) {
+      config_write(&writes);
+      next_config = m_now_us + 50000 + rng(1000000);
+    } else {
+      sim_step();
+    }
+  }
+  m_stopping = true;
+  while (sim_step())
+    ;
+
+  printf("%-12s %9s %9s %9s %9s\n", "client", "submitted", "completed",
+         "errors", "refused");
+  for (size_t i = 0; i < CLIENTS; i++) {
+    client_t *c = m_clients[i];
+    printf("%-12s %9u %9u %9u %9u\n", c->name, c->submitted, c->completed,
+           c->errors, c->rejected);
+    if (c->completed != c->submitted)
+      fail("%s: %u submitted, %u completed", c->name, c->submitted,
+           c->completed);
+    if (c != &m_absent && c->errors)
+      fail("%s: %u errors", c->name, c->errors);
+    errors += c->errors;
+  }
+  printf("config       %9u blocking write / read-back pairs\n", writes);
+  if (m_absent.errors != m_absent.submitted)
+    fail("absent: %u of %u writes NAKed", m_absent.errors,
+         m_absent.submitted);
+
+  for (int i = 0; i < 2; i++) {
+    sim_port_t *p = &m_port[i];
+    printf("%s: %u submitted, %u errors, max depth %u\n", p->name,
+           p->q.submitted, p->q.errors, p->q.max_depth);
+    if (p->q.head || p->q.depth || p->busy ||
+        p->q.completed != p->q.submitted || p->seq_done != p->seq_next)
+      fail("%s: not drained, depth %u, %u of %u completed", p->name,
+           p->q.depth, p->q.completed, p->q.submitted);
+  }
+  if (m_port[0].q.errors + m_port[1].q.errors != errors)
+    fail("queue counted %u errors, clients saw %u",
+         m_port[0].q.errors + m_port[1].q.errors, errors);
+
+  printf(m_failed ? "%d checks failed\n" : "passed\n", m_failed);
+  return m_failed != 0;
+}
@@ -0,0 +1,184 @@
+// Host benchmark of LVGL's heap: alloc/free/realloc throughput for LVGL's
+// usual size mix, through
+//   lv_mem_rp - examples/src/lv_mem_rp.c, SRAM sub-pool spilling to rp_mem
+//   tlsf_32k  - one 32 KB TLSF pool, as the built-in LV_MEM_SIZE heap was
+//   malloc    - the host's, for scale
+// Each round builds a screen's worth of blocks, churns them the way a
+// redraw does (draw scratch buffers, label text, style lists) and frees
+// them all again, like a screen change. Figures are host time; only the
+// ratios and the sub-pool counters carry over to the RP2350.
+//
+//   cmake -S tools/mem_bench -B build-bench && cmake --build build-bench
+//   ./build-bench/mem_bench [rounds]
+
+#include "lv_mem_rp.h"
+#include "rp_pico_alloc.h"
+#include "tlsf/tlsf.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LIVE 2048
+#define CHURN_OPS 20000
+#define BULK_SIZE (8u << 20)
+#define SMALL_POOL (32u * 1024u)
+
+tlsf_t bench_bulk;
+static uint8_t m_bulk_mem[BULK_SIZE] __attribute__((aligned(8)));
+static uint8_t m_small_mem[SMALL_POOL] __attribute__((aligned(8)));
+static tlsf_t m_small;
+static size_t m_small_used, m_small_peak;
+
+typedef struct {
+  const char *name;
+  void *(*alloc)(size_t size);
+  void (*free)(void *ptr);
+  void *(*realloc)(void *ptr, size_t size);
+} heap_t;
+
+static void *tlsf32_alloc(size_t size) {
+  void *p = tlsf_malloc(m_small, size);
+  if (p && (m_small_used += tlsf_block_size(p)) > m_small_peak)
+    m_small_peak = m_small_used;
+  return p;
+}
+
+static void tlsf32_free(void *ptr) {
+  m_small_used -= tlsf_block_size(ptr);
+  tlsf_free(m_small, ptr);
+}
+
+static void *tlsf32_realloc(void *ptr, size_t size) {
+  size_t old = tlsf_block_size(ptr);
+  void *p = tlsf_realloc(m_small, ptr, size);
+  if (p && (m_small_used += tlsf_block_size(p) - old) > m_small_peak)
+    m_small_peak = m_small_used;
+  return p;
+}
+
+static const heap_t m_heaps[] = {
+    {"lv_mem_rp", lv_mem_rp_alloc, lv_mem_rp_free, lv_mem_rp_realloc},
+    {"tlsf_32k", tlsf32_alloc, tlsf32_free, tlsf32_realloc},
+    {"malloc", malloc, free, realloc},
+};
+
+static uint32_t m_rng;
+
+static uint32_t rnd(void) {
+  m_rng ^= m_rng << 13;
+  m_rng ^= m_rng >> 17;
+  m_rng ^= m_rng << 5;
+  return m_rng;
+}
+
+static uint32_t rnd_range(uint32_t lo, uint32_t hi) {
+  return lo + rnd() % (hi - lo + 1);
+}
+
+// LVGL 8 on this UI: style property lists and event descriptors, objects
+// and widget structs, label text and spec attributes, draw scratch buffers
+// a line or two wide, and the odd image or long text
+static size_t lvgl_size(void) {
+  uint32_t r = rnd() % 100;
+
+  if (r < 40)
+    return rnd_range(8, 32);
+  if (r < 70)
+    return rnd_range(33, 128);
+  if (r < 90)
+    return rnd_range(129, 512);
+  if (r < 98)
+    return rnd_range(513, 2048);
+  return rnd_range(2049, 16384);
+}
+
+typedef struct {
+  uint64_t ops;
+  uint64_t ns;
+  uint32_t failed;
+} run_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void run(const heap_t *h, int rounds, run_t *out) {
+  static void *live[MAX_LIVE];
+  int n = 0;
+
+  memset(out, 0, sizeof(*out));
+  m_rng = 0x2545f491;
+  uint64_t t0 = now_ns();
+  for (int r = 0; r < rounds; r++) {
+    // Build a screen
+    int target = rnd_range(200, 800);
+    while (n < target) {
+      void *p = h->alloc(lvgl_size());
+      out->ops++;
+      if (!p) {
+        out->failed++;
+        break;
+      }
+      live[n++] = p;
+    }
+    // Redraws: scratch buffers come and go, text changes size
+    for (int i = 0; i < CHURN_OPS && n; i++) {
+      int k = rnd() % n;
+      uint32_t op = rnd() % 100;
+      out->ops++;
+      if (op < 10) {
+        void *p = h->realloc(live[k], lvgl_size());
+        if (p)
+          live[k] = p;
+        else
+          out->failed++;
+      } else if (op < 55 && n < MAX_LIVE) {
+        void *p = h->alloc(lvgl_size());
+        if (p)
+          live[n++] = p;
+        else
+          out->failed++;
+      } else {
+        h->free(live[k]);
+        live[k] = live[--n];
+      }
+    }
+    // Screen change
+    while (n) {
+      h->free(live[--n]);
+      out->ops++;
+    }
+  }
+  out->ns = now_ns() - t0;
+}
+
+int main(int argc, char **argv) {
+  int rounds = argc > 1 ? atoi(argv[1]) : 50;
+  run_t res;
+
+  bench_bulk = tlsf_create_with_pool(m_bulk_mem, sizeof(m_bulk_mem),
+                                     sizeof(m_bulk_mem));
+  m_small = tlsf_create_with_pool(m_small_mem, sizeof(m_small_mem),
+                                  sizeof(m_small_mem));
+
+  printf("%d rounds, size mix 40%% <=32 B, 30%% <=128 B, 20%% <=512 B, "
+         "8%% <=2 KB, 2%% <=16 KB\n", rounds);
+  for (unsigned i = 0; i < sizeof(m_heaps) / sizeof(m_heaps[0]); i++) {
+    run(&m_heaps[i], rounds, &res);
+    printf("%-10s %9llu ops %7.1f ns/op %7u failed\n", m_heaps[i].name,
+           (unsigned long long)res.ops, (double)res.ns / res.ops, res.failed);
+  }
+
+  lv_mem_rp_stats_t s;
+  lv_mem_rp_get_stats(&s);
+  printf("lv_mem_rp: sub-pool %zu B, peak %zu B, %u%% fragmented now; "
+         "%u spills, %u bulk, peak %u bulk blocks live\n",
+         s.pool_size, s.pool_peak, s.pool_frag_pct, s.spills, s.bulk,
+         s.bulk_peak);
+  printf("tlsf_32k: peak %zu B of %u\n", m_small_peak, SMALL_POOL);
+  return 0;
+}
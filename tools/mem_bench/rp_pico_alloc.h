@@ -0,0 +1,27 @@
+#ifndef BENCH_RP_PICO_ALLOC_H
+#define BENCH_RP_PICO_ALLOC_H
+
+#include "tlsf/tlsf.h"
+#include <stddef.h>
+
+// rp_mem on the host: one TLSF heap over a plain array standing in for
+// PSRAM, so spills cost what the firmware's TLSF would, minus the bus
+typedef enum {
+  RP_MEM_FAST = 0,
+  RP_MEM_DMA,
+  RP_MEM_BULK,
+  RP_MEM_ANY,
+} rp_mem_hint_t;
+
+extern tlsf_t bench_bulk;
+
+static inline void *rp_mem_malloc_hint(size_t size, rp_mem_hint_t hint) {
+  (void)hint;
+  return tlsf_malloc(bench_bulk, size);
+}
+static inline void rp_mem_free(void *ptr) { tlsf_free(bench_bulk, ptr); }
+static inline void *rp_mem_realloc(void *ptr, size_t size) {
+  return tlsf_realloc(bench_bulk, ptr, size);
+}
+
+#endif
@@ -0,0 +1,141 @@
+// Accuracy of the Q30 Mahony filter (lib/Motion/imu_fusion.c) against its
+// float reference imu_fusion_ref_*() on IMU traces. Both run with the gains
+// motion_init() uses, sample by sample, and for each trace the tool reports
+//   ref   angle between the two attitudes (the fixed-point error)
+//   tilt  angle between the filter's gravity and the true one, after the
+//         first second, for synthesised traces (the filter's own error)
+// The exit status is non-zero if the fixed-point filter is ever more than
+// REF_TOL_DEG from the reference.
+//
+//   cmake -S tools/motion_replay -B build-motion && cmake --build build-motion
+//   ./build-motion/fusion_check [--dump DIR] [script.txt | capture.csv]...
+//
+// Without arguments it runs tools/motion_replay/traces.txt (see trace.h).
+// --dump writes every trace it runs to DIR as CSV, the format a capture
+// from the board is replayed in.
+
+#include "imu_fusion.h"
+#include "trace.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define REF_TOL_DEG 0.1
+#define SETTLE_S 1
+
+#define RAD2DEG (180.0 / 3.14159265358979323846)
+
+typedef struct {
+  double max, sum2;
+  uint32_t n;
+} err_t;
+
+static void err_add(err_t *e, double v) {
+  if (v > e->max)
+    e->max = v;
+  e->sum2 += v * v;
+  e->n++;
+}
+
+static double err_rms(const err_t *e) {
+  return e->n ? sqrt(e->sum2 / e->n) : 0;
+}
+
+// Rotation between two attitudes, degrees
+static double q_angle(const double a[4], const double b[4]) {
+  double w = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+  double x = a[0] * b[1] - a[1] * b[0] - a[2] * b[3] + a[3] * b[2];
+  double y = a[0] * b[2] + a[1] * b[3] - a[2] * b[0] - a[3] * b[1];
+  double z = a[0] * b[3] - a[1] * b[2] + a[2] * b[1] - a[3] * b[0];
+  return 2 * atan2(sqrt(x * x + y * y + z * z), fabs(w)) * RAD2DEG;
+}
+
+// World z in the sensor frame, as imu_fusion_gravity()
+static void q_gravity(const double q[4], double g[3]) {
+  g[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+  g[1] = 2 * (q[0] * q[1] + q[2] * q[3]);
+  g[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+}
+
+static double v_angle(const double a[3], const double b[3]) {
+  double c[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+                 a[0] * b[1] - a[1] * b[0]};
+  double d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+  return atan2(sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]), d) * RAD2DEG;
+}
+
+static bool run(const trace_t *t, void *ctx) {
+  imu_fusion_config_t cfg = {
+      .kp = 2.0f,
+      .ki = 0.05f,
+      .odr_hz = t->odr_hz,
+      .acc_lsb = t->acc_lsb,
+      .gyro_lsb = t->gyro_lsb,
+  };
+  imu_fusion_t f;
+  imu_fusion_ref_t r;
+  err_t ref = {0}, tilt = {0}, tilt_ref = {0};
+
+  (void)ctx;
+  imu_fusion_init(&f, &cfg);
+  imu_fusion_ref_init(&r, &cfg);
+  for (uint32_t i = 0; i < t->count; i++) {
+    double qf[4], qr[4], truth[4], gf[3], gr[3], gt[3];
+
+    imu_fusion_update(&f, t->acc[i], t->gyro[i]);
+    imu_fusion_ref_update(&r, t->acc[i], t->gyro[i]);
+    for (int k = 0; k < 4; k++) {
+      qf[k] = (double)f.q[k] / IMU_FUSION_ONE;
+      qr[k] = r.q[k];
+    }
+    err_add(&ref, q_angle(qf, qr));
+
+    if (!t->truth || i < SETTLE_S * t->odr_hz)
+      continue;
+    for (int k = 0; k < 4; k++)
+      truth[k] = t->truth[i][k];
+    q_gravity(qf, gf);
+    q_gravity(qr, gr);
+    q_gravity(truth, gt);
+    err_add(&tilt, v_angle(gf, gt));
+    err_add(&tilt_ref, v_angle(gr, gt));
+  }
+
+  printf("%-18s %6.1f s  ref %6.3f max %6.3f rms", t->name,
+         (double)t->count / t->odr_hz, ref.max, err_rms(&ref));
+  if (t->truth)
+    printf("  tilt %5.2f max %5.2f rms (float %5.2f / %5.2f)", tilt.max,
+           err_rms(&tilt), tilt_ref.max, err_rms(&tilt_ref));
+  printf("\n");
+  if (ref.max > REF_TOL_DEG) {
+    printf("  FAIL %s: %.3f deg from the float reference, limit %.1f\n",
+           t->name, ref.max, REF_TOL_DEG);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *dump = NULL;
+  int failed = 0, files = 0, rc;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--dump") && i + 1 < argc) {
+      dump = argv[++i];
+      continue;
+    }
+    if ((rc = trace_run_file(argv[i], dump, run, NULL)) < 0)
+      return 2;
+    failed += rc;
+    files++;
+  }
+  if (!files) {
+    if ((rc = trace_run_file(MOTION_REPLAY_DIR "/traces.txt", dump, run,
+                             NULL)) < 0)
+      return 2;
+    failed += rc;
+  }
+
+  printf(failed ? "%d traces failed\n" : "passed\n", failed);
+  return failed != 0;
+}
@@ -0,0 +1,211 @@
+// Gesture classifier (lib/Motion/motion_gesture.c) against the labelled
+// traces in traces.txt, or captures given on the command line. Each trace
+// goes through the same steps as motion_task(): batches of --batch samples
+// (MOTION_WATERMARK, 16, by default) are fused, reduced to a feature frame
+// and pushed to the classifier. After MOTION_SLEEP_MS still the IMU
+// "sleeps": samples are dropped until one moves more than the
+// wake-on-motion threshold, then the classifier restarts as on a wake.
+//
+// Before the traces it checks one feature frame at the edge of the range:
+// a full batch (MOTION_BATCH_MAX) pinned at +8 g on every axis.
+//
+// The labels a trace expects, in order, are shake, flip, tilt_left,
+// tilt_right and sleep; a trace without any expects none. The tool prints
+// what each trace produced and when, and per label the expected, detected
+// and matched counts. The exit status is non-zero if any trace produced
+// something other than its labels.
+//
+//   cmake -S tools/motion_replay -B build-motion && cmake --build build-motion
+//   ./build-motion/gesture_check [--batch N] [--dump DIR] [script | csv]...
+
+#include "motion.h"
+#include "trace.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WATERMARK 16 // MOTION_WATERMARK in motion.c
+#define BATCH_MAX 64 // MOTION_BATCH_MAX in motion.c
+#define WOM_MG 32    // QMI8658WomThreshold_low
+#define MAX_EVENTS 32
+
+#define LABEL_SLEEP MOTION_GESTURE_COUNT
+#define LABELS (MOTION_GESTURE_COUNT + 1)
+
+static const char *const m_labels[LABELS] = {
+    "none", "shake", "flip", "tilt_left", "tilt_right", "sleep",
+};
+
+typedef struct {
+  uint32_t batch;
+  uint32_t expected[LABELS];
+  uint32_t detected[LABELS];
+  uint32_t matched[LABELS];
+} totals_t;
+
+typedef struct {
+  uint8_t label;
+  uint32_t t_ms;
+} event_t;
+
+// Expected labels; -1 on an unknown one
+static int parse_expect(const char *s, uint8_t *out) {
+  char buf[TRACE_EXPECT_LEN];
+  int n = 0;
+
+  snprintf(buf, sizeof(buf), "%s", s);
+  for (char *tok = strtok(buf, " \t,"); tok; tok = strtok(NULL, " \t,")) {
+    int l = 1;
+    while (l < LABELS && strcmp(tok, m_labels[l]))
+      l++;
+    if (l == LABELS || n == MAX_EVENTS) {
+      printf("  unknown label '%s'\n", tok);
+      return -1;
+    }
+    out[n++] = (uint8_t)l;
+  }
+  return n;
+}
+
+static bool moved(const trace_t *t, uint32_t i, const int16_t ref[3]) {
+  for (int k = 0; k < 3; k++) {
+    if (abs(t->acc[i][k] - ref[k]) * 1000 / t->acc_lsb > WOM_MG)
+      return true;
+  }
+  return false;
+}
+
+static bool run(const trace_t *t, void *ctx) {
+  totals_t *tot = ctx;
+  imu_fusion_config_t cfg = {
+      .kp = 2.0f,
+      .ki = 0.05f,
+      .odr_hz = t->odr_hz,
+      .acc_lsb = t->acc_lsb,
+      .gyro_lsb = t->gyro_lsb,
+  };
+  uint16_t frame_ms = (uint16_t)(tot->batch * 1000 / t->odr_hz);
+  imu_fusion_t f;
+  motion_gesture_state_t g;
+  event_t ev[MAX_EVENTS];
+  uint8_t want[MAX_EVENTS];
+  int n_ev = 0, n_want = parse_expect(t->expect, want);
+  bool sleeping = false;
+  int16_t wom_ref[3] = {0, 0, 0};
+
+  imu_fusion_init(&f, &cfg);
+  motion_gesture_init(&g, frame_ms);
+  for (uint32_t i = 0; i < t->count;) {
+    if (sleeping) {
+      if (moved(t, i, wom_ref)) {
+        sleeping = false;
+        motion_gesture_init(&g, frame_ms);
+      }
+      i++;
+      continue;
+    }
+
+    uint32_t n = t->count - i < tot->batch ? t->count - i : tot->batch;
+    int32_t gravity[3];
+    motion_frame_t frame;
+    imu_fusion_update_batch(&f, &t->acc[i], &t->gyro[i], n);
+    imu_fusion_gravity(&f, gravity);
+    motion_gesture_frame(&frame, &t->acc[i], &t->gyro[i], n, t->acc_lsb,
+                         t->gyro_lsb, gravity);
+    motion_gesture_t gest = motion_gesture_push(&g, &frame);
+    i += n;
+
+    uint32_t t_ms = (uint32_t)((uint64_t)i * 1000 / t->odr_hz);
+    if (gest != MOTION_GESTURE_NONE && n_ev < MAX_EVENTS)
+      ev[n_ev++] = (event_t){(uint8_t)gest, t_ms};
+    if (motion_gesture_still_ms(&g) >= MOTION_SLEEP_MS) {
+      if (n_ev < MAX_EVENTS)
+        ev[n_ev++] = (event_t){LABEL_SLEEP, t_ms};
+      memcpy(wom_ref, t->acc[i - 1], sizeof(wom_ref));
+      sleeping = true;
+    }
+  }
+
+  bool ok = n_want == n_ev;
+  printf("%-18s", t->name);
+  for (int k = 0; k < n_ev; k++) {
+    printf(" %s@%u", m_labels[ev[k].label], ev[k].t_ms);
+    if (k >= n_want || ev[k].label != want[k])
+      ok = false;
+  }
+  if (!n_ev)
+    printf(" -");
+  if (n_want < 0) {
+    ok = false;
+  } else {
+    uint32_t e[LABELS] = {0}, d[LABELS] = {0};
+    for (int k = 0; k < n_want; k++)
+      e[want[k]]++;
+    for (int k = 0; k < n_ev; k++)
+      d[ev[k].label]++;
+    for (int l = 1; l < LABELS; l++) {
+      tot->expected[l] += e[l];
+      tot->detected[l] += d[l];
+      tot->matched[l] += e[l] < d[l] ? e[l] : d[l];
+    }
+  }
+  if (ok)
+    printf("\n");
+  else
+    printf("   FAIL, expected %s\n", t->expect[0] ? t->expect : "-");
+  return ok;
+}
+
+// |a| - 1 g of a batch stuck at full scale must not wrap the RMS
+static bool check_full_scale(void) {
+  static int16_t acc[BATCH_MAX][3], gyro[BATCH_MAX][3];
+  const int32_t up[3] = {0, 0, 1 << 30};
+  const uint16_t acc_lsb = 4096;
+  motion_frame_t frame;
+
+  for (int i = 0; i < BATCH_MAX; i++)
+    acc[i][0] = acc[i][1] = acc[i][2] = 32767;
+  motion_gesture_frame(&frame, acc, gyro, BATCH_MAX, acc_lsb, 64, up);
+  double a = 32767 * 1000 / acc_lsb;
+  int want = (int)(sqrt(3 * a * a) - 1000);
+  printf("full scale batch   dyn_rms %u mg, expected %d\n", frame.dyn_rms,
+         want);
+  return abs(frame.dyn_rms - want) <= 2;
+}
+
+int main(int argc, char **argv) {
+  totals_t tot = {.batch = WATERMARK};
+  const char *dump = NULL;
+  int failed = !check_full_scale(), files = 0, rc;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--batch") && i + 1 < argc) {
+      tot.batch = (uint32_t)atoi(argv[++i]);
+      if (tot.batch == 0)
+        tot.batch = 1;
+      continue;
+    }
+    if (!strcmp(argv[i], "--dump") && i + 1 < argc) {
+      dump = argv[++i];
+      continue;
+    }
+    if ((rc = trace_run_file(argv[i], dump, run, &tot)) < 0)
+      return 2;
+    failed += rc;
+    files++;
+  }
+  if (!files) {
+    if ((rc = trace_run_file(MOTION_REPLAY_DIR "/traces.txt", dump, run,
+                             &tot)) < 0)
+      return 2;
+    failed += rc;
+  }
+
+  printf("\n%-12s %8s %8s %8s\n", "label", "expected", "detected", "matched");
+  for (int l = 1; l < LABELS; l++)
+    printf("%-12s %8u %8u %8u\n", m_labels[l], tot.expected[l],
+           tot.detected[l], tot.matched[l]);
+  printf(failed ? "%d checks failed\n" : "passed\n", failed);
+  return failed != 0;
+}
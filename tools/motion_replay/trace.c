@@ -0,0 +1,422 @@
+#include "trace.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// As QMI8658_init() configures the IMU: 1 kHz, +-8 g, +-512 dps
+#define SYNTH_ODR_HZ 1000
+#define SYNTH_ACC_LSB 4096
+#define SYNTH_GYRO_LSB 64
+
+// QMI8658 noise densities (150 ug/rtHz, 15 mdps/rtHz) over ~500 Hz
+#define SYNTH_ACC_NOISE_MG 3.0
+#define SYNTH_GYRO_NOISE_DPS 0.3
+
+#define DEG2RAD (3.14159265358979323846 / 180.0)
+#define PI 3.14159265358979323846
+
+static bool push(trace_t *t, const int16_t acc[3], const int16_t gyro[3],
+                 const double *truth) {
+  if (t->count == t->cap) {
+    uint32_t cap = t->cap ? t->cap * 2 : 4096;
+    void *a = realloc(t->acc, cap * sizeof(t->acc[0]));
+    void *g = a ? realloc(t->gyro, cap * sizeof(t->gyro[0])) : NULL;
+    void *q = NULL;
+    if (a)
+      t->acc = a;
+    if (g)
+      t->gyro = g;
+    if (g && truth)
+      q = realloc(t->truth, cap * sizeof(t->truth[0]));
+    if (!a || !g || (truth && !q)) {
+      fprintf(stderr, "%s: out of memory\n", t->name);
+      return false;
+    }
+    if (truth)
+      t->truth = q;
+    t->cap = cap;
+  }
+  memcpy(t->acc[t->count], acc, sizeof(t->acc[0]));
+  memcpy(t->gyro[t->count], gyro, sizeof(t->gyro[0]));
+  if (truth) {
+    for (int i = 0; i < 4; i++)
+      t->truth[t->count][i] = (float)truth[i];
+  }
+  t->count++;
+  return true;
+}
+
+void trace_free(trace_t *t) {
+  free(t->acc);
+  free(t->gyro);
+  free(t->truth);
+  memset(t, 0, sizeof(*t));
+}
+
+//--------------------------------------------------------------------+
+// CSV
+//--------------------------------------------------------------------+
+static void parse_header(trace_t *t, const char *line) {
+  const char *p;
+
+  if ((p = strstr(line, "odr_hz=")))
+    t->odr_hz = (uint32_t)strtoul(p + 7, NULL, 10);
+  if ((p = strstr(line, "acc_lsb=")))
+    t->acc_lsb = (uint16_t)strtoul(p + 8, NULL, 10);
+  if ((p = strstr(line, "gyro_lsb=")))
+    t->gyro_lsb = (uint16_t)strtoul(p + 9, NULL, 10);
+  if ((p = strstr(line, "expect="))) {
+    snprintf(t->expect, sizeof(t->expect), "%s", p + 7);
+    t->expect[strcspn(t->expect, "\r\n")] = 0;
+  }
+}
+
+bool trace_load_csv(trace_t *t, const char *path) {
+  FILE *f = fopen(path, "r");
+  char line[256];
+
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  memset(t, 0, sizeof(*t));
+  const char *base = strrchr(path, '/');
+  snprintf(t->name, sizeof(t->name), "%s", base ? base + 1 : path);
+  t->name[strcspn(t->name, ".")] = 0;
+
+  while (fgets(line, sizeof(line), f)) {
+    int v[6];
+    if (line[0] == '#') {
+      parse_header(t, line);
+      continue;
+    }
+    if (sscanf(line, "%d,%d,%d,%d,%d,%d", &v[0], &v[1], &v[2], &v[3], &v[4],
+               &v[5]) != 6)
+      continue; // column names, blank lines
+    int16_t acc[3] = {(int16_t)v[0], (int16_t)v[1], (int16_t)v[2]};
+    int16_t gyro[3] = {(int16_t)v[3], (int16_t)v[4], (int16_t)v[5]};
+    if (!push(t, acc, gyro, NULL)) {
+      fclose(f);
+      return false;
+    }
+  }
+  fclose(f);
+  if (!t->odr_hz || !t->acc_lsb || !t->gyro_lsb) {
+    fprintf(stderr, "%s: no odr_hz / acc_lsb / gyro_lsb header\n", path);
+    return false;
+  }
+  return true;
+}
+
+bool trace_save_csv(const trace_t *t, const char *path) {
+  FILE *f = fopen(path, "w");
+
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  fprintf(f, "# odr_hz=%u acc_lsb=%u gyro_lsb=%u\n", t->odr_hz, t->acc_lsb,
+          t->gyro_lsb);
+  if (t->expect[0])
+    fprintf(f, "# expect=%s\n", t->expect);
+  fprintf(f, "ax,ay,az,gx,gy,gz\n");
+  for (uint32_t i = 0; i < t->count; i++)
+    fprintf(f, "%d,%d,%d,%d,%d,%d\n", t->acc[i][0], t->acc[i][1],
+            t->acc[i][2], t->gyro[i][0], t->gyro[i][1], t->gyro[i][2]);
+  return fclose(f) == 0;
+}
+
+//--------------------------------------------------------------------+
+// Synthesis
+//--------------------------------------------------------------------+
+typedef struct {
+  trace_t *t;
+  double q[4];      // sensor -> world, w x y z
+  double bias[3];   // dps
+  double acc_noise; // g
+  double gyro_noise; // dps
+  uint32_t rng;
+} synth_t;
+
+static void qmul(const double a[4], const double b[4], double out[4]) {
+  double r[4] = {
+      a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3],
+      a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2],
+      a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1],
+      a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0],
+  };
+  memcpy(out, r, sizeof(r));
+}
+
+static void qnorm(double q[4]) {
+  double n = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  for (int i = 0; i < 4; i++)
+    q[i] /= n;
+}
+
+static void qaxis(int axis, double rad, double q[4]) {
+  memset(q, 0, 4 * sizeof(double));
+  q[0] = cos(rad / 2);
+  q[1 + axis] = sin(rad / 2);
+}
+
+// Roll about x, then pitch about y, then yaw about z
+static void qeuler(double roll, double pitch, double yaw, double q[4]) {
+  double qx[4], qy[4], qz[4];
+  qaxis(0, roll * DEG2RAD, qx);
+  qaxis(1, pitch * DEG2RAD, qy);
+  qaxis(2, yaw * DEG2RAD, qz);
+  qmul(qz, qy, q);
+  qmul(q, qx, q);
+}
+
+static void qslerp(const double a[4], const double b[4], double s,
+                   double out[4]) {
+  double d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+  double sign = d < 0 ? -1 : 1;
+  d *= sign;
+  if (d > 0.9995) {
+    for (int i = 0; i < 4; i++)
+      out[i] = a[i] + s * (sign * b[i] - a[i]);
+  } else {
+    double th = acos(d);
+    double wa = sin((1 - s) * th) / sin(th), wb = sign * sin(s * th) / sin(th);
+    for (int i = 0; i < 4; i++)
+      out[i] = wa * a[i] + wb * b[i];
+  }
+  qnorm(out);
+}
+
+// World vector in the sensor frame
+static void to_sensor(const double q[4], const double v[3], double out[3]) {
+  double qc[4] = {q[0], -q[1], -q[2], -q[3]};
+  double p[4] = {0, v[0], v[1], v[2]};
+  qmul(qc, p, p);
+  qmul(p, q, p);
+  memcpy(out, &p[1], 3 * sizeof(double));
+}
+
+static double gauss(synth_t *s) {
+  double u[2];
+  for (int i = 0; i < 2; i++) {
+    s->rng ^= s->rng << 13;
+    s->rng ^= s->rng >> 17;
+    s->rng ^= s->rng << 5;
+    u[i] = (s->rng + 1.0) / 4294967297.0;
+  }
+  return sqrt(-2 * log(u[0])) * cos(2 * PI * u[1]);
+}
+
+static int16_t counts(double v, double lsb) {
+  double c = round(v * lsb);
+  return (int16_t)(c > 32767 ? 32767 : c < -32768 ? -32768 : c);
+}
+
+// One FIFO sample: the sensor moves from s->q to q_next over the period
+// while accelerating by lin (g, sensor frame) on top of gravity
+static bool emit(synth_t *s, const double q_next[4], const double lin[3]) {
+  const double up[3] = {0, 0, 1};
+  double dq[4], g[3];
+  double qc[4] = {s->q[0], -s->q[1], -s->q[2], -s->q[3]};
+  int16_t acc[3], gyro[3];
+
+  qmul(qc, q_next, dq);
+  if (dq[0] < 0) {
+    for (int i = 0; i < 4; i++)
+      dq[i] = -dq[i];
+  }
+  double vn = sqrt(dq[1] * dq[1] + dq[2] * dq[2] + dq[3] * dq[3]);
+  double rate = vn > 0 ? 2 * atan2(vn, dq[0]) * s->t->odr_hz / vn / DEG2RAD
+                       : 0; // dps per unit of dq's vector part
+
+  to_sensor(q_next, up, g);
+  for (int i = 0; i < 3; i++) {
+    acc[i] = counts(g[i] + lin[i] + s->acc_noise * gauss(s), s->t->acc_lsb);
+    gyro[i] = counts(dq[1 + i] * rate + s->bias[i] + s->gyro_noise * gauss(s),
+                     s->t->gyro_lsb);
+  }
+  memcpy(s->q, q_next, sizeof(s->q));
+  return push(s->t, acc, gyro, q_next);
+}
+
+static int axis_of(const char *a) {
+  return a[0] == 'x' ? 0 : a[0] == 'y' ? 1 : a[0] == 'z' ? 2 : -1;
+}
+
+static uint32_t seed_of(const char *name) {
+  uint32_t h = 2166136261u;
+  while (*name)
+    h = (h ^ (uint8_t)*name++) * 16777619u;
+  return h ? h : 1;
+}
+
+static bool step(synth_t *s, const char *line) {
+  char op[16], ax[4];
+  double ms, a = 0, b = 0, c = 0;
+  double dt = 1.0 / s->t->odr_hz;
+  const double zero[3] = {0, 0, 0};
+
+  if (sscanf(line, "%15s", op) != 1)
+    return true;
+  if (!strcmp(op, "expect")) {
+    const char *p = line + strspn(line, " \t") + 6;
+    snprintf(s->t->expect, sizeof(s->t->expect), "%s", p + strspn(p, " \t"));
+    s->t->expect[strcspn(s->t->expect, "#\r\n")] = 0;
+    return true;
+  }
+  if (!strcmp(op, "noise")) {
+    if (sscanf(line, "%*s %lf %lf", &a, &b) != 2)
+      return false;
+    s->acc_noise = a / 1000;
+    s->gyro_noise = b;
+    return true;
+  }
+  if (!strcmp(op, "bias"))
+    return sscanf(line, "%*s %lf %lf %lf", &s->bias[0], &s->bias[1],
+                  &s->bias[2]) == 3;
+  if (sscanf(line, "%*s %lf", &ms) != 1 || ms < 0)
+    return false;
+
+  uint32_t n = (uint32_t)(ms * s->t->odr_hz / 1000);
+  double from[4], q[4];
+  memcpy(from, s->q, sizeof(from));
+
+  if (!strcmp(op, "hold")) {
+    for (uint32_t k = 0; k < n; k++) {
+      if (!emit(s, s->q, zero))
+        return false;
+    }
+  } else if (!strcmp(op, "turn")) {
+    double to[4];
+    if (sscanf(line, "%*s %*f %lf %lf %lf", &a, &b, &c) < 2)
+      return false;
+    qeuler(a, b, c, to);
+    if (n == 0)
+      memcpy(s->q, to, sizeof(to)); // starting pose
+    for (uint32_t k = 0; k < n; k++) {
+      qslerp(from, to, (1 - cos(PI * (k + 1) / n)) / 2, q);
+      if (!emit(s, q, zero))
+        return false;
+    }
+  } else if (!strcmp(op, "spin")) {
+    double r[4];
+    if (sscanf(line, "%*s %*f %3s %lf", ax, &a) != 2 || axis_of(ax) < 0)
+      return false;
+    qaxis(axis_of(ax), a * DEG2RAD * dt, r);
+    for (uint32_t k = 0; k < n; k++) {
+      qmul(s->q, r, q);
+      qnorm(q);
+      if (!emit(s, q, zero))
+        return false;
+    }
+  } else if (!strcmp(op, "shake")) {
+    if (sscanf(line, "%*s %*f %3s %lf %lf", ax, &a, &b) != 3 ||
+        axis_of(ax) < 0 || axis_of(ax) > 1)
+      return false;
+    for (uint32_t k = 0; k < n; k++) {
+      double lin[3] = {0, 0, 0};
+      lin[axis_of(ax)] = a * sin(2 * PI * b * (k + 1) * dt);
+      if (!emit(s, s->q, lin))
+        return false;
+    }
+  } else if (!strcmp(op, "wobble")) {
+    double w[4];
+    if (sscanf(line, "%*s %*f %lf %lf", &a, &b) != 2)
+      return false;
+    for (uint32_t k = 0; k < n; k++) {
+      double ph = 2 * PI * b * (k + 1) * dt;
+      qeuler(a * sin(ph), a * sin(1.3 * ph + 1), 0, w);
+      qmul(from, w, q);
+      if (!emit(s, q, zero))
+        return false;
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int trace_synth(trace_t *t, FILE *script, int *line) {
+  synth_t s;
+  char buf[256];
+  bool started = false;
+
+  memset(t, 0, sizeof(*t));
+  memset(&s, 0, sizeof(s));
+  s.t = t;
+  s.q[0] = 1;
+  s.acc_noise = SYNTH_ACC_NOISE_MG / 1000;
+  s.gyro_noise = SYNTH_GYRO_NOISE_DPS;
+  t->odr_hz = SYNTH_ODR_HZ;
+  t->acc_lsb = SYNTH_ACC_LSB;
+  t->gyro_lsb = SYNTH_GYRO_LSB;
+
+  for (;;) {
+    long at = ftell(script);
+    if (!fgets(buf, sizeof(buf), script))
+      return started;
+    (*line)++;
+    if (buf[0] == '#')
+      continue;
+    char name[TRACE_NAME_LEN];
+    if (sscanf(buf, " trace %47s", name) == 1) {
+      if (started) {
+        // The next trace's; leave it for the next call
+        fseek(script, at, SEEK_SET);
+        (*line)--;
+        return 1;
+      }
+      snprintf(t->name, sizeof(t->name), "%s", name);
+      s.rng = seed_of(name);
+      started = true;
+      continue;
+    }
+    if (!started && buf[strspn(buf, " \t\r\n")]) {
+      fprintf(stderr, "line %d: expected 'trace NAME'\n", *line);
+      return -1;
+    }
+    if (started && !step(&s, buf)) {
+      fprintf(stderr, "line %d: bad step: %s", *line, buf);
+      trace_free(t);
+      return -1;
+    }
+  }
+}
+
+int trace_run_file(const char *path, const char *dump_dir, trace_fn fn,
+                   void *ctx) {
+  trace_t t;
+  char out[512];
+  size_t len = strlen(path);
+  int failed = 0, line = 0, rc;
+
+  if (len > 4 && !strcmp(path + len - 4, ".csv")) {
+    if (!trace_load_csv(&t, path))
+      return -1;
+    rc = 1;
+  } else {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+      perror(path);
+      return -1;
+    }
+    while ((rc = trace_synth(&t, f, &line)) > 0) {
+      failed += !fn(&t, ctx);
+      if (dump_dir) {
+        snprintf(out, sizeof(out), "%s/%s.csv", dump_dir, t.name);
+        trace_save_csv(&t, out);
+      }
+      trace_free(&t);
+    }
+    fclose(f);
+    return rc < 0 ? -1 : failed;
+  }
+
+  failed += !fn(&t, ctx);
+  if (dump_dir) {
+    snprintf(out, sizeof(out), "%s/%s.csv", dump_dir, t.name);
+    trace_save_csv(&t, out);
+  }
+  trace_free(&t);
+  return failed;
+}
@@ -0,0 +1,66 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// A QMI8658 FIFO stream as the firmware reads it: raw acc/gyro counts at the
+// FIFO rate, with the scale the IMU was configured for.
+//
+// Traces come from two places. CSV files hold a capture:
+//
+//   # odr_hz=1000 acc_lsb=4096 gyro_lsb=64
+//   # expect=shake flip          (optional gesture labels, in order)
+//   ax,ay,az,gx,gy,gz
+//   12,-40,4101,3,-1,0
+//   ...
+//
+// Scripts (traces.txt) describe a motion instead, which trace_synth() turns
+// into the samples a QMI8658 on the board would deliver, keeping the true
+// attitude alongside. A script is a list of traces:
+//
+//   trace NAME
+//   expect GESTURE...            labels, as in the CSV header
+//   noise ACC_MG GYRO_DPS        white noise, RMS (default 3 mg, 0.3 dps)
+//   bias X Y Z                   gyro bias, dps
+//   hold MS                      keep the pose
+//   turn MS ROLL PITCH [YAW]     ease to a pose, degrees
+//   spin MS x|y|z DPS            rotate about a sensor axis
+//   shake MS x|y AMP_G FREQ_HZ   linear acceleration along a sensor axis
+//   wobble MS DEG FREQ_HZ        hand tremor: small roll/pitch oscillation
+
+#define TRACE_NAME_LEN 48
+#define TRACE_EXPECT_LEN 128
+
+typedef struct {
+  char name[TRACE_NAME_LEN];
+  char expect[TRACE_EXPECT_LEN]; // space separated gesture labels
+  uint32_t odr_hz;
+  uint16_t acc_lsb;
+  uint16_t gyro_lsb;
+  uint32_t count;
+  uint32_t cap;
+  int16_t (*acc)[3];
+  int16_t (*gyro)[3];
+  float (*truth)[4]; // true attitude w, x, y, z per sample; NULL if captured
+} trace_t;
+
+bool trace_load_csv(trace_t *t, const char *path);
+bool trace_save_csv(const trace_t *t, const char *path);
+
+// Renders the next trace of a script at the firmware's FIFO configuration.
+// Returns 1 for a trace, 0 at the end of the script and -1 on an error,
+// which is printed with the line number.
+int trace_synth(trace_t *t, FILE *script, int *line);
+
+void trace_free(trace_t *t);
+
+// Calls fn on every trace of a script, or on a CSV capture (by extension),
+// writing each to dump_dir as CSV if given. Returns how many traces fn
+// failed, or -1 if the file couldn't be read.
+typedef bool (*trace_fn)(const trace_t *t, void *ctx);
+int trace_run_file(const char *path, const char *dump_dir, trace_fn fn,
+                   void *ctx);
+
+#endif
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Prerender the boot splash as an LCD_3IN49_IMAGE.
+
+Takes the 32-bit variant of waveshare_map from examples/src/ImageData.c,
+blends it onto the splash background, pads it to an even number of rows and
+prints it panel-ready: RLE tokens by default, or RAW RGB565 with --raw (see
+LCD_3IN49_IMAGE in lib/LCD/LCD_3IN49.h). The output replaces the splash
+block at the end of ImageData.c:
+
+    tools/splash/mksplash.py examples/src/ImageData.c > splash.txt
+"""
+import argparse
+import re
+import sys
+
+WIDTH = 172
+HEIGHT = 53
+BACKGROUND = (0xFF, 0xFF, 0xFF)  # keep in step with SPLASH_BG
+RLE_RUN = 0x80000000
+MIN_RUN = 3  # shorter repeats cost more as a run than inline
+# The source is a scan with a noisy near-white ground; pixels this close to
+# the background, per channel, are snapped to it so the ground compresses
+SNAP = 12
+
+
+def read_bgra(path):
+    src = open(path).read()
+    block = re.search(r"#if LV_COLOR_DEPTH == 32\n(.*?)#endif", src, re.S).group(1)
+    data = [int(v, 16) for v in re.findall(r"0x([0-9a-fA-F]{2})", block)]
+    if len(data) != WIDTH * HEIGHT * 4:
+        sys.exit("unexpected image size: %d bytes" % len(data))
+    return data
+
+
+def rgb565(r, g, b):
+    return (r * 31 + 127) // 255 << 11 | (g * 63 + 127) // 255 << 5 | (b * 31 + 127) // 255
+
+
+def render(data):
+    bg = rgb565(*BACKGROUND)
+    pixels = []
+    for i in range(WIDTH * HEIGHT):
+        b, g, r, a = data[i * 4:i * 4 + 4]
+        px = [(c * a + k * (255 - a) + 127) // 255 for c, k in zip((r, g, b), BACKGROUND)]
+        if all(abs(c - k) <= SNAP for c, k in zip(px, BACKGROUND)):
+            px = BACKGROUND
+        pixels.append(rgb565(*px))
+    height = HEIGHT + HEIGHT % 2
+    pixels += [bg] * (WIDTH * (height - HEIGHT))
+    return pixels, height
+
+
+def words(pixels):
+    # Two pixels per word, bytes in panel order, as a little-endian uint32_t
+    out = []
+    for i in range(0, len(pixels), 2):
+        a, b = pixels[i], pixels[i + 1]
+        out.append((a >> 8) | (a & 0xFF) << 8 | (b >> 8) << 16 | (b & 0xFF) << 24)
+    return out
+
+
+def rle(ws):
+    tokens = []
+    literal = []
+    i = 0
+    while i < len(ws):
+        n = 1
+        while i + n < len(ws) and ws[i + n] == ws[i] and n < RLE_RUN - 1:
+            n += 1
+        if n >= MIN_RUN:
+            if literal:
+                tokens += [len(literal)] + literal
+                literal = []
+            tokens += [RLE_RUN | n, ws[i]]
+        else:
+            literal += ws[i:i + n]
+        i += n
+    if literal:
+        tokens += [len(literal)] + literal
+    return tokens
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("image_data", nargs="?", default="examples/src/ImageData.c")
+    ap.add_argument("--raw", action="store_true", help="RAW pixels instead of RLE")
+    args = ap.parse_args()
+
+    pixels, height = render(read_bgra(args.image_data))
+    ws = words(pixels)
+    data = ws if args.raw else rle(ws)
+    fmt = "LCD_3IN49_IMAGE_RAW" if args.raw else "LCD_3IN49_IMAGE_RLE"
+
+    print("/*Boot splash, generated by tools/splash/mksplash.py: %s, %d bytes"
+          % (fmt, len(data) * 4))
+    print("  for %d pixels, on SPLASH_BG*/" % (WIDTH * height))
+    print("static const uint32_t splash_data[%d] = {" % len(data))
+    for i in range(0, len(data), 8):
+        print("  " + ", ".join("0x%08x" % v for v in data[i:i + 8]) + ",")
+    print("};")
+    print()
+    print("const LCD_3IN49_IMAGE splash_img = {")
+    print("  .WIDTH = %d," % WIDTH)
+    print("  .HEIGHT = %d," % height)
+    print("  .FORMAT = %s," % fmt)
+    print("  .DATA = splash_data,")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
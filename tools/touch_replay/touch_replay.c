@@ -0,0 +1,379 @@
+// Touch filter (lib/Touch/touch_filter.c) on replayed touch traces. Each
+// trace is fed through touch_filter_update() the way touch_indev_read()
+// does, the filter reset on every new contact, and for every filter setting
+// the tool reports
+//   rms    distance between the output and the true position at the sample
+//          time, while the finger is down
+//   lag    the delay that best lines the output up with the true path;
+//          prediction pulls it towards zero, negative is overshoot
+//   still  rms distance once the finger has rested REST_MS: the jitter
+//          left over
+//
+// Built-in traces are synthesised at TOUCH_REPORT_US with NOISE_PX of
+// uniform noise on each axis and some report timing jitter. A capture is a
+// CSV of touch_sample_t rows, "t_us,x,y,fingers", one per controller
+// report; it has no truth, so the raw samples (linearly interpolated) stand
+// in for it and rms then includes their noise.
+//
+// The exit status is non-zero if, on the built-in traces, the default
+// filter leaves more than STILL_RATIO of the raw jitter on a resting finger,
+// is more than RMS_RATIO times as far off as the raw samples on a moving
+// one, or lags a drag by more than LAG_MAX_MS.
+//
+//   cmake -S tools/touch_replay -B build-touch && cmake --build build-touch
+//   ./build-touch/touch_replay [--dump DIR] [capture.csv]...
+
+#include "touch_filter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOUCH_REPORT_US 10000 // controller report interval while touched
+#define NOISE_PX 2
+#define LAG_MIN_MS (-40)
+#define LAG_MAX_SEARCH_MS 100
+#define REST_MS 500
+#define REST_PX 0.01f
+
+#define STILL_RATIO 0.5
+#define RMS_RATIO 1.5
+#define LAG_MAX_MS 16 // one 60 Hz frame
+
+#define MAX_SAMPLES 8192
+#define MAX_MS 60000
+
+#define PI 3.14159265358979323846
+
+typedef struct {
+  uint32_t t_us;
+  uint16_t x, y;
+  uint8_t fingers;
+} sample_t;
+
+typedef struct {
+  char name[64];
+  bool synthetic;
+  uint32_t count;
+  sample_t s[MAX_SAMPLES];
+  // True position on a 1 ms grid from s[0].t_us
+  uint32_t ms;
+  float ref[MAX_MS + 1][2];
+} trace_t;
+
+typedef struct {
+  const char *name;
+  touch_filter_mode_t mode;
+  uint32_t predict_us; // ~0u: the default's
+} setting_t;
+
+static const setting_t m_settings[] = {
+    {"raw", TOUCH_FILTER_NONE, 0},
+    {"1euro", TOUCH_FILTER_ONE_EURO, 0},
+    {"1euro+pred", TOUCH_FILTER_ONE_EURO, ~0u}, // the default
+    {"ab", TOUCH_FILTER_ALPHA_BETA, 0},
+    {"ab+pred", TOUCH_FILTER_ALPHA_BETA, ~0u},
+};
+#define SETTINGS (sizeof(m_settings) / sizeof(m_settings[0]))
+#define DEFAULT_SETTING 2
+
+static trace_t m_trace;
+static uint16_t m_out[MAX_SAMPLES][2];
+static uint32_t m_rng;
+
+// Path of a built-in trace at t seconds; false once the finger is lifted
+typedef bool (*path_fn)(double t, double *x, double *y);
+
+static bool path_hold(double t, double *x, double *y) {
+  *x = 86;
+  *y = 320;
+  return t < 2.0;
+}
+
+static bool path_drag_slow(double t, double *x, double *y) {
+  *x = 86;
+  *y = 200 + 100 * t;
+  return t < 2.5;
+}
+
+static bool path_fling(double t, double *x, double *y) {
+  *x = 90 + 50 * t;
+  *y = 550 - 1000 * t;
+  return t < 0.4;
+}
+
+static bool path_circle(double t, double *x, double *y) {
+  *x = 86 + 60 * cos(2 * PI * t);
+  *y = 320 + 60 * sin(2 * PI * t);
+  return t < 2.0;
+}
+
+// Rest, an eased 300 px move over 0.5 s, rest again: the hard case for
+// prediction, which overshoots the stop
+static bool path_press_drag(double t, double *x, double *y) {
+  double u = (t - 0.3) / 0.5;
+  u = u < 0 ? 0 : (u > 1 ? 1 : u);
+  *x = 60;
+  *y = 150 + 300 * (u * u * (3 - 2 * u));
+  return t < 2.0;
+}
+
+static const struct {
+  const char *name;
+  path_fn path;
+  bool drag; // held to LAG_MAX_MS
+} m_paths[] = {
+    {"hold", path_hold, false},
+    {"drag_slow", path_drag_slow, true},
+    {"fling", path_fling, true},
+    {"circle", path_circle, true},
+    {"press_drag", path_press_drag, false},
+};
+#define PATHS (sizeof(m_paths) / sizeof(m_paths[0]))
+
+static int32_t rng(int32_t lo, int32_t hi) {
+  m_rng = m_rng * 1664525u + 1013904223u;
+  return lo + (int32_t)((m_rng >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+static uint16_t clamp_px(double v) {
+  return v < 0 ? 0 : (v > 0xffff ? 0xffff : (uint16_t)lround(v));
+}
+
+static void synth(trace_t *tr, const char *name, path_fn path) {
+  double x, y;
+
+  memset(tr, 0, sizeof(*tr));
+  snprintf(tr->name, sizeof(tr->name), "%s", name);
+  tr->synthetic = true;
+  m_rng = 1;
+  for (const char *c = name; *c; c++)
+    m_rng = (m_rng ^ (uint8_t)*c) * 16777619u;
+
+  for (uint32_t ms = 0; ms <= MAX_MS && path(ms / 1000.0, &x, &y); ms++) {
+    tr->ref[ms][0] = (float)x;
+    tr->ref[ms][1] = (float)y;
+    tr->ms = ms;
+  }
+  uint32_t t_us = 0;
+  while (tr->count < MAX_SAMPLES - 1 && t_us <= tr->ms * 1000) {
+    path(t_us / 1e6, &x, &y);
+    tr->s[tr->count++] = (sample_t){
+        .t_us = t_us,
+        .x = clamp_px(x + rng(-NOISE_PX, NOISE_PX)),
+        .y = clamp_px(y + rng(-NOISE_PX, NOISE_PX)),
+        .fingers = 1,
+    };
+    t_us += (uint32_t)(TOUCH_REPORT_US + rng(-1000, 1000));
+  }
+  tr->s[tr->count++] = (sample_t){.t_us = t_us, .fingers = 0};
+}
+
+static bool load_csv(trace_t *tr, const char *path) {
+  FILE *fp = fopen(path, "r");
+  char line[128];
+
+  if (!fp) {
+    perror(path);
+    return false;
+  }
+  memset(tr, 0, sizeof(*tr));
+  const char *base = strrchr(path, '/');
+  snprintf(tr->name, sizeof(tr->name), "%s", base ? base + 1 : path);
+  while (fgets(line, sizeof(line), fp) && tr->count < MAX_SAMPLES) {
+    unsigned t, x, y, f;
+    if (line[0] == '#' || sscanf(line, "%u,%u,%u,%u", &t, &x, &y, &f) != 4)
+      continue;
+    tr->s[tr->count++] = (sample_t){t, (uint16_t)x, (uint16_t)y, (uint8_t)f};
+  }
+  fclose(fp);
+  if (tr->count < 2) {
+    fprintf(stderr, "%s: no samples\n", path);
+    return false;
+  }
+
+  // Interpolate the raw contact between reports; hold it across lifts
+  uint32_t t0 = tr->s[0].t_us, k = 0;
+  tr->ms = (tr->s[tr->count - 1].t_us - t0) / 1000;
+  if (tr->ms > MAX_MS)
+    tr->ms = MAX_MS;
+  for (uint32_t ms = 0; ms <= tr->ms; ms++) {
+    uint32_t t = t0 + ms * 1000;
+    while (k + 1 < tr->count && tr->s[k + 1].t_us <= t)
+      k++;
+    const sample_t *a = &tr->s[k];
+    const sample_t *b = k + 1 < tr->count ? &tr->s[k + 1] : a;
+    double u = 0;
+    if (b->fingers && a->fingers && b->t_us > a->t_us)
+      u = (double)(t - a->t_us) / (b->t_us - a->t_us);
+    tr->ref[ms][0] = (float)(a->x + (b->x - a->x) * u);
+    tr->ref[ms][1] = (float)(a->y + (b->y - a->y) * u);
+  }
+  return true;
+}
+
+static bool save_csv(const trace_t *tr, const char *dir) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.csv", dir, tr->name);
+  FILE *fp = fopen(path, "w");
+  if (!fp) {
+    perror(path);
+    return false;
+  }
+  fprintf(fp, "# t_us,x,y,fingers\n");
+  for (uint32_t i = 0; i < tr->count; i++)
+    fprintf(fp, "%u,%u,%u,%u\n", tr->s[i].t_us, tr->s[i].x, tr->s[i].y,
+            tr->s[i].fingers);
+  fclose(fp);
+  return true;
+}
+
+static const float *ref_at(const trace_t *tr, int64_t t_us) {
+  int64_t ms = (t_us - tr->s[0].t_us + 500) / 1000;
+  return tr->ref[ms < 0 ? 0 : (ms > tr->ms ? tr->ms : ms)];
+}
+
+static double dist2(const uint16_t out[2], const float ref[2]) {
+  double dx = out[0] - ref[0], dy = out[1] - ref[1];
+  return dx * dx + dy * dy;
+}
+
+// True position unchanged for REST_MS, so a stop's settling is not counted
+static bool resting(const trace_t *tr, uint32_t t_us) {
+  const float *a = ref_at(tr, t_us);
+  if (t_us - tr->s[0].t_us < REST_MS * 1000)
+    return false;
+  for (int ms = 10; ms <= REST_MS; ms += 10) {
+    const float *b = ref_at(tr, (int64_t)t_us - ms * 1000);
+    if (fabsf(a[0] - b[0]) > REST_PX || fabsf(a[1] - b[1]) > REST_PX)
+      return false;
+  }
+  return true;
+}
+
+typedef struct {
+  double rms, still;
+  int lag_ms;
+  bool has_still, has_lag;
+} result_t;
+
+static void replay(const trace_t *tr, const setting_t *set, result_t *r) {
+  touch_filter_config_t cfg;
+  touch_filter_t f;
+  bool down = false;
+
+  touch_filter_default_config(&cfg);
+  cfg.mode = set->mode;
+  if (set->predict_us != ~0u)
+    cfg.predict_us = set->predict_us;
+  touch_filter_init(&f, &cfg);
+
+  for (uint32_t i = 0; i < tr->count; i++) {
+    const sample_t *s = &tr->s[i];
+    if (s->fingers && !down)
+      touch_filter_reset(&f);
+    down = s->fingers;
+    if (down)
+      touch_filter_update(&f, s->x, s->y, s->t_us, &m_out[i][0],
+                          &m_out[i][1]);
+  }
+
+  double sum = 0, still = 0, best = INFINITY;
+  uint32_t n = 0, n_still = 0;
+  for (uint32_t i = 0; i < tr->count; i++) {
+    if (!tr->s[i].fingers)
+      continue;
+    double d = dist2(m_out[i], ref_at(tr, tr->s[i].t_us));
+    sum += d;
+    n++;
+    if (tr->synthetic && resting(tr, tr->s[i].t_us)) {
+      still += d;
+      n_still++;
+    }
+  }
+  r->rms = n ? sqrt(sum / n) : 0;
+  r->has_still = n_still > 0;
+  r->still = n_still ? sqrt(still / n_still) : 0;
+
+  // Only the moving part of the trace says anything about lag
+  r->has_lag = n_still < n / 2;
+  for (int lag = LAG_MIN_MS; r->has_lag && lag <= LAG_MAX_SEARCH_MS; lag++) {
+    double e = 0;
+    for (uint32_t i = 0; i < tr->count; i++) {
+      if (tr->s[i].fingers)
+        e += dist2(m_out[i], ref_at(tr, (int64_t)tr->s[i].t_us - lag * 1000));
+    }
+    if (e < best) {
+      best = e;
+      r->lag_ms = lag;
+    }
+  }
+}
+
+// Prints the trace's table; returns the number of failed checks
+static int run(const trace_t *tr, bool drag) {
+  result_t res[SETTINGS];
+  int failed = 0;
+
+  for (size_t k = 0; k < SETTINGS; k++) {
+    result_t *r = &res[k];
+    replay(tr, &m_settings[k], r);
+    printf("%-14s %-11s %7.2f", k ? "" : tr->name, m_settings[k].name,
+           r->rms);
+    if (r->has_lag)
+      printf(" %7d", r->lag_ms);
+    else
+      printf(" %7s", "-");
+    if (r->has_still)
+      printf(" %7.2f\n", r->still);
+    else
+      printf(" %7s\n", "-");
+  }
+
+  if (!tr->synthetic)
+    return 0;
+  const result_t *def = &res[DEFAULT_SETTING];
+  if (def->has_still && def->still > res[0].still * STILL_RATIO) {
+    printf("  FAIL %s: resting jitter %.2f px, raw %.2f\n", tr->name,
+           def->still, res[0].still);
+    failed++;
+  }
+  if (def->has_lag && def->rms > res[0].rms * RMS_RATIO) {
+    printf("  FAIL %s: rms %.2f px, raw %.2f\n", tr->name, def->rms,
+           res[0].rms);
+    failed++;
+  }
+  if (drag && def->has_lag && abs(def->lag_ms) > LAG_MAX_MS) {
+    printf("  FAIL %s: lag %d ms, limit %d\n", tr->name, def->lag_ms,
+           LAG_MAX_MS);
+    failed++;
+  }
+  return failed;
+}
+
+int main(int argc, char **argv) {
+  const char *dump = NULL;
+  int failed = 0, files = 0;
+
+  printf("%-14s %-11s %7s %7s %7s\n", "trace", "filter", "rms px", "lag ms",
+         "still");
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--dump") && i + 1 < argc) {
+      dump = argv[++i];
+      continue;
+    }
+    if (!load_csv(&m_trace, argv[i]))
+      return 2;
+    failed += run(&m_trace, false);
+    files++;
+  }
+  for (size_t i = 0; !files && i < PATHS; i++) {
+    synth(&m_trace, m_paths[i].name, m_paths[i].path);
+    if (dump && !save_csv(&m_trace, dump))
+      return 2;
+    failed += run(&m_trace, m_paths[i].drag);
+  }
+
+  printf(failed ? "%d checks failed\n" : "passed\n", failed);
+  return failed != 0;
+}